@@ -0,0 +1,401 @@
+#include "OmniCaptureAmbisonics.h"
+
+#include "OmniCaptureAudioConverter.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/VectorRegister.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureAmbisonics, Log, All);
+
+namespace
+{
+    constexpr int32 MaxAmbisonicChannels = 16;
+
+    struct FSpeakerDirection
+    {
+        float AzimuthDegrees = 0.0f;
+        float ElevationDegrees = 0.0f;
+        bool bLowFrequency = false;
+    };
+
+    // Channel order follows the audio mixer: FL, FR, FC, LFE, SL, SR, BL, BR. Azimuth is counter-clockwise (left positive).
+    FSpeakerDirection GetSpeakerDirection(int32 NumChannels, int32 Channel)
+    {
+        static const FSpeakerDirection Mono[] = { { 0.0f, 0.0f } };
+        static const FSpeakerDirection Stereo[] = { { 30.0f, 0.0f }, { -30.0f, 0.0f } };
+        static const FSpeakerDirection Quad[] = { { 45.0f, 0.0f }, { -45.0f, 0.0f }, { 135.0f, 0.0f }, { -135.0f, 0.0f } };
+        static const FSpeakerDirection Surround51[] = { { 30.0f, 0.0f }, { -30.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, true }, { 110.0f, 0.0f }, { -110.0f, 0.0f } };
+        static const FSpeakerDirection Surround71[] = { { 30.0f, 0.0f }, { -30.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, true }, { 90.0f, 0.0f }, { -90.0f, 0.0f }, { 150.0f, 0.0f }, { -150.0f, 0.0f } };
+
+        switch (NumChannels)
+        {
+        case 1:
+            return Mono[Channel];
+        case 2:
+            return Stereo[Channel];
+        case 4:
+            return Quad[Channel];
+        case 6:
+            return Surround51[Channel];
+        case 8:
+            return Surround71[Channel];
+        default:
+            return { 360.0f * Channel / FMath::Max(NumChannels, 1), 0.0f };
+        }
+    }
+
+    // Real spherical harmonics in ACN order with SN3D normalisation, up to third order.
+    void EvaluateSN3D(float AzimuthRadians, float ElevationRadians, float* Out)
+    {
+        const float SinA = FMath::Sin(AzimuthRadians);
+        const float CosA = FMath::Cos(AzimuthRadians);
+        const float Sin2A = FMath::Sin(2.0f * AzimuthRadians);
+        const float Cos2A = FMath::Cos(2.0f * AzimuthRadians);
+        const float Sin3A = FMath::Sin(3.0f * AzimuthRadians);
+        const float Cos3A = FMath::Cos(3.0f * AzimuthRadians);
+        const float SinE = FMath::Sin(ElevationRadians);
+        const float CosE = FMath::Cos(ElevationRadians);
+        const float CosE2 = CosE * CosE;
+        const float SinE2 = SinE * SinE;
+
+        const float Sqrt3Over2 = FMath::Sqrt(3.0f) * 0.5f;
+        const float Sqrt5Over8 = FMath::Sqrt(5.0f / 8.0f);
+        const float Sqrt15Over2 = FMath::Sqrt(15.0f) * 0.5f;
+        const float Sqrt3Over8 = FMath::Sqrt(3.0f / 8.0f);
+
+        Out[0] = 1.0f;
+        Out[1] = SinA * CosE;
+        Out[2] = SinE;
+        Out[3] = CosA * CosE;
+        Out[4] = Sqrt3Over2 * Sin2A * CosE2;
+        Out[5] = Sqrt3Over2 * SinA * 2.0f * SinE * CosE;
+        Out[6] = 0.5f * (3.0f * SinE2 - 1.0f);
+        Out[7] = Sqrt3Over2 * CosA * 2.0f * SinE * CosE;
+        Out[8] = Sqrt3Over2 * Cos2A * CosE2;
+        Out[9] = Sqrt5Over8 * Sin3A * CosE2 * CosE;
+        Out[10] = Sqrt15Over2 * Sin2A * SinE * CosE2;
+        Out[11] = Sqrt3Over8 * SinA * CosE * (5.0f * SinE2 - 1.0f);
+        Out[12] = 0.5f * SinE * (5.0f * SinE2 - 3.0f);
+        Out[13] = Sqrt3Over8 * CosA * CosE * (5.0f * SinE2 - 1.0f);
+        Out[14] = Sqrt15Over2 * Cos2A * SinE * CosE2;
+        Out[15] = Sqrt5Over8 * Cos3A * CosE2 * CosE;
+    }
+
+    uint32 ReadUInt32(const uint8* Data)
+    {
+        return (static_cast<uint32>(Data[0]) << 24) | (static_cast<uint32>(Data[1]) << 16) | (static_cast<uint32>(Data[2]) << 8) | static_cast<uint32>(Data[3]);
+    }
+
+    void WriteUInt32(uint8* Data, uint32 Value)
+    {
+        Data[0] = static_cast<uint8>(Value >> 24);
+        Data[1] = static_cast<uint8>(Value >> 16);
+        Data[2] = static_cast<uint8>(Value >> 8);
+        Data[3] = static_cast<uint8>(Value);
+    }
+
+    bool IsBoxType(const uint8* Data, const char* Type)
+    {
+        return FMemory::Memcmp(Data + 4, Type, 4) == 0;
+    }
+
+    int64 FindChildBox(const TArray<uint8>& Data, int64 Start, int64 End, const char* Type)
+    {
+        int64 Offset = Start;
+        while (Offset + 8 <= End)
+        {
+            const uint32 Size = ReadUInt32(Data.GetData() + Offset);
+            if (Size < 8 || Offset + Size > End)
+            {
+                return INDEX_NONE;
+            }
+            if (IsBoxType(Data.GetData() + Offset, Type))
+            {
+                return Offset;
+            }
+            Offset += Size;
+        }
+        return INDEX_NONE;
+    }
+}
+
+int32 FOmniCaptureAmbisonicEncoder::GetChannelCount(EOmniCaptureAmbisonicOrder InOrder)
+{
+    const int32 OrderIndex = GetOrderIndex(InOrder);
+    return OrderIndex > 0 ? (OrderIndex + 1) * (OrderIndex + 1) : 0;
+}
+
+int32 FOmniCaptureAmbisonicEncoder::GetOrderIndex(EOmniCaptureAmbisonicOrder InOrder)
+{
+    switch (InOrder)
+    {
+    case EOmniCaptureAmbisonicOrder::FirstOrder:
+        return 1;
+    case EOmniCaptureAmbisonicOrder::ThirdOrder:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+void FOmniCaptureAmbisonicEncoder::Configure(EOmniCaptureAmbisonicOrder InOrder, int32 ExpectedChannels)
+{
+    Order = InOrder;
+    OutputChannels = GetChannelCount(InOrder);
+    MatrixChannels = 0;
+    Matrix.Reset(FOmniCaptureAudioConverter::MaxChannels * OutputChannels);
+    Output.SetNumZeroed(MaxBlockFrames * FMath::Max(OutputChannels, 1));
+
+    if (IsEnabled() && ExpectedChannels > 0 && ExpectedChannels <= FOmniCaptureAudioConverter::MaxChannels)
+    {
+        BuildMatrix(ExpectedChannels);
+    }
+}
+
+void FOmniCaptureAmbisonicEncoder::BuildMatrix(int32 NumChannels)
+{
+    // Row per input channel, one coefficient per output channel, so each row loads as whole vectors.
+    // Capacity was reserved in Configure; rows from a previous layout are cleared with the rest.
+    Matrix.SetNumUninitialized(NumChannels * OutputChannels, EAllowShrinking::No);
+    FMemory::Memzero(Matrix.GetData(), Matrix.Num() * sizeof(float));
+    float Coefficients[MaxAmbisonicChannels];
+    for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        const FSpeakerDirection Speaker = GetSpeakerDirection(NumChannels, Channel);
+        if (Speaker.bLowFrequency)
+        {
+            continue;
+        }
+
+        EvaluateSN3D(FMath::DegreesToRadians(Speaker.AzimuthDegrees), FMath::DegreesToRadians(Speaker.ElevationDegrees), Coefficients);
+        FMemory::Memcpy(Matrix.GetData() + Channel * OutputChannels, Coefficients, OutputChannels * sizeof(float));
+    }
+
+    MatrixChannels = NumChannels;
+}
+
+const float* FOmniCaptureAmbisonicEncoder::Process(const float* InData, int32 NumFrames, int32 NumChannels)
+{
+    if (!IsEnabled() || !InData || NumFrames <= 0 || NumChannels <= 0)
+    {
+        return InData;
+    }
+
+    if (NumChannels > FOmniCaptureAudioConverter::MaxChannels)
+    {
+        return nullptr;
+    }
+
+    if (NumChannels != MatrixChannels)
+    {
+        BuildMatrix(NumChannels);
+    }
+
+    NumFrames = FMath::Min(NumFrames, MaxBlockFrames);
+
+    const float* MatrixData = Matrix.GetData();
+    float* OutData = Output.GetData();
+    const int32 NumGroups = OutputChannels / 4;
+
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const float* InFrame = InData + Frame * NumChannels;
+        float* OutFrame = OutData + Frame * OutputChannels;
+
+        VectorRegister4Float Accumulators[MaxAmbisonicChannels / 4];
+        for (int32 Group = 0; Group < NumGroups; ++Group)
+        {
+            Accumulators[Group] = VectorZeroFloat();
+        }
+
+        for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            const VectorRegister4Float Sample = VectorLoadFloat1(InFrame + Channel);
+            const float* Row = MatrixData + Channel * OutputChannels;
+            for (int32 Group = 0; Group < NumGroups; ++Group)
+            {
+                Accumulators[Group] = VectorMultiplyAdd(Sample, VectorLoad(Row + Group * 4), Accumulators[Group]);
+            }
+        }
+
+        for (int32 Group = 0; Group < NumGroups; ++Group)
+        {
+            VectorStore(Accumulators[Group], OutFrame + Group * 4);
+        }
+    }
+
+    return OutData;
+}
+
+bool FOmniCaptureSpatialAudioMetadata::InjectAmbisonicBox(const FString& FilePath, EOmniCaptureAmbisonicOrder InOrder)
+{
+    const int32 OrderIndex = FOmniCaptureAmbisonicEncoder::GetOrderIndex(InOrder);
+    const int32 NumChannels = FOmniCaptureAmbisonicEncoder::GetChannelCount(InOrder);
+    if (OrderIndex == 0)
+    {
+        return false;
+    }
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const int64 FileSize = PlatformFile.FileSize(*FilePath);
+    if (FileSize <= 0)
+    {
+        return false;
+    }
+
+    // Locate moov among the top-level boxes; growing it in place is only safe when nothing follows it.
+    int64 MoovOffset = INDEX_NONE;
+    int64 MoovSize = 0;
+    {
+        TUniquePtr<IFileHandle> Reader(PlatformFile.OpenRead(*FilePath));
+        if (!Reader)
+        {
+            return false;
+        }
+
+        int64 Offset = 0;
+        uint8 Header[16];
+        while (Offset + 8 <= FileSize)
+        {
+            Reader->Seek(Offset);
+            if (!Reader->Read(Header, 8))
+            {
+                return false;
+            }
+
+            int64 BoxSize = ReadUInt32(Header);
+            if (BoxSize == 1)
+            {
+                if (!Reader->Read(Header + 8, 8))
+                {
+                    return false;
+                }
+                BoxSize = (static_cast<int64>(ReadUInt32(Header + 8)) << 32) | ReadUInt32(Header + 12);
+            }
+            else if (BoxSize == 0)
+            {
+                BoxSize = FileSize - Offset;
+            }
+
+            if (BoxSize < 8)
+            {
+                return false;
+            }
+
+            if (IsBoxType(Header, "moov"))
+            {
+                MoovOffset = Offset;
+                MoovSize = BoxSize;
+            }
+            Offset += BoxSize;
+        }
+    }
+
+    if (MoovOffset == INDEX_NONE || MoovOffset + MoovSize != FileSize)
+    {
+        UE_LOG(LogOmniCaptureAmbisonics, Warning, TEXT("Cannot add spatial audio metadata to %s: moov is not the last box (disable fast start)."), *FilePath);
+        return false;
+    }
+
+    if (MoovSize > MAX_int32)
+    {
+        return false;
+    }
+
+    TArray<uint8> Moov;
+    Moov.SetNumUninitialized(static_cast<int32>(MoovSize));
+    {
+        TUniquePtr<IFileHandle> Reader(PlatformFile.OpenRead(*FilePath));
+        if (!Reader || !Reader->Seek(MoovOffset) || !Reader->Read(Moov.GetData(), MoovSize))
+        {
+            return false;
+        }
+    }
+
+    if (ReadUInt32(Moov.GetData()) != static_cast<uint32>(MoovSize))
+    {
+        return false;
+    }
+
+    TArray<int64, TInlineAllocator<8>> Parents;
+    int64 InsertOffset = INDEX_NONE;
+
+    int64 TrakOffset = 8;
+    while (InsertOffset == INDEX_NONE)
+    {
+        TrakOffset = FindChildBox(Moov, TrakOffset, MoovSize, "trak");
+        if (TrakOffset == INDEX_NONE)
+        {
+            break;
+        }
+        const int64 TrakEnd = TrakOffset + ReadUInt32(Moov.GetData() + TrakOffset);
+
+        const int64 Mdia = FindChildBox(Moov, TrakOffset + 8, TrakEnd, "mdia");
+        const int64 MdiaEnd = Mdia != INDEX_NONE ? Mdia + ReadUInt32(Moov.GetData() + Mdia) : INDEX_NONE;
+        const int64 Hdlr = Mdia != INDEX_NONE ? FindChildBox(Moov, Mdia + 8, MdiaEnd, "hdlr") : INDEX_NONE;
+        const int64 Minf = Mdia != INDEX_NONE ? FindChildBox(Moov, Mdia + 8, MdiaEnd, "minf") : INDEX_NONE;
+
+        // hdlr: header(8) + version/flags(4) + pre_defined(4) + handler_type(4)
+        if (Hdlr != INDEX_NONE && Minf != INDEX_NONE && FMemory::Memcmp(Moov.GetData() + Hdlr + 16, "soun", 4) == 0)
+        {
+            const int64 MinfEnd = Minf + ReadUInt32(Moov.GetData() + Minf);
+            const int64 Stbl = FindChildBox(Moov, Minf + 8, MinfEnd, "stbl");
+            const int64 StblEnd = Stbl != INDEX_NONE ? Stbl + ReadUInt32(Moov.GetData() + Stbl) : INDEX_NONE;
+            const int64 Stsd = Stbl != INDEX_NONE ? FindChildBox(Moov, Stbl + 8, StblEnd, "stsd") : INDEX_NONE;
+            if (Stsd != INDEX_NONE)
+            {
+                // stsd: header(8) + version/flags(4) + entry_count(4), then the first sample entry.
+                const int64 Entry = Stsd + 16;
+                const int64 EntryEnd = Entry + ReadUInt32(Moov.GetData() + Entry);
+                if (FindChildBox(Moov, Entry + 36, EntryEnd, "SA3D") != INDEX_NONE)
+                {
+                    return true;
+                }
+
+                Parents = { 0, TrakOffset, Mdia, Minf, Stbl, Stsd, Entry };
+                InsertOffset = EntryEnd;
+            }
+        }
+
+        TrakOffset = TrakEnd;
+    }
+
+    if (InsertOffset == INDEX_NONE)
+    {
+        UE_LOG(LogOmniCaptureAmbisonics, Warning, TEXT("No audio track found in %s; spatial audio metadata was not written."), *FilePath);
+        return false;
+    }
+
+    TArray<uint8> Box;
+    const uint32 BoxSize = 20 + 4 * NumChannels;
+    Box.SetNumZeroed(BoxSize);
+    WriteUInt32(Box.GetData(), BoxSize);
+    FMemory::Memcpy(Box.GetData() + 4, "SA3D", 4);
+    Box[8] = 0; // version
+    Box[9] = 0; // ambisonic_type: periphonic
+    WriteUInt32(Box.GetData() + 10, static_cast<uint32>(OrderIndex));
+    Box[14] = 0; // channel ordering: ACN
+    Box[15] = 0; // normalization: SN3D
+    WriteUInt32(Box.GetData() + 16, static_cast<uint32>(NumChannels));
+    for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        WriteUInt32(Box.GetData() + 20 + Channel * 4, static_cast<uint32>(Channel));
+    }
+
+    for (const int64 Parent : Parents)
+    {
+        WriteUInt32(Moov.GetData() + Parent, ReadUInt32(Moov.GetData() + Parent) + BoxSize);
+    }
+    Moov.Insert(Box, static_cast<int32>(InsertOffset));
+
+    TUniquePtr<IFileHandle> Writer(PlatformFile.OpenWrite(*FilePath, true, true));
+    if (!Writer || !Writer->Seek(MoovOffset) || !Writer->Write(Moov.GetData(), Moov.Num()))
+    {
+        UE_LOG(LogOmniCaptureAmbisonics, Warning, TEXT("Failed to write spatial audio metadata to %s"), *FilePath);
+        return false;
+    }
+
+    UE_LOG(LogOmniCaptureAmbisonics, Log, TEXT("Tagged %s as order-%d AmbiX spatial audio."), *FilePath, OrderIndex);
+    return true;
+}
@@ -0,0 +1,283 @@
+#include "OmniCaptureAudioConverter.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    float GetScale(EOmniCaptureAudioFormat Format)
+    {
+        switch (Format)
+        {
+        case EOmniCaptureAudioFormat::PCM24:
+            return 8388607.0f;
+        case EOmniCaptureAudioFormat::Float32:
+            return 1.0f;
+        default:
+            return 32767.0f;
+        }
+    }
+
+    float GetMinValue(EOmniCaptureAudioFormat Format)
+    {
+        return Format == EOmniCaptureAudioFormat::PCM24 ? -8388608.0f : -32768.0f;
+    }
+
+    float GetMaxValue(EOmniCaptureAudioFormat Format)
+    {
+        return Format == EOmniCaptureAudioFormat::PCM24 ? 8388607.0f : 32767.0f;
+    }
+
+    FORCEINLINE void WriteInteger(EOmniCaptureAudioFormat Format, int32 Value, uint8* Dest)
+    {
+        if (Format == EOmniCaptureAudioFormat::PCM24)
+        {
+            Dest[0] = static_cast<uint8>(Value & 0xFF);
+            Dest[1] = static_cast<uint8>((Value >> 8) & 0xFF);
+            Dest[2] = static_cast<uint8>((Value >> 16) & 0xFF);
+        }
+        else
+        {
+            const int16 Sample = static_cast<int16>(Value);
+            FMemory::Memcpy(Dest, &Sample, sizeof(int16));
+        }
+    }
+}
+
+int32 FOmniCaptureAudioConverter::GetBytesPerSample(EOmniCaptureAudioFormat InFormat)
+{
+    switch (InFormat)
+    {
+    case EOmniCaptureAudioFormat::PCM24:
+        return 3;
+    case EOmniCaptureAudioFormat::Float32:
+        return 4;
+    default:
+        return 2;
+    }
+}
+
+void FOmniCaptureAudioConverter::Configure(EOmniCaptureAudioFormat InFormat, float InGain, const TArray<float>& InChannelGains, bool bInDither)
+{
+    Format = InFormat;
+    Gain = InGain;
+    ChannelGains = InChannelGains;
+    bDither = bInDither && InFormat != EOmniCaptureAudioFormat::Float32;
+    DitherState = 0x9E3779B9u;
+    GainTableChannels = 0;
+
+    GainTable.Reset(MaxChannels * 4 + 4);
+    PrepareGainTable(8);
+}
+
+void FOmniCaptureAudioConverter::PrepareGainTable(int32 NumChannels)
+{
+    if (NumChannels == GainTableChannels)
+    {
+        return;
+    }
+
+    // Sized so every 4-wide load starting inside one period stays in bounds. Configure reserved
+    // room for MaxChannels, so this never allocates on the audio thread.
+    const int32 Period = NumChannels * 4;
+    GainTable.SetNumUninitialized(Period + 4, EAllowShrinking::No);
+    for (int32 Index = 0; Index < GainTable.Num(); ++Index)
+    {
+        const int32 Channel = Index % NumChannels;
+        const float ChannelGain = ChannelGains.IsValidIndex(Channel) ? ChannelGains[Channel] : 1.0f;
+        GainTable[Index] = ChannelGains.Num() > 0 ? Gain * ChannelGain : Gain;
+    }
+
+    GainTableChannels = NumChannels;
+}
+
+float FOmniCaptureAudioConverter::NextDither()
+{
+    DitherState ^= DitherState << 13;
+    DitherState ^= DitherState >> 17;
+    DitherState ^= DitherState << 5;
+    const float A = static_cast<float>(DitherState >> 8) * (1.0f / 16777216.0f);
+
+    DitherState ^= DitherState << 13;
+    DitherState ^= DitherState >> 17;
+    DitherState ^= DitherState << 5;
+    const float B = static_cast<float>(DitherState >> 8) * (1.0f / 16777216.0f);
+
+    return A - B;
+}
+
+void FOmniCaptureAudioConverter::Convert(const float* Source, int32 NumSamples, int32 NumChannels, int32 FirstChannel, uint8* Dest)
+{
+    if (!Source || !Dest || NumSamples <= 0 || NumChannels <= 0)
+    {
+        return;
+    }
+
+    if (NumChannels > MaxChannels)
+    {
+        FMemory::Memzero(Dest, static_cast<SIZE_T>(NumSamples) * GetBytesPerSample());
+        return;
+    }
+
+    PrepareGainTable(NumChannels);
+
+    const int32 Period = NumChannels * 4;
+    const int32 BytesPerSample = GetBytesPerSample();
+    int32 TableOffset = FirstChannel % NumChannels;
+    int32 Index = 0;
+
+    if (Format == EOmniCaptureAudioFormat::Float32)
+    {
+        for (; Index + 4 <= NumSamples; Index += 4)
+        {
+            const VectorRegister4Float Value = VectorMultiply(VectorLoad(Source + Index), VectorLoad(GainTable.GetData() + TableOffset));
+            VectorStore(Value, reinterpret_cast<float*>(Dest + Index * BytesPerSample));
+            TableOffset = (TableOffset + 4) % Period;
+        }
+    }
+    else
+    {
+        const VectorRegister4Float ScaleVec = VectorSetFloat1(GetScale(Format));
+        const VectorRegister4Float MinVec = VectorSetFloat1(GetMinValue(Format));
+        const VectorRegister4Float MaxVec = VectorSetFloat1(GetMaxValue(Format));
+        const VectorRegister4Float HalfVec = VectorSetFloat1(0.5f);
+
+        alignas(16) float Noise[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        alignas(16) int32 Rounded[4];
+
+        for (; Index + 4 <= NumSamples; Index += 4)
+        {
+            VectorRegister4Float Value = VectorMultiply(VectorMultiply(VectorLoad(Source + Index), VectorLoad(GainTable.GetData() + TableOffset)), ScaleVec);
+            if (bDither)
+            {
+                Noise[0] = NextDither();
+                Noise[1] = NextDither();
+                Noise[2] = NextDither();
+                Noise[3] = NextDither();
+                Value = VectorAdd(Value, VectorLoadAligned(Noise));
+            }
+
+            // Clamp before rounding so floor(x + 0.5) cannot overflow; matches RoundToInt then Clamp.
+            Value = VectorMin(VectorMax(Value, MinVec), MaxVec);
+            VectorIntStoreAligned(VectorFloatToInt(VectorFloor(VectorAdd(Value, HalfVec))), Rounded);
+
+            uint8* Out = Dest + Index * BytesPerSample;
+            WriteInteger(Format, Rounded[0], Out);
+            WriteInteger(Format, Rounded[1], Out + BytesPerSample);
+            WriteInteger(Format, Rounded[2], Out + BytesPerSample * 2);
+            WriteInteger(Format, Rounded[3], Out + BytesPerSample * 3);
+
+            TableOffset = (TableOffset + 4) % Period;
+        }
+    }
+
+    if (Index < NumSamples)
+    {
+        ConvertScalar(Source + Index, NumSamples - Index, NumChannels, FirstChannel + Index, Dest + Index * BytesPerSample);
+    }
+}
+
+void FOmniCaptureAudioConverter::ConvertScalar(const float* Source, int32 NumSamples, int32 NumChannels, int32 FirstChannel, uint8* Dest)
+{
+    if (!Source || !Dest || NumSamples <= 0 || NumChannels <= 0)
+    {
+        return;
+    }
+
+    if (NumChannels > MaxChannels)
+    {
+        FMemory::Memzero(Dest, static_cast<SIZE_T>(NumSamples) * GetBytesPerSample());
+        return;
+    }
+
+    PrepareGainTable(NumChannels);
+
+    const int32 BytesPerSample = GetBytesPerSample();
+    const float Scale = GetScale(Format);
+    const int32 MinValue = static_cast<int32>(GetMinValue(Format));
+    const int32 MaxValue = static_cast<int32>(GetMaxValue(Format));
+
+    for (int32 Index = 0; Index < NumSamples; ++Index)
+    {
+        const float SampleGain = GainTable[(FirstChannel + Index) % NumChannels];
+        uint8* Out = Dest + Index * BytesPerSample;
+
+        if (Format == EOmniCaptureAudioFormat::Float32)
+        {
+            const float Value = Source[Index] * SampleGain;
+            FMemory::Memcpy(Out, &Value, sizeof(float));
+            continue;
+        }
+
+        float Value = Source[Index] * SampleGain * Scale;
+        if (bDither)
+        {
+            Value += NextDither();
+        }
+
+        const float Clamped = FMath::Clamp(Value, static_cast<float>(MinValue), static_cast<float>(MaxValue));
+        WriteInteger(Format, FMath::Clamp(FMath::RoundToInt(Clamped), MinValue, MaxValue), Out);
+    }
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioConversionTest, "OmniCapture.Audio.Conversion",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureAudioConversionTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumChannels = 8;
+    constexpr int32 NumSamples = 1024 * NumChannels;
+    constexpr int32 Iterations = 200;
+
+    TArray<float> Source;
+    Source.SetNumUninitialized(NumSamples);
+    FRandomStream Random(1337);
+    for (float& Sample : Source)
+    {
+        Sample = Random.FRandRange(-1.25f, 1.25f);
+    }
+
+    const EOmniCaptureAudioFormat Formats[] = { EOmniCaptureAudioFormat::PCM16, EOmniCaptureAudioFormat::PCM24, EOmniCaptureAudioFormat::Float32 };
+    for (EOmniCaptureAudioFormat TestFormat : Formats)
+    {
+        const TCHAR* FormatName = TestFormat == EOmniCaptureAudioFormat::PCM16 ? TEXT("PCM16") : (TestFormat == EOmniCaptureAudioFormat::PCM24 ? TEXT("PCM24") : TEXT("Float32"));
+
+        FOmniCaptureAudioConverter Converter;
+        Converter.Configure(TestFormat, 0.8f, { 1.0f, 1.0f, 0.7f, 0.5f, 1.0f, 1.0f, 0.9f, 0.9f }, false);
+
+        TArray<uint8> VectorOut;
+        TArray<uint8> ScalarOut;
+        VectorOut.SetNumZeroed(NumSamples * Converter.GetBytesPerSample());
+        ScalarOut.SetNumZeroed(NumSamples * Converter.GetBytesPerSample());
+
+        const double VectorStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Converter.Convert(Source.GetData(), NumSamples, NumChannels, 0, VectorOut.GetData());
+        }
+        const double VectorSeconds = FPlatformTime::Seconds() - VectorStart;
+
+        const double ScalarStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Converter.ConvertScalar(Source.GetData(), NumSamples, NumChannels, 0, ScalarOut.GetData());
+        }
+        const double ScalarSeconds = FPlatformTime::Seconds() - ScalarStart;
+
+        TestTrue(FString::Printf(TEXT("%s vector output matches scalar"), FormatName), FMemory::Memcmp(VectorOut.GetData(), ScalarOut.GetData(), VectorOut.Num()) == 0);
+        AddInfo(FString::Printf(TEXT("%s: vector %.3f ms, scalar %.3f ms (x%.2f)"),
+            FormatName,
+            VectorSeconds * 1000.0,
+            ScalarSeconds * 1000.0,
+            VectorSeconds > 0.0 ? ScalarSeconds / VectorSeconds : 0.0));
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
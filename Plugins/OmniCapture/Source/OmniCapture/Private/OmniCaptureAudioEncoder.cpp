@@ -0,0 +1,269 @@
+#include "OmniCaptureAudioEncoder.h"
+
+#include "OmniCaptureAudioConverter.h"
+#include "OmniCaptureAudioRing.h"
+#include "OmniCaptureMuxer.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureAudioEncoder, Log, All);
+
+namespace
+{
+    constexpr int32 EncodeChunkSamples = 64 * 1024;
+
+    const TCHAR* GetRawFormatName(EOmniCaptureAudioFormat Format)
+    {
+        switch (Format)
+        {
+        case EOmniCaptureAudioFormat::PCM24:
+            return TEXT("s24le");
+        case EOmniCaptureAudioFormat::Float32:
+            return TEXT("f32le");
+        default:
+            return TEXT("s16le");
+        }
+    }
+}
+
+class FOmniCaptureAudioEncodeWorker final : public FRunnable
+{
+public:
+    FOmniCaptureAudioEncodeWorker(FOmniCaptureAudioEncoder& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning.Load())
+        {
+            Owner.Drain();
+            WakeEvent->Wait(20);
+        }
+
+        Owner.Drain();
+        return 0;
+    }
+
+private:
+    FOmniCaptureAudioEncoder& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+
+FOmniCaptureAudioEncoder::FOmniCaptureAudioEncoder()
+{
+    bRunning = false;
+    bFailed = false;
+    StreamSampleRate = 0;
+    StreamChannels = 0;
+}
+
+FOmniCaptureAudioEncoder::~FOmniCaptureAudioEncoder()
+{
+    Close();
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+FString FOmniCaptureAudioEncoder::GetFileExtension(EOmniCaptureAudioCodec InCodec)
+{
+    switch (InCodec)
+    {
+    case EOmniCaptureAudioCodec::AAC:
+        return TEXT(".aac");
+    case EOmniCaptureAudioCodec::Opus:
+        return TEXT(".opus");
+    default:
+        return TEXT(".wav");
+    }
+}
+
+bool FOmniCaptureAudioEncoder::Open(const FOmniCaptureSettings& Settings, const FString& InBasePath, FOmniCaptureAudioRing& InRing, EOmniCaptureAudioFormat InFormat)
+{
+    if (Ring || Settings.AudioCodec == EOmniCaptureAudioCodec::WAV)
+    {
+        return false;
+    }
+
+    if (!FOmniCaptureMuxer::IsFFmpegAvailable(Settings, &Binary))
+    {
+        UE_LOG(LogOmniCaptureAudioEncoder, Warning, TEXT("Streaming audio encode requested but FFmpeg was not found."));
+        return false;
+    }
+
+    Ring = &InRing;
+    BasePath = InBasePath;
+    Codec = Settings.AudioCodec;
+    Format = InFormat;
+    BitrateKbps = FMath::Max(32, Settings.AudioBitrateKbps);
+    BytesPerSample = FOmniCaptureAudioConverter::GetBytesPerSample(InFormat);
+    FilePath = BasePath + GetFileExtension(Codec);
+    bDiscreteChannels = Settings.AmbisonicOrder != EOmniCaptureAmbisonicOrder::None;
+    bFailed = false;
+    StreamSampleRate = 0;
+    StreamChannels = 0;
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+
+    bRunning = true;
+    Worker = new FOmniCaptureAudioEncodeWorker(*this, WakeEvent, bRunning);
+    Thread = FRunnableThread::Create(Worker, TEXT("OmniCaptureAudioEncoder"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        bRunning = false;
+        delete Worker;
+        Worker = nullptr;
+    }
+
+    return true;
+}
+
+void FOmniCaptureAudioEncoder::SetStreamFormat(int32 SampleRate, int32 NumChannels)
+{
+    StreamSampleRate.Store(SampleRate);
+    StreamChannels.Store(NumChannels);
+}
+
+void FOmniCaptureAudioEncoder::Wake()
+{
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+bool FOmniCaptureAudioEncoder::LaunchEncoder(int32 SampleRate, int32 NumChannels)
+{
+    EOmniCaptureAudioCodec EffectiveCodec = Codec;
+    if (EffectiveCodec == EOmniCaptureAudioCodec::AAC && NumChannels > 8)
+    {
+        UE_LOG(LogOmniCaptureAudioEncoder, Warning, TEXT("AAC cannot carry %d channels; encoding Opus instead."), NumChannels);
+        EffectiveCodec = EOmniCaptureAudioCodec::Opus;
+        FilePath = BasePath + GetFileExtension(EffectiveCodec);
+    }
+
+    FString Arguments = FString::Printf(TEXT("-y -loglevel error -nostats -f %s -ar %d -ac %d -i pipe:0"),
+        GetRawFormatName(Format),
+        SampleRate,
+        NumChannels);
+
+    if (EffectiveCodec == EOmniCaptureAudioCodec::Opus)
+    {
+        // Opus only runs at 48 kHz; mapping family 255 keeps discrete channels such as AmbiX unmixed.
+        Arguments += FString::Printf(TEXT(" -c:a libopus -b:a %dk -ar 48000"), BitrateKbps);
+        if (NumChannels > 8 || bDiscreteChannels)
+        {
+            Arguments += TEXT(" -mapping_family 255");
+        }
+        Arguments += TEXT(" -f ogg");
+    }
+    else
+    {
+        Arguments += FString::Printf(TEXT(" -c:a aac -b:a %dk -f adts"), BitrateKbps);
+    }
+
+    Arguments += FString::Printf(TEXT(" \"%s\""), *FilePath);
+
+    if (!Pipe.Open(Binary, Arguments, FPaths::GetPath(FilePath)))
+    {
+        UE_LOG(LogOmniCaptureAudioEncoder, Warning, TEXT("Failed to launch FFmpeg audio encoder for %s"), *FilePath);
+        return false;
+    }
+
+    Codec = EffectiveCodec;
+    return true;
+}
+
+void FOmniCaptureAudioEncoder::Drain()
+{
+    FScopeLock Lock(&EncodeCS);
+    if (!Ring)
+    {
+        return;
+    }
+
+    if (!Pipe.IsOpen() && !bFailed.Load())
+    {
+        const int32 SampleRate = StreamSampleRate.Load();
+        const int32 NumChannels = StreamChannels.Load();
+        if (SampleRate <= 0 || NumChannels <= 0)
+        {
+            return;
+        }
+
+        if (!LaunchEncoder(SampleRate, NumChannels))
+        {
+            bFailed = true;
+        }
+    }
+
+    const uint8* Data = nullptr;
+    int32 NumSamples = 0;
+    while ((NumSamples = Ring->PeekSamples(Data, EncodeChunkSamples)) > 0)
+    {
+        // Keep the ring moving even after a failure so the capture itself is not stalled.
+        if (!bFailed.Load() && !Pipe.Write(Data, static_cast<int64>(NumSamples) * BytesPerSample))
+        {
+            UE_LOG(LogOmniCaptureAudioEncoder, Warning, TEXT("FFmpeg audio encoder pipe closed unexpectedly (%s)"), *FilePath);
+            bFailed = true;
+        }
+        Ring->ConsumeSamples(NumSamples);
+    }
+}
+
+bool FOmniCaptureAudioEncoder::Close()
+{
+    StopWorker();
+    Drain();
+
+    FScopeLock Lock(&EncodeCS);
+    if (!Ring)
+    {
+        return false;
+    }
+
+    Ring = nullptr;
+    if (!Pipe.IsOpen())
+    {
+        return false;
+    }
+
+    const int32 ExitCode = Pipe.Close();
+    if (ExitCode != 0)
+    {
+        UE_LOG(LogOmniCaptureAudioEncoder, Warning, TEXT("FFmpeg audio encoder exited with code %d for %s"), ExitCode, *FilePath);
+        bFailed = true;
+    }
+
+    return !bFailed.Load();
+}
+
+void FOmniCaptureAudioEncoder::StopWorker()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    bRunning = false;
+    Wake();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+    delete Worker;
+    Worker = nullptr;
+}
@@ -1,12 +1,9 @@
 #include "OmniCaptureAudioRecorder.h"
 
-#include "AudioMixerBlueprintLibrary.h"
 #include "AudioDevice.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
-#include "Sound/SoundWave.h"
 #include "Sound/SoundSubmix.h"
-#include "Misc/ScopeLock.h"
 
 #if WITH_AUDIOMIXER
 #include "AudioMixerDevice.h"
@@ -40,9 +37,11 @@ FOmniCaptureAudioRecorder::FOmniCaptureAudioRecorder()
 {
 }
 
-bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings)
+bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings, double InClockOrigin)
 {
     WorldPtr = InWorld;
+    ClockOrigin = InClockOrigin;
+    FrameDuration = 1.0 / FMath::Max(1.0f, Settings.TargetFrameRate);
     Gain = Settings.AudioGain;
     TargetSubmix = Settings.SubmixToRecord;
     if (!TargetSubmix.IsValid() && Settings.SubmixToRecord.ToSoftObjectPath().IsValid())
@@ -52,11 +51,22 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
             TargetSubmix = LoadedSubmix;
         }
     }
-    PendingPacketCount = 0;
-    AudioClockOrigin = -1.0;
+    Converter.Configure(Settings.AudioSampleFormat, Settings.AudioGain, Settings.AudioChannelGains, Settings.bAudioDither);
+    AudioRing.Initialize(48000 * 8 * 4, 1024, Settings.AudioSampleFormat);
+    Timeline.Reset();
+    PausedMicroseconds.Store(0);
     AudioStartTime = 0.0;
     bPaused.Store(false);
 
+    const FString SanitizedName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    FString Directory = Settings.OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : Settings.OutputDirectory;
+    Directory = FPaths::ConvertRelativePathToFull(Directory);
+    IFileManager::Get().MakeDirectory(*Directory, true);
+    OutputBasePath = Directory / SanitizedName;
+    OutputFilePath = OutputBasePath + TEXT(".wav");
+    EncoderSettings = Settings;
+    bUseEncoder = false;
+
 #if WITH_AUDIOMIXER
     MixerDevice = nullptr;
     if (WorldPtr.IsValid())
@@ -69,6 +79,9 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
             }
         }
     }
+    AmbisonicEncoder.Configure(Settings.AmbisonicOrder, MixerDevice ? MixerDevice->GetNumDeviceChannels() : 2);
+#else
+    AmbisonicEncoder.Configure(Settings.AmbisonicOrder, 2);
 #endif
 
     return WorldPtr.IsValid();
@@ -81,87 +94,93 @@ void FOmniCaptureAudioRecorder::Start()
         return;
     }
 
+    bUseEncoder = EncoderSettings.AudioCodec != EOmniCaptureAudioCodec::WAV && Encoder.Open(EncoderSettings, OutputBasePath, AudioRing, Converter.GetFormat());
+    if (!bUseEncoder && !WavWriter.Open(OutputFilePath, AudioRing, Converter.GetFormat()))
+    {
+        return;
+    }
+
     RegisterListener();
     AudioStartTime = FPlatformTime::Seconds();
-
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StartRecordingOutput(WorldPtr.Get(), 0.0f, Submix);
     bIsRecording = true;
     bPaused.Store(false);
 }
 
-void FOmniCaptureAudioRecorder::Stop(const FString& OutputDirectory, const FString& BaseFileName)
+void FOmniCaptureAudioRecorder::Stop()
 {
-    if (!WorldPtr.IsValid() || !bIsRecording)
+    if (!bIsRecording)
     {
         return;
     }
 
-    const FString SanitizedName = BaseFileName.IsEmpty() ? TEXT("OmniCapture") : BaseFileName;
-    FString Directory = OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : OutputDirectory;
-    Directory = FPaths::ConvertRelativePathToFull(Directory);
-    IFileManager::Get().MakeDirectory(*Directory, true);
-
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StopRecordingOutput(WorldPtr.Get(), EAudioRecordingExportType::WavFile, SanitizedName, Directory, Submix);
-    OutputFilePath = Directory / (SanitizedName + TEXT(".wav"));
-
     UnregisterListener();
 
     bIsRecording = false;
 
+    const bool bWritten = bUseEncoder ? Encoder.Close() : WavWriter.Close(CachedSampleRate.Load(), FMath::Max(1, CachedNumChannels.Load()), AmbisonicEncoder.IsEnabled());
+    if (bUseEncoder)
     {
-        FScopeLock Lock(&PacketCS);
-        FOmniAudioPacket Packet;
-        while (PendingPackets.Dequeue(Packet))
-        {
-        }
-        PendingPacketCount = 0;
+        OutputFilePath = Encoder.GetFilePath();
+    }
+
+    if (!bWritten)
+    {
+        UE_LOG(LogOmniCaptureAudio, Warning, TEXT("No audio was written to %s"), *OutputFilePath);
+        OutputFilePath.Reset();
     }
 
-    AudioClockOrigin = -1.0;
+    AudioRing.Reset();
+
     AudioStartTime = 0.0;
     bPaused.Store(false);
 }
 
-void FOmniCaptureAudioRecorder::GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets)
+void FOmniCaptureAudioRecorder::GatherAudio(double FrameTimestamp, TArray<FOmniAudioSpan, TInlineAllocator<8>>& OutSpans)
 {
-    FScopeLock Lock(&PacketCS);
-
-    const double Threshold = FrameTimestamp + (1.0 / 120.0);
-    for (;;)
-    {
-        FOmniAudioPacket Packet;
-        if (!PendingPackets.Peek(Packet))
-        {
-            break;
-        }
-
-        if (Packet.Timestamp > Threshold)
-        {
-            break;
-        }
-
-        PendingPackets.Dequeue(Packet);
-        PendingPacketCount.DecrementExchange();
-        OutPackets.Add(MoveTemp(Packet));
-    }
+    const double Threshold = FrameTimestamp + FrameDuration;
+    AudioRing.Gather(Threshold, OutSpans);
 }
 
 FString FOmniCaptureAudioRecorder::GetDebugStatus() const
 {
-    const int32 Pending = PendingPacketCount.Load();
+    const int32 Pending = AudioRing.GetPendingMarkerCount();
     const FString SubmixName = TargetSubmix.IsValid() ? TargetSubmix->GetName() : TEXT("Master");
-    return FString::Printf(TEXT("AudioPackets:%d SR:%d Submix:%s"), Pending, CachedSampleRate, *SubmixName);
+    return FString::Printf(TEXT("AudioPackets:%d SR:%d Submix:%s Overruns:%llu Written:%.1fMB Timeline:%.2fms"), Pending, CachedSampleRate.Load(), *SubmixName, AudioRing.GetDroppedSampleCount(), (bUseEncoder ? Encoder.GetBytesWritten() : WavWriter.GetBytesWritten()) / (1024.0 * 1024.0), Timeline.GetDriftMilliseconds());
 }
 
 int32 FOmniCaptureAudioRecorder::GetPendingPacketCount() const
 {
-    return PendingPacketCount.Load();
+    return AudioRing.GetPendingMarkerCount();
+}
+
+bool FOmniCaptureAudioRecorder::IsNonRealtimeDevice() const
+{
+#if WITH_AUDIOMIXER
+    return MixerDevice && MixerDevice->IsNonRealtime();
+#else
+    return false;
+#endif
 }
 
 void FOmniCaptureAudioRecorder::SetPaused(bool bInPaused)
 {
+    if (bInPaused == bPaused.Load())
+    {
+        return;
+    }
+
+    // Paused time is excluded from the reference clock, matching the packed video timeline.
+    const double Now = FPlatformTime::Seconds();
+    if (bInPaused)
+    {
+        PauseStartTime = Now;
+    }
+    else if (PauseStartTime > 0.0)
+    {
+        PausedMicroseconds.AddExchange(static_cast<int64>((Now - PauseStartTime) * 1000000.0));
+        PauseStartTime = 0.0;
+    }
+
     bPaused.Store(bInPaused);
 }
 
@@ -212,31 +231,57 @@ void FOmniCaptureAudioRecorder::HandleSubmixBuffer(const float* AudioData, int32
     }
 
 #if WITH_AUDIOMIXER
-    CachedSampleRate = SampleRate;
-
-    if (AudioClockOrigin < 0.0)
-    {
-        AudioClockOrigin = AudioClock;
-    }
+    const int32 NumFrames = NumSamples / FMath::Max(NumChannels, 1);
+    const int32 ChunkFrames = AmbisonicEncoder.IsEnabled() ? FOmniCaptureAmbisonicEncoder::MaxBlockFrames : FMath::Max(NumFrames, 1);
+    const double ReferenceSeconds = FPlatformTime::Seconds() - ClockOrigin - PausedMicroseconds.Load() / 1000000.0;
 
-    const double RelativeTimestamp = FMath::Max(0.0, AudioClock - AudioClockOrigin);
-    FOmniAudioPacket Packet;
-    Packet.Timestamp = RelativeTimestamp;
-    Packet.SampleRate = SampleRate;
-    Packet.NumChannels = NumChannels;
-    Packet.PCM16.SetNumUninitialized(NumSamples);
+    CachedSampleRate.Store(SampleRate);
 
-    for (int32 Index = 0; Index < NumSamples; ++Index)
+    bool bWritten = false;
+    int32 BedChannels = NumChannels;
+    for (int32 FrameOffset = 0; FrameOffset < NumFrames; FrameOffset += ChunkFrames)
     {
-        const float SampleValue = AudioData[Index] * Gain;
-        const int32 IntValue = FMath::RoundToInt(SampleValue * 32767.0f);
-        Packet.PCM16[Index] = static_cast<int16>(FMath::Clamp(IntValue, -32768, 32767));
+        const int32 Frames = FMath::Min(ChunkFrames, NumFrames - FrameOffset);
+        const float* BedData = AudioData + FrameOffset * NumChannels;
+        if (AmbisonicEncoder.IsEnabled())
+        {
+            BedData = AmbisonicEncoder.Process(BedData, Frames, NumChannels);
+            if (!BedData)
+            {
+                break;
+            }
+            BedChannels = AmbisonicEncoder.GetOutputChannels();
+        }
+
+        // The reference clock marks the end of the whole callback, not of this chunk.
+        const double ChunkReferenceSeconds = ReferenceSeconds - static_cast<double>(NumFrames - FrameOffset - Frames) / FMath::Max(SampleRate, 1);
+        FOmniCaptureAudioBlock Block;
+        if (Timeline.Process(BedData, Frames, BedChannels, SampleRate, ChunkReferenceSeconds, Block))
+        {
+            if (AudioRing.Write(Block.Data, Block.NumFrames * BedChannels, Block.Timestamp, SampleRate, BedChannels, Converter))
+            {
+                bWritten = true;
+            }
+            else
+            {
+                // The ring drops whole blocks when the writer falls behind; keep the timeline in step with the file.
+                Timeline.DiscardBlock(Block);
+            }
+        }
     }
 
+    CachedNumChannels.Store(BedChannels);
+    if (bWritten)
     {
-        FScopeLock Lock(&PacketCS);
-        PendingPackets.Enqueue(MoveTemp(Packet));
-        PendingPacketCount.IncrementExchange();
+        if (bUseEncoder)
+        {
+            Encoder.SetStreamFormat(SampleRate, BedChannels);
+            Encoder.Wake();
+        }
+        else
+        {
+            WavWriter.Wake();
+        }
     }
 #else
     (void)AudioData;
@@ -0,0 +1,131 @@
+#include "OmniCaptureAudioRing.h"
+
+#include "Math/UnrealMathUtility.h"
+
+void FOmniCaptureAudioRing::Initialize(int32 InSampleCapacity, int32 InMarkerCapacity, EOmniCaptureAudioFormat InFormat)
+{
+    SampleCapacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InSampleCapacity, 1024));
+    const int32 MarkerCapacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InMarkerCapacity, 16));
+
+    Format = InFormat;
+    BytesPerSample = FOmniCaptureAudioConverter::GetBytesPerSample(InFormat);
+    Buffer.SetNumZeroed(SampleCapacity * BytesPerSample);
+    Markers.SetNum(MarkerCapacity);
+    SampleMask = static_cast<uint64>(SampleCapacity - 1);
+    MarkerMask = static_cast<uint64>(MarkerCapacity - 1);
+
+    Reset();
+}
+
+void FOmniCaptureAudioRing::Reset()
+{
+    SampleHead.Store(0);
+    SampleTail.Store(0);
+    MarkerHead.Store(0);
+    MarkerTail.Store(0);
+    DroppedSamples.Store(0);
+    DroppedMarkers.Store(0);
+}
+
+bool FOmniCaptureAudioRing::Write(const float* AudioData, int32 NumSamples, double Timestamp, int32 SampleRate, int32 NumChannels, FOmniCaptureAudioConverter& Converter)
+{
+    if (!AudioData || NumSamples <= 0 || SampleCapacity == 0 || Converter.GetFormat() != Format)
+    {
+        return false;
+    }
+
+    const uint64 Head = SampleHead.Load(EMemoryOrder::Relaxed);
+    const uint64 Tail = SampleTail.Load();
+    const uint64 MarkerWrite = MarkerHead.Load(EMemoryOrder::Relaxed);
+    const uint64 MarkerRead = MarkerTail.Load();
+
+    const uint64 FreeSamples = static_cast<uint64>(SampleCapacity) - (Head - Tail);
+    if (static_cast<uint64>(NumSamples) > FreeSamples)
+    {
+        DroppedSamples.AddExchange(static_cast<uint64>(NumSamples));
+        return false;
+    }
+
+    const int32 Start = static_cast<int32>(Head & SampleMask);
+    const int32 FirstCount = FMath::Min(NumSamples, SampleCapacity - Start);
+
+    uint8* Dest = Buffer.GetData();
+    Converter.Convert(AudioData, FirstCount, NumChannels, 0, Dest + Start * BytesPerSample);
+    if (FirstCount < NumSamples)
+    {
+        Converter.Convert(AudioData + FirstCount, NumSamples - FirstCount, NumChannels, FirstCount, Dest);
+    }
+
+    SampleHead.Store(Head + static_cast<uint64>(NumSamples));
+
+    // Markers only carry timing for the frame worker; the file writer owns the samples,
+    // so a slow frame consumer loses markers rather than audio.
+    if ((MarkerWrite - MarkerRead) >= static_cast<uint64>(Markers.Num()))
+    {
+        DroppedMarkers.AddExchange(1);
+        return true;
+    }
+
+    FMarker& Marker = Markers[static_cast<int32>(MarkerWrite & MarkerMask)];
+    Marker.Timestamp = Timestamp;
+    Marker.NumSamples = NumSamples;
+    Marker.SampleRate = SampleRate;
+    Marker.NumChannels = NumChannels;
+
+    MarkerHead.Store(MarkerWrite + 1);
+    return true;
+}
+
+bool FOmniCaptureAudioRing::PopMarker(double MaxTimestamp, FOmniAudioSpan& OutSpan)
+{
+    const uint64 MarkerRead = MarkerTail.Load(EMemoryOrder::Relaxed);
+    if (MarkerRead == MarkerHead.Load())
+    {
+        return false;
+    }
+
+    const FMarker& Marker = Markers[static_cast<int32>(MarkerRead & MarkerMask)];
+    if (Marker.Timestamp > MaxTimestamp)
+    {
+        return false;
+    }
+
+    OutSpan.Timestamp = Marker.Timestamp;
+    OutSpan.SampleRate = Marker.SampleRate;
+    OutSpan.NumChannels = Marker.NumChannels;
+    OutSpan.Format = Format;
+    OutSpan.BytesPerSample = BytesPerSample;
+    OutSpan.NumSamples = Marker.NumSamples;
+
+    MarkerTail.Store(MarkerRead + 1);
+    return true;
+}
+
+int32 FOmniCaptureAudioRing::PeekSamples(const uint8*& OutData, int32 MaxSamples) const
+{
+    const uint64 Tail = SampleTail.Load(EMemoryOrder::Relaxed);
+    const uint64 Available = SampleHead.Load() - Tail;
+    if (Available == 0 || MaxSamples <= 0)
+    {
+        OutData = nullptr;
+        return 0;
+    }
+
+    const int32 Start = static_cast<int32>(Tail & SampleMask);
+    const int32 Contiguous = static_cast<int32>(FMath::Min<uint64>(Available, static_cast<uint64>(SampleCapacity - Start)));
+    OutData = Buffer.GetData() + Start * BytesPerSample;
+    return FMath::Min(Contiguous, MaxSamples);
+}
+
+void FOmniCaptureAudioRing::ConsumeSamples(int32 NumSamples)
+{
+    if (NumSamples > 0)
+    {
+        SampleTail.Store(SampleTail.Load(EMemoryOrder::Relaxed) + static_cast<uint64>(NumSamples));
+    }
+}
+
+int32 FOmniCaptureAudioRing::GetPendingMarkerCount() const
+{
+    return static_cast<int32>(MarkerHead.Load() - MarkerTail.Load());
+}
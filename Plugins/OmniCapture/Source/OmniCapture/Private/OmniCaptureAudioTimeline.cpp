@@ -0,0 +1,215 @@
+#include "OmniCaptureAudioTimeline.h"
+
+#include "OmniCaptureAudioConverter.h"
+#include "Math/UnrealMathUtility.h"
+
+namespace
+{
+    // Drift is smoothed over roughly a second so callback jitter does not trigger corrections.
+    constexpr double DriftTimeConstantSeconds = 1.0;
+    constexpr double DriftDeadbandSeconds = 0.0005;
+    constexpr double DriftResyncSeconds = 0.05;
+    constexpr int32 MaxPadFrames = 4096;
+    constexpr int32 MaxBlockFrames = 8192;
+
+    int64 ToBits(double Value)
+    {
+        int64 Bits = 0;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        return Bits;
+    }
+
+    double FromBits(int64 Bits)
+    {
+        double Value = 0.0;
+        FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+        return Value;
+    }
+}
+
+FOmniCaptureAudioTimeline::FOmniCaptureAudioTimeline()
+{
+    // Sized once for the widest layout the converter accepts, so corrections never allocate.
+    Scratch.SetNumZeroed((MaxBlockFrames + MaxPadFrames) * FOmniCaptureAudioConverter::MaxChannels);
+}
+
+void FOmniCaptureAudioTimeline::Reset()
+{
+    StartTime = -1.0;
+    SmoothedDrift = 0.0;
+    SampleRate = 0;
+    NumChannels = 0;
+    FramesWritten = 0;
+    FramesInserted = 0;
+    FramesDropped = 0;
+    MaxDriftSeconds = 0.0;
+    DriftMicroseconds.Store(0);
+    PublishSummary();
+}
+
+void FOmniCaptureAudioTimeline::PublishSummary()
+{
+    PublishedStartTimeBits.Store(ToBits(FMath::Max(StartTime, 0.0)));
+    PublishedMaxDriftBits.Store(ToBits(MaxDriftSeconds));
+    PublishedSampleRate.Store(SampleRate);
+    PublishedNumChannels.Store(NumChannels);
+    PublishedFramesInserted.Store(FramesInserted);
+    PublishedFramesDropped.Store(FramesDropped);
+    PublishedFramesWritten.Store(FramesWritten);
+}
+
+bool FOmniCaptureAudioTimeline::Process(const float* InData, int32 NumFrames, int32 InNumChannels, int32 InSampleRate, double ReferenceSeconds, FOmniCaptureAudioBlock& OutBlock)
+{
+    if (!InData || NumFrames <= 0 || InNumChannels <= 0 || InSampleRate <= 0)
+    {
+        return false;
+    }
+
+    const double FrameDuration = 1.0 / static_cast<double>(InSampleRate);
+    const double BlockDuration = NumFrames * FrameDuration;
+
+    if (StartTime < 0.0 || SampleRate != InSampleRate || NumChannels != InNumChannels)
+    {
+        // The block has just been rendered, so its first sample sits one block before the reference.
+        StartTime = bLockstep ? 0.0 : FMath::Max(0.0, ReferenceSeconds - BlockDuration) - FramesWritten * FrameDuration;
+        SampleRate = InSampleRate;
+        NumChannels = InNumChannels;
+        SmoothedDrift = 0.0;
+    }
+
+    // In lockstep the device renders exactly one world step per tick, so the sample count is the clock.
+    const double Drift = bLockstep ? 0.0 : (StartTime + (FramesWritten + NumFrames) * FrameDuration) - ReferenceSeconds;
+    const double Alpha = 1.0 - FMath::Exp(-BlockDuration / DriftTimeConstantSeconds);
+    SmoothedDrift += (Drift - SmoothedDrift) * Alpha;
+
+    const float* Source = InData;
+    int32 SourceFrames = NumFrames;
+    int32 PadFrames = 0;
+    int32 OutFrames = NumFrames;
+
+    if (Drift < -DriftResyncSeconds)
+    {
+        // Audio fell behind (device hiccup, missed callbacks): fill the gap with silence.
+        PadFrames = FMath::Min(FMath::RoundToInt(-Drift * SampleRate), MaxPadFrames);
+        FramesInserted += PadFrames;
+        SmoothedDrift = Drift + PadFrames * FrameDuration;
+    }
+    else if (Drift > DriftResyncSeconds)
+    {
+        const int32 TrimFrames = FMath::Min(FMath::RoundToInt(Drift * SampleRate), NumFrames);
+        Source += TrimFrames * NumChannels;
+        SourceFrames -= TrimFrames;
+        OutFrames = SourceFrames;
+        FramesDropped += TrimFrames;
+        SmoothedDrift = Drift - TrimFrames * FrameDuration;
+    }
+    else if (FMath::Abs(SmoothedDrift) > DriftDeadbandSeconds)
+    {
+        // Stretch or squeeze the block by at most ~0.4% so the correction stays inaudible.
+        const int32 MaxStep = FMath::Max(1, NumFrames / 256);
+        const int32 Step = FMath::Clamp(FMath::RoundToInt(SmoothedDrift * SampleRate), -MaxStep, MaxStep);
+        OutFrames = NumFrames - Step;
+        if (Step > 0)
+        {
+            FramesDropped += Step;
+        }
+        else
+        {
+            FramesInserted += -Step;
+        }
+        SmoothedDrift -= Step * FrameDuration;
+    }
+
+    MaxDriftSeconds = FMath::Max(MaxDriftSeconds, FMath::Abs(Drift));
+    DriftMicroseconds.Store(static_cast<int64>(SmoothedDrift * 1000000.0));
+
+    OutBlock.Timestamp = StartTime + FramesWritten * FrameDuration;
+
+    if (PadFrames == 0 && OutFrames == SourceFrames)
+    {
+        OutBlock.Data = Source;
+        OutBlock.NumFrames = SourceFrames;
+    }
+    else
+    {
+        if (SourceFrames > MaxBlockFrames || (PadFrames + OutFrames) * NumChannels > Scratch.Num())
+        {
+            OutBlock.Data = Source;
+            OutBlock.NumFrames = SourceFrames;
+            FramesWritten += SourceFrames;
+            PublishSummary();
+            return SourceFrames > 0;
+        }
+
+        float* Dest = Scratch.GetData();
+        FMemory::Memzero(Dest, PadFrames * NumChannels * sizeof(float));
+        Resample(Source, SourceFrames, NumChannels, OutFrames, Dest + PadFrames * NumChannels);
+
+        OutBlock.Data = Dest;
+        OutBlock.NumFrames = PadFrames + OutFrames;
+    }
+
+    FramesWritten += OutBlock.NumFrames;
+    PublishSummary();
+    return OutBlock.NumFrames > 0;
+}
+
+void FOmniCaptureAudioTimeline::DiscardBlock(const FOmniCaptureAudioBlock& Block)
+{
+    if (Block.NumFrames <= 0)
+    {
+        return;
+    }
+
+    FramesWritten -= Block.NumFrames;
+    FramesDropped += Block.NumFrames;
+    PublishSummary();
+}
+
+int32 FOmniCaptureAudioTimeline::Resample(const float* InData, int32 NumFrames, int32 InNumChannels, int32 OutFrames, float* OutData) const
+{
+    if (OutFrames <= 0 || NumFrames <= 0)
+    {
+        return 0;
+    }
+
+    if (OutFrames == NumFrames || NumFrames == 1 || OutFrames == 1)
+    {
+        const int32 CopyFrames = FMath::Min(OutFrames, NumFrames);
+        FMemory::Memcpy(OutData, InData, CopyFrames * InNumChannels * sizeof(float));
+        return CopyFrames;
+    }
+
+    const double Step = static_cast<double>(NumFrames - 1) / static_cast<double>(OutFrames - 1);
+    for (int32 Frame = 0; Frame < OutFrames; ++Frame)
+    {
+        const double Position = Frame * Step;
+        const int32 Index = FMath::Min(static_cast<int32>(Position), NumFrames - 2);
+        const float Alpha = static_cast<float>(Position - Index);
+
+        const float* A = InData + Index * InNumChannels;
+        const float* B = A + InNumChannels;
+        float* Out = OutData + Frame * InNumChannels;
+        for (int32 Channel = 0; Channel < InNumChannels; ++Channel)
+        {
+            Out[Channel] = A[Channel] + (B[Channel] - A[Channel]) * Alpha;
+        }
+    }
+
+    return OutFrames;
+}
+
+FOmniCaptureAudioTimelineSummary FOmniCaptureAudioTimeline::GetSummary() const
+{
+    // Fields are published individually; the summary is read once the submix listener has stopped,
+    // and mid-capture reads only feed status text.
+    FOmniCaptureAudioTimelineSummary Summary;
+    Summary.StartTime = FromBits(PublishedStartTimeBits.Load());
+    Summary.SampleRate = PublishedSampleRate.Load();
+    Summary.NumChannels = PublishedNumChannels.Load();
+    Summary.FramesWritten = PublishedFramesWritten.Load();
+    Summary.FramesInserted = PublishedFramesInserted.Load();
+    Summary.FramesDropped = PublishedFramesDropped.Load();
+    Summary.MaxDriftMilliseconds = FromBits(PublishedMaxDriftBits.Load()) * 1000.0;
+    return Summary;
+}
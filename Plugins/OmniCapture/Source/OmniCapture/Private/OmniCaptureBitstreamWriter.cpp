@@ -0,0 +1,336 @@
+#include "OmniCaptureBitstreamWriter.h"
+
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureBitstream, Log, All);
+
+class FOmniCaptureBitstreamWorker final : public FRunnable
+{
+public:
+    FOmniCaptureBitstreamWorker(FOmniCaptureBitstreamWriter& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning.Load())
+        {
+            Owner.Drain();
+            WakeEvent->Wait(20);
+        }
+
+        Owner.Drain();
+        return 0;
+    }
+
+private:
+    FOmniCaptureBitstreamWriter& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+
+FOmniCaptureBitstreamWriter::FOmniCaptureBitstreamWriter()
+{
+    bRunning = false;
+}
+
+FOmniCaptureBitstreamWriter::~FOmniCaptureBitstreamWriter()
+{
+    Close();
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+bool FOmniCaptureBitstreamWriter::Open(const FString& InFilePath, int64 InFlushThreshold, int64 InWriteAlignment)
+{
+    if (FileHandle)
+    {
+        return false;
+    }
+
+    FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*InFilePath, /*bAppend=*/false));
+    if (!FileHandle)
+    {
+        UE_LOG(LogOmniCaptureBitstream, Warning, TEXT("Unable to open bitstream output file %s"), *InFilePath);
+        return false;
+    }
+
+    FilePath = InFilePath;
+    WriteAlignment = FMath::Max<int64>(4096, InWriteAlignment);
+    FlushThreshold = FMath::Max(WriteAlignment, InFlushThreshold);
+
+    // Headroom for one aligned tail plus a large packet so steady state never reallocates.
+    FrontBuffer.Reset();
+    BackBuffer.Reset();
+    FrontBuffer.Reserve(FlushThreshold + WriteAlignment * 2);
+    BackBuffer.Reserve(FlushThreshold + WriteAlignment * 2);
+    bBackBufferBusy = false;
+
+    Stats = FOmniCaptureBitstreamStats();
+    RateWindowStart = FPlatformTime::Seconds();
+    RateWindowBytes = 0;
+    RateWindowPackets = 0;
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+
+    bRunning = true;
+    Worker = new FOmniCaptureBitstreamWorker(*this, WakeEvent, bRunning);
+    Thread = FRunnableThread::Create(Worker, TEXT("OmniCaptureBitstreamWriter"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        bRunning = false;
+        delete Worker;
+        Worker = nullptr;
+    }
+
+    return true;
+}
+
+void FOmniCaptureBitstreamWriter::Close()
+{
+    if (!FileHandle)
+    {
+        return;
+    }
+
+    StopWorker();
+    Drain();
+
+    {
+        // Whatever is left is the unaligned tail; it goes out as the last, short write.
+        FScopeLock Lock(&BufferCS);
+        SwapBuffersLocked(true);
+    }
+    Drain();
+
+    FileHandle->Flush();
+    FileHandle.Reset();
+
+    UE_LOG(LogOmniCaptureBitstream, Log, TEXT("Bitstream closed: %lld bytes in %lld packets (%d writer stalls) -> %s"),
+        Stats.TotalBytes, Stats.TotalPackets, Stats.WriterStalls, *FilePath);
+}
+
+void FOmniCaptureBitstreamWriter::AppendPacket(const uint8* Data, int64 Size)
+{
+    if (!Data || Size <= 0 || !FileHandle)
+    {
+        return;
+    }
+
+    bool bWake = false;
+    {
+        FScopeLock Lock(&BufferCS);
+        const bool bWasBelowThreshold = FrontBuffer.Num() < FlushThreshold;
+        FrontBuffer.Append(Data, Size);
+
+        ++Stats.TotalPackets;
+        Stats.TotalBytes += Size;
+        ++RateWindowPackets;
+        RateWindowBytes += Size;
+
+        const double Now = FPlatformTime::Seconds();
+        const double WindowSeconds = Now - RateWindowStart;
+        if (WindowSeconds >= 1.0)
+        {
+            Stats.BytesPerSecond = RateWindowBytes / WindowSeconds;
+            Stats.PacketsPerSecond = RateWindowPackets / WindowSeconds;
+            RateWindowStart = Now;
+            RateWindowBytes = 0;
+            RateWindowPackets = 0;
+        }
+
+        const int64 QueuedBytes = FrontBuffer.Num() + (bBackBufferBusy ? BackBuffer.Num() : 0);
+        Stats.PeakQueuedBytes = FMath::Max(Stats.PeakQueuedBytes, QueuedBytes);
+
+        if (FrontBuffer.Num() >= FlushThreshold)
+        {
+            if (!bBackBufferBusy)
+            {
+                SwapBuffersLocked(false);
+                bWake = true;
+            }
+            else if (bWasBelowThreshold)
+            {
+                // The disk has fallen a full buffer behind; keep growing rather than block the encoder.
+                ++Stats.WriterStalls;
+            }
+        }
+    }
+
+    if (bWake)
+    {
+        if (Thread)
+        {
+            WakeEvent->Trigger();
+        }
+        else
+        {
+            Drain();
+        }
+    }
+}
+
+void FOmniCaptureBitstreamWriter::SwapBuffersLocked(bool bFinal)
+{
+    if (bBackBufferBusy)
+    {
+        return;
+    }
+
+    // Only whole alignment units leave until the final flush, so every write lands on an aligned offset.
+    const int64 WriteBytes = bFinal ? FrontBuffer.Num() : (FrontBuffer.Num() / WriteAlignment) * WriteAlignment;
+    if (WriteBytes <= 0)
+    {
+        return;
+    }
+
+    Swap(FrontBuffer, BackBuffer);
+    FrontBuffer.Reset();
+
+    const int64 TailBytes = BackBuffer.Num() - WriteBytes;
+    if (TailBytes > 0)
+    {
+        FrontBuffer.Append(BackBuffer.GetData() + WriteBytes, TailBytes);
+        BackBuffer.SetNum(WriteBytes, EAllowShrinking::No);
+    }
+
+    bBackBufferBusy = true;
+}
+
+void FOmniCaptureBitstreamWriter::Drain()
+{
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&BufferCS);
+            if (!bBackBufferBusy || !FileHandle)
+            {
+                return;
+            }
+        }
+
+        // BackBuffer belongs to this thread until bBackBufferBusy is cleared.
+        if (!FileHandle->Write(BackBuffer.GetData(), BackBuffer.Num()))
+        {
+            UE_LOG(LogOmniCaptureBitstream, Warning, TEXT("Bitstream write of %d bytes failed for %s"), BackBuffer.Num(), *FilePath);
+        }
+
+        FScopeLock Lock(&BufferCS);
+        BackBuffer.Reset();
+        bBackBufferBusy = false;
+        if (FrontBuffer.Num() >= FlushThreshold)
+        {
+            SwapBuffersLocked(false);
+        }
+    }
+}
+
+FOmniCaptureBitstreamStats FOmniCaptureBitstreamWriter::GetStats() const
+{
+    FScopeLock Lock(&BufferCS);
+    return Stats;
+}
+
+void FOmniCaptureBitstreamWriter::StopWorker()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    bRunning = false;
+    WakeEvent->Trigger();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+    delete Worker;
+    Worker = nullptr;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureBitstreamWriterTest, "OmniCapture.NVENC.BitstreamWriter",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureBitstreamWriterTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumPackets = 4000;
+    const FString TestPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("OmniCaptures") / TEXT("BitstreamWriterBenchmark.h265"));
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(TestPath), true);
+
+    FRandomStream Random(4242);
+    TArray<uint8> Packet;
+    uint32 ExpectedCrc = 0;
+    int64 ExpectedBytes = 0;
+
+    FOmniCaptureBitstreamWriter Writer;
+    if (!TestTrue(TEXT("Writer opened"), Writer.Open(TestPath)))
+    {
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 PacketIndex = 0; PacketIndex < NumPackets; ++PacketIndex)
+    {
+        // Mostly small inter frames with a large IDR every 60 packets.
+        const int32 PacketSize = (PacketIndex % 60) == 0 ? Random.RandRange(256 * 1024, 1024 * 1024) : Random.RandRange(2 * 1024, 96 * 1024);
+        Packet.SetNumUninitialized(PacketSize);
+        Packet[0] = 0;
+        Packet[1] = 0;
+        Packet[2] = 0;
+        Packet[3] = 1;
+        for (int32 Index = 4; Index < PacketSize; ++Index)
+        {
+            Packet[Index] = static_cast<uint8>(Random.RandHelper(256));
+        }
+
+        ExpectedCrc = FCrc::MemCrc32(Packet.GetData(), PacketSize, ExpectedCrc);
+        ExpectedBytes += PacketSize;
+        Writer.AppendPacket(Packet.GetData(), PacketSize);
+    }
+    const double AppendSeconds = FPlatformTime::Seconds() - StartTime;
+    const FOmniCaptureBitstreamStats Stats = Writer.GetStats();
+    Writer.Close();
+    const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+    TArray<uint8> Written;
+    const bool bLoaded = FFileHelper::LoadFileToArray(Written, *TestPath);
+    const bool bMatches = bLoaded && Written.Num() == ExpectedBytes && FCrc::MemCrc32(Written.GetData(), Written.Num()) == ExpectedCrc;
+    IFileManager::Get().Delete(*TestPath);
+
+    TestTrue(TEXT("Written file matches appended packets"), bMatches);
+    AddInfo(FString::Printf(TEXT("%d packets, %.1f MB, append %.3f ms, total %.3f ms (%.1f MB/s), peak queue %.1f MB, stalls %d"),
+        NumPackets,
+        ExpectedBytes / (1024.0 * 1024.0),
+        AppendSeconds * 1000.0,
+        TotalSeconds * 1000.0,
+        TotalSeconds > 0.0 ? (ExpectedBytes / (1024.0 * 1024.0)) / TotalSeconds : 0.0,
+        Stats.PeakQueuedBytes / (1024.0 * 1024.0),
+        Stats.WriterStalls));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
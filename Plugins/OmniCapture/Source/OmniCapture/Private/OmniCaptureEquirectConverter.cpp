@@ -1,6 +1,9 @@
 #include "OmniCaptureEquirectConverter.h"
 
 #include "Engine/TextureRenderTarget2D.h"
+#include "OmniCaptureProjectionMath.h"
+#include "OmniCaptureStageTimings.h"
+#include "OmniCaptureSubframeAccumulator.h"
 #include "OmniCaptureTypes.h"
 
 #include "GlobalShader.h"
@@ -14,36 +17,12 @@
 #include "RHICommandList.h"
 #include "HAL/PlatformProcess.h"
 
+DECLARE_GPU_STAT_NAMED(OmniCaptureConvert, TEXT("OmniCapture Convert"));
+
 namespace
 {
-    struct FCPUFaceData
-    {
-        int32 Resolution = 0;
-        TArray<FFloat16Color> Pixels;
-
-        bool IsValid() const
-        {
-            return Resolution > 0 && Pixels.Num() == Resolution * Resolution;
-        }
-    };
-
-    struct FCPUCubemap
-    {
-        FCPUFaceData Faces[6];
-
-        bool IsValid() const
-        {
-            for (int32 Index = 0; Index < 6; ++Index)
-            {
-                if (!Faces[Index].IsValid())
-                {
-                    return false;
-                }
-            }
-
-            return true;
-        }
-    };
+    using FCPUFaceData = FOmniCaptureCPUFace;
+    using FCPUCubemap = FOmniCaptureCPUCubemap;
 
     class FOmniEquirectCS final : public FGlobalShader
     {
@@ -193,114 +172,33 @@ namespace
         return OutCubemap.IsValid();
     }
 
-    FVector DirectionFromEquirectPixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, float& OutLatitude)
-    {
-        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
-        const double Longitude = (UV.X * 2.0 - 1.0) * PI;
-        OutLatitude = (0.5 - UV.Y) * PI;
-
-        const double CosLat = FMath::Cos(OutLatitude);
-        const double SinLat = FMath::Sin(OutLatitude);
-        const double CosLon = FMath::Cos(Longitude);
-        const double SinLon = FMath::Sin(Longitude);
-
-        FVector Direction;
-        Direction.X = CosLat * CosLon;
-        Direction.Y = SinLat;
-        Direction.Z = CosLat * SinLon;
-        return Direction.GetSafeNormal();
-    }
-
-    void DirectionToFaceUVCPU(const FVector& Direction, uint32& OutFaceIndex, FVector2D& OutUV, int32 FaceResolution, float SeamStrength)
-    {
-        const FVector AbsDir = Direction.GetAbs();
-
-        if (AbsDir.X >= AbsDir.Y && AbsDir.X >= AbsDir.Z)
-        {
-            if (Direction.X > 0.0f)
-            {
-                OutFaceIndex = 0;
-                OutUV = FVector2D(-Direction.Z, Direction.Y) / AbsDir.X;
-            }
-            else
-            {
-                OutFaceIndex = 1;
-                OutUV = FVector2D(Direction.Z, Direction.Y) / AbsDir.X;
-            }
-        }
-        else if (AbsDir.Y >= AbsDir.X && AbsDir.Y >= AbsDir.Z)
-        {
-            if (Direction.Y > 0.0f)
-            {
-                OutFaceIndex = 2;
-                OutUV = FVector2D(Direction.X, -Direction.Z) / AbsDir.Y;
-            }
-            else
-            {
-                OutFaceIndex = 3;
-                OutUV = FVector2D(Direction.X, Direction.Z) / AbsDir.Y;
-            }
-        }
-        else
-        {
-            if (Direction.Z > 0.0f)
-            {
-                OutFaceIndex = 4;
-                OutUV = FVector2D(Direction.X, Direction.Y) / AbsDir.Z;
-            }
-            else
-            {
-                OutFaceIndex = 5;
-                OutUV = FVector2D(-Direction.X, Direction.Y) / AbsDir.Z;
-            }
-        }
-
-        OutUV = (OutUV + FVector2D::OneVector) * 0.5f;
-
-        const double Resolution = static_cast<double>(FMath::Max(1, FaceResolution));
-        const double Scale = FMath::Lerp(1.0, (Resolution - 1.0) / Resolution, SeamStrength);
-        const double Bias = (0.5 / Resolution) * SeamStrength;
-        OutUV = FVector2D(OutUV.X * Scale + Bias, OutUV.Y * Scale + Bias);
-        OutUV.X = FMath::Clamp(OutUV.X, 0.0f, 1.0f);
-        OutUV.Y = FMath::Clamp(OutUV.Y, 0.0f, 1.0f);
-    }
-
-    FLinearColor SampleCubemapCPU(const FCPUCubemap& Cubemap, const FVector& Direction, int32 FaceResolution, float SeamStrength)
+    // The projection itself lives in the engine-independent core; this only adapts the texel fetch.
+    FLinearColor SampleCubemapCPU(const FCPUCubemap& Cubemap, const OmniCaptureProjection::FDirection& Direction, int32 FaceResolution, float SeamStrength)
     {
-        uint32 FaceIndex = 0;
-        FVector2D FaceUV = FVector2D::ZeroVector;
-        DirectionToFaceUVCPU(Direction, FaceIndex, FaceUV, FaceResolution, SeamStrength);
-
-        const FCPUFaceData& Face = Cubemap.Faces[FaceIndex];
-        const int32 SampleX = FMath::Clamp(static_cast<int32>(FaceUV.X * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleY = FMath::Clamp(static_cast<int32>(FaceUV.Y * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleIndex = SampleY * Face.Resolution + SampleX;
+        const OmniCaptureProjection::FFaceUV FaceUV = OmniCaptureProjection::DirectionToFaceUV(Direction, FaceResolution, SeamStrength);
+        const FCPUFaceData& Face = Cubemap.Faces[FaceUV.Face];
+        const int32 SampleIndex = OmniCaptureProjection::FaceTexelIndex(FaceUV, Face.Resolution);
 
         return Face.Pixels.IsValidIndex(SampleIndex)
             ? FLinearColor(Face.Pixels[SampleIndex])
             : FLinearColor::Black;
     }
 
-    void ApplyPolarMitigation(float PolarStrength, float Latitude, FVector& Direction)
+    FRDGTextureRef CreatePlaneTexture(FRDGBuilder& GraphBuilder, const FRDGTextureDesc& Desc, const TRefCountPtr<IPooledRenderTarget>* PersistentTarget, const TCHAR* DebugName)
     {
-        if (PolarStrength <= 0.0f)
+        if (PersistentTarget && PersistentTarget->IsValid()
+            && (*PersistentTarget)->GetDesc().Extent == Desc.Extent
+            && (*PersistentTarget)->GetDesc().Format == Desc.Format)
         {
-            return;
+            return GraphBuilder.RegisterExternalTexture(*PersistentTarget);
         }
 
-        double PoleFactor = FMath::Clamp(FMath::Abs(Latitude) / (PI * 0.5), 0.0, 1.0);
-        PoleFactor = FMath::Pow(PoleFactor, 4.0);
-        const double Blend = PoleFactor * PolarStrength;
-        if (Blend <= 0.0)
-        {
-            return;
-        }
+        return GraphBuilder.CreateTexture(Desc, DebugName);
+    }
 
-        const FVector PoleVector(0.0f, Latitude >= 0.0f ? 1.0f : -1.0f, 0.0f);
-        Direction = FVector(FMath::Lerp(Direction.X, PoleVector.X, Blend),
-            FMath::Lerp(Direction.Y, PoleVector.Y, Blend),
-            FMath::Lerp(Direction.Z, PoleVector.Z, Blend));
-        Direction.Normalize();
+    const TRefCountPtr<IPooledRenderTarget>* GetPlaneTarget(const TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets, int32 PlaneIndex)
+    {
+        return PlaneTargets && PlaneTargets->IsValidIndex(PlaneIndex) ? &(*PlaneTargets)[PlaneIndex] : nullptr;
     }
 
     void AddYUVConversionPasses(
@@ -310,6 +208,7 @@ namespace
         int32 OutputWidth,
         int32 OutputHeight,
         FRDGTextureRef SourceTexture,
+        const TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets,
         FRDGTextureRef& OutLuma,
         FRDGTextureRef& OutChroma)
     {
@@ -331,8 +230,8 @@ namespace
         FRDGTextureDesc LumaDesc = FRDGTextureDesc::Create2D(FIntPoint(OutputWidth, OutputHeight), LumaFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV);
         FRDGTextureDesc ChromaDesc = FRDGTextureDesc::Create2D(FIntPoint(FMath::Max(OutputWidth / 2, 1), FMath::Max(OutputHeight / 2, 1)), ChromaFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV);
 
-        OutLuma = GraphBuilder.CreateTexture(LumaDesc, TEXT("OmniNVENC_Luma"));
-        OutChroma = GraphBuilder.CreateTexture(ChromaDesc, TEXT("OmniNVENC_Chroma"));
+        OutLuma = CreatePlaneTexture(GraphBuilder, LumaDesc, GetPlaneTarget(PlaneTargets, 0), TEXT("OmniNVENC_Luma"));
+        OutChroma = CreatePlaneTexture(GraphBuilder, ChromaDesc, GetPlaneTarget(PlaneTargets, 1), TEXT("OmniNVENC_Chroma"));
 
         FOmniConvertToYUVLumaCS::FParameters* LumaParameters = GraphBuilder.AllocParameters<FOmniConvertToYUVLumaCS::FParameters>();
         LumaParameters->OutputSize = FVector2f(OutputWidth, OutputHeight);
@@ -377,7 +276,8 @@ namespace
         bool bSourceLinear,
         int32 OutputWidth,
         int32 OutputHeight,
-        FRDGTextureRef SourceTexture)
+        FRDGTextureRef SourceTexture,
+        const TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets)
     {
         if (!SourceTexture)
         {
@@ -385,7 +285,7 @@ namespace
         }
 
         FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(FIntPoint(OutputWidth, OutputHeight), PF_B8G8R8A8, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
-        FRDGTextureRef OutputTexture = GraphBuilder.CreateTexture(Desc, TEXT("OmniNVENC_BGRA"));
+        FRDGTextureRef OutputTexture = CreatePlaneTexture(GraphBuilder, Desc, GetPlaneTarget(PlaneTargets, 0), TEXT("OmniNVENC_BGRA"));
 
         FOmniConvertToBGRACS::FParameters* Parameters = GraphBuilder.AllocParameters<FOmniConvertToBGRACS::FParameters>();
         Parameters->OutputSize = FVector2f(OutputWidth, OutputHeight);
@@ -437,7 +337,51 @@ namespace
         return ArrayTexture;
     }
 
-    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTexture2DRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTexture2DRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult)
+    // Timestamp queries bracketing the equirect pass and the encoder packing pass. They are read
+    // back after the readback has flushed the GPU, so resolving them never stalls.
+    enum EGPUTimestamp
+    {
+        TimestampStart,
+        TimestampEquirect,
+        TimestampPacked,
+        TimestampCount
+    };
+
+    void AddTimestampPass(FRDGBuilder& GraphBuilder, FRenderQueryRHIRef Query)
+    {
+        if (!Query.IsValid())
+        {
+            return;
+        }
+
+        GraphBuilder.AddPass(RDG_EVENT_NAME("OmniCapture::Timestamp"), ERDGPassFlags::NeverCull, [Query](FRHICommandListImmediate& RHICmdList)
+        {
+            RHICmdList.EndRenderQuery(Query);
+        });
+    }
+
+    void RecordGPUTimestamps(const FRenderQueryRHIRef (&Queries)[TimestampCount], EOmniCaptureStage PackStage)
+    {
+        uint64 Microseconds[TimestampCount] = {};
+        for (int32 Index = 0; Index < TimestampCount; ++Index)
+        {
+            if (Queries[Index].IsValid() && !RHIGetRenderQueryResult(Queries[Index], Microseconds[Index], false))
+            {
+                return;
+            }
+        }
+
+        if (Queries[TimestampStart].IsValid() && Queries[TimestampEquirect].IsValid())
+        {
+            FOmniCaptureStageTimings::Get().Record(EOmniCaptureStage::GPUEquirect, (Microseconds[TimestampEquirect] - Microseconds[TimestampStart]) / 1000.0);
+        }
+        if (Queries[TimestampEquirect].IsValid() && Queries[TimestampPacked].IsValid())
+        {
+            FOmniCaptureStageTimings::Get().Record(PackStage, (Microseconds[TimestampPacked] - Microseconds[TimestampEquirect]) / 1000.0);
+        }
+    }
+
+    void ConvertFaceArrays(FRHICommandListImmediate& RHICmdList, FRDGBuilder& GraphBuilder, const FOmniCaptureSettings& Settings, FRDGTextureRef LeftArray, FRDGTextureRef RightArray, TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets, FOmniCaptureEquirectResult& OutResult)
     {
         const int32 FaceResolution = Settings.Resolution;
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
@@ -446,18 +390,23 @@ namespace
         const int32 OutputHeight = bStereo && !bSideBySide ? FaceResolution * 2 : FaceResolution;
         const bool bUseLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
 
-        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-        FRDGBuilder GraphBuilder(RHICmdList);
-
-        FRDGTextureRef LeftArray = BuildFaceArray(GraphBuilder, LeftFaces, FaceResolution, TEXT("OmniLeftFaces"));
-        FRDGTextureRef RightArray = bStereo ? BuildFaceArray(GraphBuilder, RightFaces, FaceResolution, TEXT("OmniRightFaces")) : LeftArray;
-
         if (!LeftArray)
         {
             GraphBuilder.Execute();
             return;
         }
 
+        RDG_EVENT_SCOPE(GraphBuilder, "OmniCapture");
+        RDG_GPU_STAT_SCOPE(GraphBuilder, OmniCaptureConvert);
+
+        FRenderQueryRHIRef Timestamps[TimestampCount];
+        if (GSupportsTimestampRenderQueries)
+        {
+            Timestamps[TimestampStart] = RHICreateRenderQuery(RQT_AbsoluteTime);
+            Timestamps[TimestampEquirect] = RHICreateRenderQuery(RQT_AbsoluteTime);
+        }
+        AddTimestampPass(GraphBuilder, Timestamps[TimestampStart]);
+
         FRDGTextureDesc OutputDesc = FRDGTextureDesc::Create2D(FIntPoint(OutputWidth, OutputHeight), PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable);
         FRDGTextureRef OutputTexture = GraphBuilder.CreateTexture(OutputDesc, TEXT("OmniEquirectOutput"));
 
@@ -481,20 +430,27 @@ namespace
             1);
 
         FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("OmniCapture::Equirect"), ComputeShader, Parameters, GroupCount);
+        AddTimestampPass(GraphBuilder, Timestamps[TimestampEquirect]);
 
         FRDGTextureRef LumaTexture = nullptr;
         FRDGTextureRef ChromaTexture = nullptr;
         FRDGTextureRef BGRATexture = nullptr;
+        const EOmniCaptureStage PackStage = Settings.NVENCColorFormat == EOmniCaptureColorFormat::BGRA ? EOmniCaptureStage::GPUBGRA : EOmniCaptureStage::GPUYUV;
         if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
         {
+            if (GSupportsTimestampRenderQueries)
+            {
+                Timestamps[TimestampPacked] = RHICreateRenderQuery(RQT_AbsoluteTime);
+            }
             if (Settings.NVENCColorFormat == EOmniCaptureColorFormat::BGRA)
             {
-                BGRATexture = AddBGRAPackingPass(GraphBuilder, Settings, bUseLinear, OutputWidth, OutputHeight, OutputTexture);
+                BGRATexture = AddBGRAPackingPass(GraphBuilder, Settings, bUseLinear, OutputWidth, OutputHeight, OutputTexture, PlaneTargets);
             }
             else
             {
-                AddYUVConversionPasses(GraphBuilder, Settings, bUseLinear, OutputWidth, OutputHeight, OutputTexture, LumaTexture, ChromaTexture);
+                AddYUVConversionPasses(GraphBuilder, Settings, bUseLinear, OutputWidth, OutputHeight, OutputTexture, PlaneTargets, LumaTexture, ChromaTexture);
             }
+            AddTimestampPass(GraphBuilder, Timestamps[TimestampPacked]);
         }
 
         TRefCountPtr<IPooledRenderTarget> ExtractedOutput;
@@ -516,6 +472,21 @@ namespace
         }
         GraphBuilder.Execute();
 
+        if (PlaneTargets)
+        {
+            // Keep whatever was used this frame so the next frame on this slot writes in place.
+            PlaneTargets->Reset();
+            if (ExtractedBGRA.IsValid())
+            {
+                PlaneTargets->Add(ExtractedBGRA);
+            }
+            else if (ExtractedLuma.IsValid() && ExtractedChroma.IsValid())
+            {
+                PlaneTargets->Add(ExtractedLuma);
+                PlaneTargets->Add(ExtractedChroma);
+            }
+        }
+
         if (!ExtractedOutput.IsValid())
         {
             return;
@@ -564,10 +535,13 @@ namespace
             return;
         }
 
+        OMNICAPTURE_STAGE_SCOPE(Readback);
+
         FRHIGPUTextureReadback Readback(TEXT("OmniEquirectReadback"));
         Readback.EnqueueCopy(RHICmdList, OutputTextureRHI, FIntRect(0, 0, OutputWidth, OutputHeight));
         RHICmdList.SubmitCommandsAndFlushGPU();
         Readback.WaitCompletion();
+        RecordGPUTimestamps(Timestamps, PackStage);
 
         const uint32 PixelCount = OutputWidth * OutputHeight;
         const uint32 BytesPerPixel = sizeof(FFloat16Color);
@@ -612,27 +586,40 @@ namespace
 
         Readback.Unlock();
     }
+
+    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTexture2DRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTexture2DRHIRef, TInlineAllocator<6>> RightFaces, TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets, FOmniCaptureEquirectResult& OutResult)
+    {
+        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+
+        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+        FRDGBuilder GraphBuilder(RHICmdList);
+
+        FRDGTextureRef LeftArray = BuildFaceArray(GraphBuilder, LeftFaces, Settings.Resolution, TEXT("OmniLeftFaces"));
+        FRDGTextureRef RightArray = bStereo ? BuildFaceArray(GraphBuilder, RightFaces, Settings.Resolution, TEXT("OmniRightFaces")) : LeftArray;
+
+        ConvertFaceArrays(RHICmdList, GraphBuilder, Settings, LeftArray, RightArray, PlaneTargets, OutResult);
+    }
+
+    void ConvertAccumulatedOnRenderThread(const FOmniCaptureSettings Settings, const FOmniCaptureSubframeAccumulator& Accumulator, TArray<TRefCountPtr<IPooledRenderTarget>>* PlaneTargets, FOmniCaptureEquirectResult& OutResult)
+    {
+        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+        const TRefCountPtr<IPooledRenderTarget>& LeftTarget = Accumulator.GetFaceArray(EOmniCaptureEye::Left);
+        const TRefCountPtr<IPooledRenderTarget>& RightTarget = Accumulator.GetFaceArray(EOmniCaptureEye::Right);
+
+        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+        FRDGBuilder GraphBuilder(RHICmdList);
+
+        FRDGTextureRef LeftArray = LeftTarget.IsValid() ? GraphBuilder.RegisterExternalTexture(LeftTarget) : nullptr;
+        FRDGTextureRef RightArray = bStereo && RightTarget.IsValid() ? GraphBuilder.RegisterExternalTexture(RightTarget) : LeftArray;
+
+        ConvertFaceArrays(RHICmdList, GraphBuilder, Settings, LeftArray, RightArray, PlaneTargets, OutResult);
+    }
 }
 
 namespace
 {
-    void ConvertOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+    void ConvertCubemapsOnCPU(const FOmniCaptureSettings& Settings, const FCPUCubemap& LeftCubemap, const FCPUCubemap& RightCubemap, FOmniCaptureEquirectResult& OutResult)
     {
-        FCPUCubemap LeftCubemap;
-        if (!BuildCPUCubemap(LeftEye, LeftCubemap))
-        {
-            return;
-        }
-
-        FCPUCubemap RightCubemap;
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
-        {
-            if (!BuildCPUCubemap(RightEye, RightCubemap))
-            {
-                return;
-            }
-        }
-
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
         const bool bSideBySide = Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
         const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
@@ -680,9 +667,9 @@ namespace
                         }
                     }
 
-                    float Latitude = 0.0f;
-                    FVector Direction = DirectionFromEquirectPixelCPU(EyePixel, EyeResolution, Latitude);
-                    ApplyPolarMitigation(Settings.PolarDampening, Latitude, Direction);
+                    double Latitude = 0.0;
+                    OmniCaptureProjection::FDirection Direction = OmniCaptureProjection::DirectionFromEquirectPixel(EyePixel.X, EyePixel.Y, EyeResolution.X, EyeResolution.Y, Latitude);
+                    OmniCaptureProjection::ApplyPolarMitigation(Settings.PolarDampening, Latitude, Direction);
 
                     const FLinearColor LinearColor = SampleCubemapCPU(
                         (bStereo && bRightEye) ? RightCubemap : LeftCubemap,
@@ -711,9 +698,52 @@ namespace
             OutResult.PixelData = MoveTemp(PixelData);
         }
     }
+
+    void ConvertOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+    {
+        FCPUCubemap LeftCubemap;
+        if (!BuildCPUCubemap(LeftEye, LeftCubemap))
+        {
+            return;
+        }
+
+        FCPUCubemap RightCubemap;
+        if (Settings.Mode == EOmniCaptureMode::Stereo)
+        {
+            if (!BuildCPUCubemap(RightEye, RightCubemap))
+            {
+                return;
+            }
+        }
+
+        ConvertCubemapsOnCPU(Settings, LeftCubemap, RightCubemap, OutResult);
+    }
+
+    bool BuildAccumulatedCubemap(const FOmniCaptureSubframeAccumulator& Accumulator, EOmniCaptureEye Eye, FCPUCubemap& OutCubemap)
+    {
+        const int32 Resolution = Accumulator.GetFaceResolution();
+        for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+        {
+            const TArray<FLinearColor>& Source = Accumulator.GetCPUFace(Eye, FaceIndex);
+            if (Source.Num() != Resolution * Resolution)
+            {
+                return false;
+            }
+
+            FCPUFaceData& Face = OutCubemap.Faces[FaceIndex];
+            Face.Resolution = Resolution;
+            Face.Pixels.SetNumUninitialized(Source.Num());
+            for (int32 Index = 0; Index < Source.Num(); ++Index)
+            {
+                Face.Pixels[Index] = FFloat16Color(Source[Index]);
+            }
+        }
+
+        return OutCubemap.IsValid();
+    }
 }
 
-FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TArray<TRefCountPtr<IPooledRenderTarget>>* EncoderPlaneTargets)
 {
     FOmniCaptureEquirectResult Result;
 
@@ -766,9 +796,9 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangul
 
     FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
 
-    ENQUEUE_RENDER_COMMAND(OmniCaptureEquirect)([Settings, LeftFaces, RightFaces, &Result, CompletionEvent](FRHICommandListImmediate&)
+    ENQUEUE_RENDER_COMMAND(OmniCaptureEquirect)([Settings, LeftFaces, RightFaces, EncoderPlaneTargets, &Result, CompletionEvent](FRHICommandListImmediate&)
     {
-        ConvertOnRenderThread(Settings, LeftFaces, RightFaces, Result);
+        ConvertOnRenderThread(Settings, LeftFaces, RightFaces, EncoderPlaneTargets, Result);
         CompletionEvent->Trigger();
     });
 
@@ -782,3 +812,56 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangul
 
     return Result;
 }
+
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertCPUCubemaps(const FOmniCaptureSettings& Settings, const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap)
+{
+    FOmniCaptureEquirectResult Result;
+    if (!LeftCubemap.IsValid() || (Settings.Mode == EOmniCaptureMode::Stereo && !RightCubemap.IsValid()))
+    {
+        return Result;
+    }
+
+    ConvertCubemapsOnCPU(Settings, LeftCubemap, RightCubemap, Result);
+    return Result;
+}
+
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertAccumulated(const FOmniCaptureSettings& Settings, const FOmniCaptureSubframeAccumulator& Accumulator, TArray<TRefCountPtr<IPooledRenderTarget>>* EncoderPlaneTargets)
+{
+    FOmniCaptureEquirectResult Result;
+
+    if (Settings.Resolution <= 0 || !Accumulator.IsComplete() || Accumulator.GetFaceResolution() != Settings.Resolution)
+    {
+        return Result;
+    }
+
+    if (!Accumulator.UsesGPU())
+    {
+        FCPUCubemap LeftCubemap;
+        FCPUCubemap RightCubemap;
+        if (!BuildAccumulatedCubemap(Accumulator, EOmniCaptureEye::Left, LeftCubemap))
+        {
+            return Result;
+        }
+
+        if (Settings.Mode == EOmniCaptureMode::Stereo && !BuildAccumulatedCubemap(Accumulator, EOmniCaptureEye::Right, RightCubemap))
+        {
+            return Result;
+        }
+
+        ConvertCubemapsOnCPU(Settings, LeftCubemap, RightCubemap, Result);
+        return Result;
+    }
+
+    FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
+
+    ENQUEUE_RENDER_COMMAND(OmniCaptureEquirectAccumulated)([Settings, &Accumulator, EncoderPlaneTargets, &Result, CompletionEvent](FRHICommandListImmediate&)
+    {
+        ConvertAccumulatedOnRenderThread(Settings, Accumulator, EncoderPlaneTargets, Result);
+        CompletionEvent->Trigger();
+    });
+
+    CompletionEvent->Wait();
+    FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+
+    return Result;
+}
@@ -0,0 +1,126 @@
+#include "OmniCaptureFFmpegPipe.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/UnrealMathUtility.h"
+
+FOmniCaptureFFmpegPipe::FOmniCaptureFFmpegPipe()
+{
+    WriteStartCycles = 0;
+    BytesWritten = 0;
+}
+
+FOmniCaptureFFmpegPipe::~FOmniCaptureFFmpegPipe()
+{
+    Close(5.0);
+}
+
+bool FOmniCaptureFFmpegPipe::Open(const FString& Binary, const FString& Arguments, const FString& WorkingDirectory)
+{
+    Close(5.0);
+
+    if (!FPlatformProcess::CreatePipe(StdinRead, StdinWrite, true))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to create FFmpeg stdin pipe."));
+        StdinRead = nullptr;
+        StdinWrite = nullptr;
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Launching FFmpeg pipe: %s %s"), *Binary, *Arguments);
+
+    ProcHandle = FPlatformProcess::CreateProc(*Binary, *Arguments, false, true, true, nullptr, 0, *WorkingDirectory, nullptr, StdinRead);
+
+    FPlatformProcess::ClosePipe(StdinRead, nullptr);
+    StdinRead = nullptr;
+
+    if (!ProcHandle.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to launch FFmpeg process %s"), *Binary);
+        FPlatformProcess::ClosePipe(nullptr, StdinWrite);
+        StdinWrite = nullptr;
+        return false;
+    }
+
+    BytesWritten = 0;
+    WriteStartCycles = 0;
+    bBroken = false;
+    return true;
+}
+
+bool FOmniCaptureFFmpegPipe::Write(const void* Data, int64 NumBytes)
+{
+    if (!StdinWrite || bBroken || !Data)
+    {
+        return false;
+    }
+
+    const uint8* Cursor = static_cast<const uint8*>(Data);
+    int64 Remaining = NumBytes;
+
+    WriteStartCycles = FPlatformTime::Cycles64();
+    while (Remaining > 0)
+    {
+        const int32 ChunkSize = static_cast<int32>(FMath::Min<int64>(Remaining, 4 * 1024 * 1024));
+        int32 Written = 0;
+        if (!FPlatformProcess::WritePipe(StdinWrite, Cursor, ChunkSize, &Written) || Written <= 0)
+        {
+            if (!FPlatformProcess::IsProcRunning(ProcHandle))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("FFmpeg pipe closed unexpectedly."));
+                bBroken = true;
+                break;
+            }
+            FPlatformProcess::Sleep(0.001f);
+            continue;
+        }
+
+        Cursor += Written;
+        Remaining -= Written;
+        BytesWritten.AddExchange(static_cast<uint64>(Written));
+    }
+    WriteStartCycles = 0;
+
+    return Remaining == 0;
+}
+
+bool FOmniCaptureFFmpegPipe::IsStalled(double ThresholdSeconds) const
+{
+    const uint64 StartCycles = WriteStartCycles.Load();
+    if (StartCycles == 0)
+    {
+        return false;
+    }
+
+    return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) > ThresholdSeconds;
+}
+
+int32 FOmniCaptureFFmpegPipe::Close(double TimeoutSeconds)
+{
+    if (StdinWrite)
+    {
+        FPlatformProcess::ClosePipe(nullptr, StdinWrite);
+        StdinWrite = nullptr;
+    }
+
+    if (!ProcHandle.IsValid())
+    {
+        return -1;
+    }
+
+    const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+    while (FPlatformProcess::IsProcRunning(ProcHandle))
+    {
+        if (FPlatformTime::Seconds() > Deadline)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FFmpeg did not exit within %.0fs; terminating."), TimeoutSeconds);
+            FPlatformProcess::TerminateProc(ProcHandle, true);
+            break;
+        }
+        FPlatformProcess::Sleep(0.01f);
+    }
+
+    int32 ReturnCode = -1;
+    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
+    FPlatformProcess::CloseProc(ProcHandle);
+    return ReturnCode;
+}
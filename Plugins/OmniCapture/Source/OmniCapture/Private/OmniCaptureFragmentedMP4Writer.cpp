@@ -0,0 +1,810 @@
+#include "OmniCaptureFragmentedMP4Writer.h"
+
+#include "OmniCaptureBitstreamWriter.h"
+
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureFMP4, Log, All);
+
+namespace
+{
+    // Fragments are small enough that the sink never has to hold back a whole GOP; the final
+    // flush happens on Close.
+    constexpr int64 FMP4FlushThreshold = 1024 * 1024;
+    constexpr int64 FMP4WriteAlignment = 64 * 1024;
+
+    constexpr uint32 SampleFlagsKeyFrame = 0x02000000;
+    constexpr uint32 SampleFlagsNonKeyFrame = 0x01010000;
+
+    class FBoxWriter
+    {
+    public:
+        explicit FBoxWriter(TArray<uint8>& InOut)
+            : Out(InOut)
+        {
+        }
+
+        void U8(uint8 Value) { Out.Add(Value); }
+        void U16(uint16 Value) { U8(Value >> 8); U8(Value & 0xFF); }
+        void U32(uint32 Value) { U16(Value >> 16); U16(Value & 0xFFFF); }
+        void U64(uint64 Value) { U32(static_cast<uint32>(Value >> 32)); U32(static_cast<uint32>(Value)); }
+        void Zeros(int32 Count) { Out.AddZeroed(Count); }
+        void Bytes(const TArray<uint8>& Data) { Out.Append(Data); }
+        void FourCC(const char* Code) { Out.Append(reinterpret_cast<const uint8*>(Code), 4); }
+
+        int32 Begin(const char* Type)
+        {
+            const int32 Start = Out.Num();
+            U32(0);
+            FourCC(Type);
+            return Start;
+        }
+
+        int32 BeginFull(const char* Type, uint8 Version, uint32 Flags)
+        {
+            const int32 Start = Begin(Type);
+            U32((static_cast<uint32>(Version) << 24) | (Flags & 0xFFFFFF));
+            return Start;
+        }
+
+        void End(int32 Start)
+        {
+            const uint32 Size = static_cast<uint32>(Out.Num() - Start);
+            Out[Start + 0] = static_cast<uint8>(Size >> 24);
+            Out[Start + 1] = static_cast<uint8>(Size >> 16);
+            Out[Start + 2] = static_cast<uint8>(Size >> 8);
+            Out[Start + 3] = static_cast<uint8>(Size);
+        }
+
+        void Matrix()
+        {
+            static const uint32 Identity[9] = { 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000 };
+            for (uint32 Value : Identity)
+            {
+                U32(Value);
+            }
+        }
+
+        TArray<uint8>& Out;
+    };
+
+    enum class ENalRole : uint8
+    {
+        Slice,
+        KeySlice,
+        VPS,
+        SPS,
+        PPS,
+        Skip
+    };
+
+    ENalRole ClassifyNal(EOmniCaptureCodec Codec, uint8 Header)
+    {
+        if (Codec == EOmniCaptureCodec::HEVC)
+        {
+            const uint8 Type = (Header >> 1) & 0x3F;
+            switch (Type)
+            {
+            case 32: return ENalRole::VPS;
+            case 33: return ENalRole::SPS;
+            case 34: return ENalRole::PPS;
+            case 35: return ENalRole::Skip; // Access unit delimiter
+            default:
+                // BLA/IDR/CRA are all random access points.
+                return (Type >= 16 && Type <= 21) ? ENalRole::KeySlice : ENalRole::Slice;
+            }
+        }
+
+        const uint8 Type = Header & 0x1F;
+        switch (Type)
+        {
+        case 5: return ENalRole::KeySlice;
+        case 7: return ENalRole::SPS;
+        case 8: return ENalRole::PPS;
+        case 9: return ENalRole::Skip;
+        default: return ENalRole::Slice;
+        }
+    }
+
+    // Calls Visitor(Data, Size) for every NAL unit between Annex B start codes.
+    template <typename VisitorType>
+    void ForEachNal(const uint8* Data, int64 Size, VisitorType&& Visitor)
+    {
+        int64 NalStart = -1;
+        int64 Index = 0;
+        while (Index + 2 < Size)
+        {
+            if (Data[Index] == 0 && Data[Index + 1] == 0 && Data[Index + 2] == 1)
+            {
+                if (NalStart >= 0)
+                {
+                    int64 NalEnd = Index;
+                    while (NalEnd > NalStart && Data[NalEnd - 1] == 0)
+                    {
+                        --NalEnd;
+                    }
+                    if (NalEnd > NalStart)
+                    {
+                        Visitor(Data + NalStart, NalEnd - NalStart);
+                    }
+                }
+                Index += 3;
+                NalStart = Index;
+                continue;
+            }
+            ++Index;
+        }
+
+        if (NalStart >= 0 && NalStart < Size)
+        {
+            Visitor(Data + NalStart, Size - NalStart);
+        }
+    }
+
+    // Strips emulation prevention bytes; only the fixed-position fields near the start are read.
+    TArray<uint8> ToRBSP(const TArray<uint8>& Nal, int32 MaxBytes)
+    {
+        TArray<uint8> Result;
+        Result.Reserve(MaxBytes);
+        int32 Zeros = 0;
+        for (int32 Index = 0; Index < Nal.Num() && Result.Num() < MaxBytes; ++Index)
+        {
+            const uint8 Byte = Nal[Index];
+            if (Zeros >= 2 && Byte == 0x03)
+            {
+                Zeros = 0;
+                continue;
+            }
+            Zeros = Byte == 0 ? Zeros + 1 : 0;
+            Result.Add(Byte);
+        }
+        return Result;
+    }
+
+    void WriteParameterSetArray(FBoxWriter& Box, uint8 NalType, const TArray<uint8>& Nal)
+    {
+        Box.U8(0x80 | NalType); // array_completeness = 1
+        Box.U16(1);
+        Box.U16(static_cast<uint16>(Nal.Num()));
+        Box.Bytes(Nal);
+    }
+}
+
+FOmniCaptureFragmentedMP4Writer::FOmniCaptureFragmentedMP4Writer()
+{
+}
+
+FOmniCaptureFragmentedMP4Writer::~FOmniCaptureFragmentedMP4Writer()
+{
+    Close();
+}
+
+bool FOmniCaptureFragmentedMP4Writer::Open(const FString& InFilePath, const FOmniCaptureFMP4Config& InConfig)
+{
+    if (Sink)
+    {
+        return false;
+    }
+
+    Sink = MakeUnique<FOmniCaptureBitstreamWriter>();
+    if (!Sink->Open(InFilePath, FMP4FlushThreshold, FMP4WriteAlignment))
+    {
+        Sink.Reset();
+        return false;
+    }
+
+    Config = InConfig;
+    VPS.Reset();
+    SPS.Reset();
+    PPS.Reset();
+    bInitWritten = false;
+    FragmentData.Reset();
+    FragmentSamples.Reset();
+    LastSampleDuration = FMath::Max<int64>(1, FMath::RoundToInt64(Timescale / FMath::Max(1.0, Config.FrameRate)));
+    FragmentSequence = 0;
+    SamplesWritten = 0;
+    DroppedSamples = 0;
+    LastStats = FOmniCaptureBitstreamStats();
+    return true;
+}
+
+void FOmniCaptureFragmentedMP4Writer::Close()
+{
+    if (!Sink)
+    {
+        return;
+    }
+
+    if (FragmentSamples.Num() > 0)
+    {
+        FlushFragment(INDEX_NONE);
+    }
+
+    LastStats = Sink->GetStats();
+    Sink->Close();
+    Sink.Reset();
+
+    UE_LOG(LogOmniCaptureFMP4, Log, TEXT("Fragmented MP4 closed: %lld samples in %d fragments (%d dropped before first keyframe)."), SamplesWritten, FragmentSequence, DroppedSamples);
+}
+
+FOmniCaptureBitstreamStats FOmniCaptureFragmentedMP4Writer::GetStats() const
+{
+    return Sink ? Sink->GetStats() : LastStats;
+}
+
+bool FOmniCaptureFragmentedMP4Writer::WriteSample(const uint8* AnnexBData, int64 Size, double PresentationSeconds)
+{
+    if (!Sink || !AnnexBData || Size <= 0)
+    {
+        return false;
+    }
+
+    // Parameter sets move into the sample entry; everything else is rewritten with 4-byte lengths.
+    const int32 SampleOffset = FragmentData.Num();
+    bool bKeyFrame = false;
+    ForEachNal(AnnexBData, Size, [this, &bKeyFrame](const uint8* Nal, int64 NalSize)
+    {
+        switch (ClassifyNal(Config.Codec, Nal[0]))
+        {
+        case ENalRole::VPS:
+            VPS = TArray<uint8>(Nal, static_cast<int32>(NalSize));
+            return;
+        case ENalRole::SPS:
+            SPS = TArray<uint8>(Nal, static_cast<int32>(NalSize));
+            return;
+        case ENalRole::PPS:
+            PPS = TArray<uint8>(Nal, static_cast<int32>(NalSize));
+            return;
+        case ENalRole::Skip:
+            return;
+        case ENalRole::KeySlice:
+            bKeyFrame = true;
+            break;
+        default:
+            break;
+        }
+
+        FBoxWriter Writer(FragmentData);
+        Writer.U32(static_cast<uint32>(NalSize));
+        FragmentData.Append(Nal, static_cast<int32>(NalSize));
+    });
+
+    const int32 SampleSize = FragmentData.Num() - SampleOffset;
+    const bool bHaveParameterSets = SPS.Num() > 0 && PPS.Num() > 0 && (Config.Codec != EOmniCaptureCodec::HEVC || VPS.Num() > 0);
+    if (SampleSize <= 0 || (!bInitWritten && (!bKeyFrame || !bHaveParameterSets)))
+    {
+        // Nothing before the first keyframe can be decoded, so it never reaches the file.
+        FragmentData.SetNum(SampleOffset, EAllowShrinking::No);
+        ++DroppedSamples;
+        return false;
+    }
+
+    const int64 PresentationTime = FMath::RoundToInt64(PresentationSeconds * Timescale);
+    if (bKeyFrame && FragmentSamples.Num() > 0)
+    {
+        // Move the new sample's bytes aside while the previous GOP goes out.
+        TArray<uint8> Pending(FragmentData.GetData() + SampleOffset, SampleSize);
+        FragmentData.SetNum(SampleOffset, EAllowShrinking::No);
+        FlushFragment(PresentationTime);
+        FragmentData.Append(Pending);
+    }
+
+    if (!bInitWritten)
+    {
+        WriteInitSegment();
+    }
+
+    FPendingSample& Sample = FragmentSamples.AddDefaulted_GetRef();
+    Sample.Offset = FragmentData.Num() - SampleSize;
+    Sample.Size = SampleSize;
+    Sample.PresentationTime = PresentationTime;
+    Sample.bKeyFrame = bKeyFrame;
+    ++SamplesWritten;
+    return true;
+}
+
+void FOmniCaptureFragmentedMP4Writer::WriteInitSegment()
+{
+    BoxScratch.Reset();
+    FBoxWriter Box(BoxScratch);
+
+    const int32 Ftyp = Box.Begin("ftyp");
+    Box.FourCC("isom");
+    Box.U32(0x200);
+    Box.FourCC("isom");
+    Box.FourCC("iso6");
+    Box.FourCC("mp41");
+    Box.End(Ftyp);
+
+    const int32 Moov = Box.Begin("moov");
+    {
+        // Durations are zero: the length of a fragmented file is the sum of its fragments.
+        const int32 Mvhd = Box.BeginFull("mvhd", 0, 0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(Timescale);
+        Box.U32(0);
+        Box.U32(0x00010000);
+        Box.U16(0x0100);
+        Box.Zeros(2 + 8);
+        Box.Matrix();
+        Box.Zeros(24);
+        Box.U32(2);
+        Box.End(Mvhd);
+
+        const int32 Trak = Box.Begin("trak");
+        {
+            const int32 Tkhd = Box.BeginFull("tkhd", 0, 0x3);
+            Box.U32(0);
+            Box.U32(0);
+            Box.U32(1);
+            Box.U32(0);
+            Box.U32(0);
+            Box.Zeros(8);
+            Box.U16(0);
+            Box.U16(0);
+            Box.U16(0);
+            Box.U16(0);
+            Box.Matrix();
+            Box.U32(static_cast<uint32>(Config.Width) << 16);
+            Box.U32(static_cast<uint32>(Config.Height) << 16);
+            Box.End(Tkhd);
+
+            const int32 Mdia = Box.Begin("mdia");
+            {
+                const int32 Mdhd = Box.BeginFull("mdhd", 0, 0);
+                Box.U32(0);
+                Box.U32(0);
+                Box.U32(Timescale);
+                Box.U32(0);
+                Box.U16(0x55C4); // "und"
+                Box.U16(0);
+                Box.End(Mdhd);
+
+                const int32 Hdlr = Box.BeginFull("hdlr", 0, 0);
+                Box.U32(0);
+                Box.FourCC("vide");
+                Box.Zeros(12);
+                Box.Out.Append(reinterpret_cast<const uint8*>("OmniCapture Video"), 18);
+                Box.End(Hdlr);
+
+                const int32 Minf = Box.Begin("minf");
+                {
+                    const int32 Vmhd = Box.BeginFull("vmhd", 0, 1);
+                    Box.Zeros(8);
+                    Box.End(Vmhd);
+
+                    const int32 Dinf = Box.Begin("dinf");
+                    const int32 Dref = Box.BeginFull("dref", 0, 0);
+                    Box.U32(1);
+                    Box.End(Box.BeginFull("url ", 0, 1));
+                    Box.End(Dref);
+                    Box.End(Dinf);
+
+                    const int32 Stbl = Box.Begin("stbl");
+                    {
+                        const int32 Stsd = Box.BeginFull("stsd", 0, 0);
+                        Box.U32(1);
+                        BuildSampleEntry(BoxScratch);
+                        Box.End(Stsd);
+
+                        // Sample tables stay empty; every sample is described by a trun.
+                        const int32 Stts = Box.BeginFull("stts", 0, 0);
+                        Box.U32(0);
+                        Box.End(Stts);
+                        const int32 Stsc = Box.BeginFull("stsc", 0, 0);
+                        Box.U32(0);
+                        Box.End(Stsc);
+                        const int32 Stsz = Box.BeginFull("stsz", 0, 0);
+                        Box.U32(0);
+                        Box.U32(0);
+                        Box.End(Stsz);
+                        const int32 Stco = Box.BeginFull("stco", 0, 0);
+                        Box.U32(0);
+                        Box.End(Stco);
+                    }
+                    Box.End(Stbl);
+                }
+                Box.End(Minf);
+            }
+            Box.End(Mdia);
+        }
+        Box.End(Trak);
+
+        const int32 Mvex = Box.Begin("mvex");
+        const int32 Trex = Box.BeginFull("trex", 0, 0);
+        Box.U32(1);
+        Box.U32(1);
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.End(Trex);
+        Box.End(Mvex);
+    }
+    Box.End(Moov);
+
+    Sink->AppendPacket(BoxScratch.GetData(), BoxScratch.Num());
+    bInitWritten = true;
+}
+
+void FOmniCaptureFragmentedMP4Writer::BuildSampleEntry(TArray<uint8>& Out) const
+{
+    FBoxWriter Box(Out);
+    const bool bHEVC = Config.Codec == EOmniCaptureCodec::HEVC;
+    const uint8 BitDepthMinus8 = static_cast<uint8>(FMath::Clamp(Config.BitDepth - 8, 0, 7));
+
+    const int32 Entry = Box.Begin(bHEVC ? "hvc1" : "avc1");
+    Box.Zeros(6);
+    Box.U16(1);
+    Box.Zeros(16);
+    Box.U16(static_cast<uint16>(Config.Width));
+    Box.U16(static_cast<uint16>(Config.Height));
+    Box.U32(0x00480000);
+    Box.U32(0x00480000);
+    Box.U32(0);
+    Box.U16(1);
+    Box.Zeros(32);
+    Box.U16(0x0018);
+    Box.U16(0xFFFF);
+
+    if (bHEVC)
+    {
+        // general_profile_tier_level sits at a fixed offset after the 2-byte header and first SPS byte.
+        const TArray<uint8> SpsRbsp = ToRBSP(SPS, 15);
+        auto SpsByte = [&SpsRbsp](int32 Index) { return SpsRbsp.IsValidIndex(Index) ? SpsRbsp[Index] : uint8(0); };
+
+        const int32 HvcC = Box.Begin("hvcC");
+        Box.U8(1);
+        for (int32 Index = 3; Index < 15; ++Index)
+        {
+            Box.U8(SpsByte(Index));
+        }
+        Box.U16(0xF000);
+        Box.U8(0xFC);
+        Box.U8(0xFC | 1); // 4:2:0
+        Box.U8(0xF8 | BitDepthMinus8);
+        Box.U8(0xF8 | BitDepthMinus8);
+        Box.U16(0);
+        Box.U8((1 << 3) | (1 << 2) | 3); // one temporal layer, nested, 4-byte lengths
+        Box.U8(3);
+        WriteParameterSetArray(Box, 32, VPS);
+        WriteParameterSetArray(Box, 33, SPS);
+        WriteParameterSetArray(Box, 34, PPS);
+        Box.End(HvcC);
+    }
+    else
+    {
+        const uint8 Profile = SPS.IsValidIndex(1) ? SPS[1] : 0;
+        const int32 AvcC = Box.Begin("avcC");
+        Box.U8(1);
+        Box.U8(Profile);
+        Box.U8(SPS.IsValidIndex(2) ? SPS[2] : 0);
+        Box.U8(SPS.IsValidIndex(3) ? SPS[3] : 0);
+        Box.U8(0xFF);
+        Box.U8(0xE1);
+        Box.U16(static_cast<uint16>(SPS.Num()));
+        Box.Bytes(SPS);
+        Box.U8(1);
+        Box.U16(static_cast<uint16>(PPS.Num()));
+        Box.Bytes(PPS);
+        if (Profile == 100 || Profile == 110 || Profile == 122 || Profile == 144)
+        {
+            Box.U8(0xFC | 1);
+            Box.U8(0xF8 | BitDepthMinus8);
+            Box.U8(0xF8 | BitDepthMinus8);
+            Box.U8(0);
+        }
+        Box.End(AvcC);
+    }
+
+    uint8 Primaries = 1;
+    uint8 Transfer = 1;
+    uint8 MatrixCoefficients = 1;
+    if (Config.ColorSpace == EOmniCaptureColorSpace::BT2020)
+    {
+        Primaries = 9;
+        Transfer = 14;
+        MatrixCoefficients = 9;
+    }
+    else if (Config.ColorSpace == EOmniCaptureColorSpace::HDR10)
+    {
+        Primaries = 9;
+        Transfer = 16;
+        MatrixCoefficients = 9;
+    }
+
+    const int32 Colr = Box.Begin("colr");
+    Box.FourCC("nclx");
+    Box.U16(Primaries);
+    Box.U16(Transfer);
+    Box.U16(MatrixCoefficients);
+    Box.U8(0);
+    Box.End(Colr);
+
+    // Spherical Video V2: st3d for the frame packing, sv3d/proj/equi for the projection.
+    const int32 St3d = Box.BeginFull("st3d", 0, 0);
+    uint8 StereoMode = 0;
+    if (Config.Mode == EOmniCaptureMode::Stereo)
+    {
+        StereoMode = Config.StereoLayout == EOmniCaptureStereoLayout::SideBySide ? 2 : 1;
+    }
+    Box.U8(StereoMode);
+    Box.End(St3d);
+
+    const int32 Sv3d = Box.Begin("sv3d");
+    {
+        const int32 Svhd = Box.BeginFull("svhd", 0, 0);
+        Box.Out.Append(reinterpret_cast<const uint8*>("OmniCapture"), 12);
+        Box.End(Svhd);
+
+        const int32 Proj = Box.Begin("proj");
+        const int32 Prhd = Box.BeginFull("prhd", 0, 0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.End(Prhd);
+        const int32 Equi = Box.BeginFull("equi", 0, 0);
+        Box.Zeros(16);
+        Box.End(Equi);
+        Box.End(Proj);
+    }
+    Box.End(Sv3d);
+
+    Box.End(Entry);
+}
+
+void FOmniCaptureFragmentedMP4Writer::FlushFragment(int64 NextDecodeTime)
+{
+    const int32 SampleCount = FragmentSamples.Num();
+    if (SampleCount == 0)
+    {
+        return;
+    }
+
+    // Samples arrive in decode order. Each GOP is closed, so its decode times are its own
+    // presentation times sorted; the difference is the composition offset.
+    TArray<int64, TInlineAllocator<64>> DecodeTimes;
+    DecodeTimes.Reserve(SampleCount);
+    for (const FPendingSample& Sample : FragmentSamples)
+    {
+        DecodeTimes.Add(Sample.PresentationTime);
+    }
+    DecodeTimes.Sort();
+
+    BoxScratch.Reset();
+    FBoxWriter Box(BoxScratch);
+
+    const int32 Moof = Box.Begin("moof");
+    const int32 Mfhd = Box.BeginFull("mfhd", 0, 0);
+    Box.U32(static_cast<uint32>(++FragmentSequence));
+    Box.End(Mfhd);
+
+    const int32 Traf = Box.Begin("traf");
+    const int32 Tfhd = Box.BeginFull("tfhd", 0, 0x020000); // default-base-is-moof
+    Box.U32(1);
+    Box.End(Tfhd);
+
+    const int32 Tfdt = Box.BeginFull("tfdt", 1, 0);
+    Box.U64(static_cast<uint64>(FMath::Max<int64>(0, DecodeTimes[0])));
+    Box.End(Tfdt);
+
+    // data-offset, duration, size, flags and signed composition offset per sample.
+    const int32 Trun = Box.BeginFull("trun", 1, 0x000001 | 0x000100 | 0x000200 | 0x000400 | 0x000800);
+    Box.U32(static_cast<uint32>(SampleCount));
+    const int32 DataOffsetPosition = BoxScratch.Num();
+    Box.U32(0);
+    for (int32 Index = 0; Index < SampleCount; ++Index)
+    {
+        const FPendingSample& Sample = FragmentSamples[Index];
+        int64 Duration = 0;
+        if (Index + 1 < SampleCount)
+        {
+            Duration = DecodeTimes[Index + 1] - DecodeTimes[Index];
+        }
+        else if (NextDecodeTime != INDEX_NONE && NextDecodeTime > DecodeTimes[Index])
+        {
+            Duration = NextDecodeTime - DecodeTimes[Index];
+        }
+        else
+        {
+            Duration = LastSampleDuration;
+        }
+        LastSampleDuration = Duration > 0 ? Duration : LastSampleDuration;
+
+        Box.U32(static_cast<uint32>(FMath::Max<int64>(0, Duration)));
+        Box.U32(static_cast<uint32>(Sample.Size));
+        Box.U32(Sample.bKeyFrame ? SampleFlagsKeyFrame : SampleFlagsNonKeyFrame);
+        Box.U32(static_cast<uint32>(static_cast<int32>(Sample.PresentationTime - DecodeTimes[Index])));
+    }
+    Box.End(Trun);
+    Box.End(Traf);
+    Box.End(Moof);
+
+    // Offsets are from the start of moof to the first payload byte, past the mdat header.
+    const uint32 DataOffset = static_cast<uint32>(BoxScratch.Num() - Moof + 8);
+    BoxScratch[DataOffsetPosition + 0] = static_cast<uint8>(DataOffset >> 24);
+    BoxScratch[DataOffsetPosition + 1] = static_cast<uint8>(DataOffset >> 16);
+    BoxScratch[DataOffsetPosition + 2] = static_cast<uint8>(DataOffset >> 8);
+    BoxScratch[DataOffsetPosition + 3] = static_cast<uint8>(DataOffset);
+
+    Box.U32(static_cast<uint32>(FragmentData.Num() + 8));
+    Box.FourCC("mdat");
+
+    Sink->AppendPacket(BoxScratch.GetData(), BoxScratch.Num());
+    Sink->AppendPacket(FragmentData.GetData(), FragmentData.Num());
+
+    FragmentData.Reset();
+    FragmentSamples.Reset();
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    struct FTopLevelBox
+    {
+        FString Type;
+        int64 Offset = 0;
+        int64 Size = 0;
+    };
+
+    TArray<FTopLevelBox> ReadTopLevelBoxes(const TArray<uint8>& File)
+    {
+        TArray<FTopLevelBox> Boxes;
+        int64 Offset = 0;
+        while (Offset + 8 <= File.Num())
+        {
+            const int64 Size = (int64(File[Offset]) << 24) | (int64(File[Offset + 1]) << 16) | (int64(File[Offset + 2]) << 8) | int64(File[Offset + 3]);
+            if (Size < 8 || Offset + Size > File.Num())
+            {
+                break;
+            }
+
+            FTopLevelBox& Box = Boxes.AddDefaulted_GetRef();
+            Box.Type = FString(4, reinterpret_cast<const ANSICHAR*>(File.GetData() + Offset + 4));
+            Box.Offset = Offset;
+            Box.Size = Size;
+            Offset += Size;
+        }
+        return Boxes;
+    }
+
+    bool ContainsFourCC(const TArray<uint8>& File, const FTopLevelBox& Box, const char* Type)
+    {
+        for (int64 Index = Box.Offset + 8; Index + 4 <= Box.Offset + Box.Size; ++Index)
+        {
+            if (FMemory::Memcmp(File.GetData() + Index, Type, 4) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RunFragmentedMP4SelfTest(EOmniCaptureCodec Codec, FString& OutReport)
+    {
+        constexpr int32 NumFrames = 90;
+        constexpr int32 GOPLength = 30;
+        constexpr double FrameRate = 30.0;
+
+        // Canned parameter sets: enough for the sample entry, not for a real decoder.
+        const TArray<uint8> H264Headers = { 0, 0, 0, 1, 0x67, 0x64, 0x00, 0x33, 0xAC, 0xD9, 0x40, 0x78, 0x02, 0x27, 0xE5, 0x84, 0x00, 0x00, 0x03, 0x00, 0x04, 0x00, 0x00, 0x03, 0x00, 0xF0, 0x3C, 0x60, 0xC6, 0x58,
+                                            0, 0, 0, 1, 0x68, 0xEB, 0xE3, 0xCB, 0x22, 0xC0 };
+        const TArray<uint8> HEVCHeaders = { 0, 0, 0, 1, 0x40, 0x01, 0x0C, 0x01, 0xFF, 0xFF, 0x01, 0x60, 0x00, 0x00, 0x03, 0x00, 0x90, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x99, 0x95, 0x98, 0x09,
+                                            0, 0, 0, 1, 0x42, 0x01, 0x01, 0x01, 0x60, 0x00, 0x00, 0x03, 0x00, 0x90, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x99, 0xA0, 0x01, 0xE0, 0x20, 0x02, 0x1C, 0x59, 0x65, 0x66, 0x92, 0x4C, 0xAF,
+                                            0, 0, 0, 1, 0x44, 0x01, 0xC1, 0x72, 0xB4, 0x62, 0x40 };
+        const bool bHEVC = Codec == EOmniCaptureCodec::HEVC;
+
+        const FString TestPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("OmniCaptures") / (bHEVC ? TEXT("FragmentedMP4SelfTest_hevc.mp4") : TEXT("FragmentedMP4SelfTest_h264.mp4")));
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(TestPath), true);
+
+        FOmniCaptureFMP4Config Config;
+        Config.Codec = Codec;
+        Config.Width = 3840;
+        Config.Height = 3840;
+        Config.FrameRate = FrameRate;
+        Config.Mode = EOmniCaptureMode::Stereo;
+        Config.StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+
+        FOmniCaptureFragmentedMP4Writer Writer;
+        if (!Writer.Open(TestPath, Config))
+        {
+            OutReport = TEXT("could not open output");
+            return false;
+        }
+
+        // One B-frame: decode order I P B P B ..., presentation order I B P B P ...
+        FRandomStream Random(1234);
+        TArray<uint8> AccessUnit;
+        for (int32 DecodeIndex = 0; DecodeIndex < NumFrames; ++DecodeIndex)
+        {
+            const int32 GOPIndex = DecodeIndex % GOPLength;
+            const bool bKey = GOPIndex == 0;
+            int32 PresentationIndex = DecodeIndex;
+            if (!bKey && GOPIndex < GOPLength - 1)
+            {
+                PresentationIndex = (GOPIndex % 2) == 1 ? DecodeIndex + 1 : DecodeIndex - 1;
+            }
+
+            AccessUnit.Reset();
+            if (bKey)
+            {
+                AccessUnit.Append(bHEVC ? HEVCHeaders : H264Headers);
+            }
+            AccessUnit.Append({ 0, 0, 0, 1 });
+            if (bHEVC)
+            {
+                AccessUnit.Append({ static_cast<uint8>((bKey ? 19 : 1) << 1), 0x01 });
+            }
+            else
+            {
+                AccessUnit.Add(bKey ? 0x65 : 0x41);
+            }
+
+            const int32 PayloadSize = bKey ? 8192 : 1024;
+            for (int32 Index = 0; Index < PayloadSize; ++Index)
+            {
+                // Keep the payload free of start codes.
+                AccessUnit.Add(static_cast<uint8>(1 + Random.RandHelper(255)));
+            }
+
+            Writer.WriteSample(AccessUnit.GetData(), AccessUnit.Num(), PresentationIndex / FrameRate);
+        }
+        Writer.Close();
+
+        TArray<uint8> File;
+        const bool bLoaded = FFileHelper::LoadFileToArray(File, *TestPath);
+        IFileManager::Get().Delete(*TestPath);
+        if (!bLoaded)
+        {
+            OutReport = TEXT("output missing");
+            return false;
+        }
+
+        const TArray<FTopLevelBox> Boxes = ReadTopLevelBoxes(File);
+        const int32 ExpectedFragments = NumFrames / GOPLength;
+        bool bOrderValid = Boxes.Num() == 2 + ExpectedFragments * 2 && Boxes[0].Type == TEXT("ftyp") && Boxes[1].Type == TEXT("moov");
+        int64 BoxedBytes = 0;
+        for (int32 Index = 0; Index < Boxes.Num(); ++Index)
+        {
+            BoxedBytes += Boxes[Index].Size;
+            if (Index >= 2)
+            {
+                bOrderValid &= Boxes[Index].Type == ((Index % 2) == 0 ? TEXT("moof") : TEXT("mdat"));
+            }
+        }
+
+        const bool bMetadata = Boxes.Num() > 1
+            && ContainsFourCC(File, Boxes[1], bHEVC ? "hvcC" : "avcC")
+            && ContainsFourCC(File, Boxes[1], "st3d")
+            && ContainsFourCC(File, Boxes[1], "sv3d")
+            && ContainsFourCC(File, Boxes[1], "equi");
+
+        OutReport = FString::Printf(TEXT("%d boxes, %lld samples, %d fragments, layout %s, metadata %s, %lld/%d bytes boxed"),
+            Boxes.Num(), Writer.GetSampleCount(), Writer.GetFragmentCount(), bOrderValid ? TEXT("ok") : TEXT("BAD"), bMetadata ? TEXT("ok") : TEXT("MISSING"), BoxedBytes, File.Num());
+        return bOrderValid && bMetadata && BoxedBytes == File.Num() && Writer.GetSampleCount() == NumFrames && Writer.GetFragmentCount() == ExpectedFragments;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFragmentedMP4Test, "OmniCapture.NVENC.FragmentedMP4",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureFragmentedMP4Test::RunTest(const FString& Parameters)
+{
+    for (EOmniCaptureCodec Codec : { EOmniCaptureCodec::H264, EOmniCaptureCodec::HEVC })
+    {
+        FString Report;
+        const bool bPassed = RunFragmentedMP4SelfTest(Codec, Report);
+        const TCHAR* CodecName = Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H.264");
+        TestTrue(FString::Printf(TEXT("%s fragmented MP4 layout"), CodecName), bPassed);
+        AddInfo(FString::Printf(TEXT("%s: %s"), CodecName, *Report));
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
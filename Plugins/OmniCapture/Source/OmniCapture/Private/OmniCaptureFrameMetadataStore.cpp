@@ -0,0 +1,259 @@
+#include "OmniCaptureFrameMetadataStore.h"
+
+#include "HAL/FileManager.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+
+double FOmniCaptureFrameTimingStats::GetFrameRate() const
+{
+    if (FrameCount < 2)
+    {
+        return 30.0;
+    }
+
+    const double Duration = LastTimecode - FirstTimecode;
+    if (Duration <= 0.0)
+    {
+        return 30.0;
+    }
+
+    return static_cast<double>(FrameCount - 1) / Duration;
+}
+
+double FOmniCaptureFrameTimingStats::GetJitterMilliseconds() const
+{
+    const int32 IntervalCount = FrameCount - 1;
+    if (IntervalCount < 2)
+    {
+        return 0.0;
+    }
+
+    return FMath::Sqrt(IntervalM2 / (IntervalCount - 1)) * 1000.0;
+}
+
+FOmniCaptureFrameMetadataStore::FOmniCaptureFrameMetadataStore()
+{
+}
+
+FOmniCaptureFrameMetadataStore::~FOmniCaptureFrameMetadataStore()
+{
+    FScopeLock Lock(&StoreCS);
+    CloseSpillFile();
+}
+
+void FOmniCaptureFrameMetadataStore::Reset(const FString& InSpillFilePath, int32 InMaxResidentChunks)
+{
+    FScopeLock Lock(&StoreCS);
+    CloseSpillFile();
+
+    ResidentChunks.Empty();
+    FirstKeyFrameIndex = INDEX_NONE;
+    ResidentBytes = 0;
+    Stats = FOmniCaptureFrameTimingStats();
+    SpilledChunkCount = 0;
+    LastFrameIndex = INDEX_NONE;
+    LastTimecodeUs = 0;
+
+    SpillFilePath = InSpillFilePath;
+    MaxResidentChunks = FMath::Max(1, InMaxResidentChunks);
+}
+
+void FOmniCaptureFrameMetadataStore::StartChunk(int32 FrameIndex, int64 TimecodeUs)
+{
+    FChunk& Chunk = ResidentChunks.AddDefaulted_GetRef();
+    Chunk.FirstFrameIndex = FrameIndex;
+    Chunk.FirstTimecodeUs = TimecodeUs;
+    Chunk.FrameIndexDeltas.Reserve(ChunkCapacity);
+    Chunk.TimecodeDeltasUs.Reserve(ChunkCapacity);
+    Chunk.KeyFrameBits.Reserve(ChunkCapacity / 8);
+
+    if (ResidentChunks.Num() > MaxResidentChunks + 1 && !SpillFilePath.IsEmpty())
+    {
+        SpillOldestChunk();
+    }
+
+    // Chunks are reserved up front, so allocations only change when a chunk starts or spills.
+    UpdateResidentBytes();
+}
+
+int32 FOmniCaptureFrameMetadataStore::Num() const
+{
+    FScopeLock Lock(&StoreCS);
+    return Stats.FrameCount;
+}
+
+FOmniCaptureFrameTimingStats FOmniCaptureFrameMetadataStore::GetStats() const
+{
+    FScopeLock Lock(&StoreCS);
+    return Stats;
+}
+
+void FOmniCaptureFrameMetadataStore::Add(const FOmniCaptureFrameMetadata& Metadata)
+{
+    FScopeLock Lock(&StoreCS);
+    const int64 TimecodeUs = FMath::RoundToInt64(Metadata.Timecode * 1000000.0);
+
+    if (Stats.FrameCount == 0)
+    {
+        Stats.FirstTimecode = Metadata.Timecode;
+    }
+    else
+    {
+        const double Interval = static_cast<double>(TimecodeUs - LastTimecodeUs) / 1000000.0;
+        const int32 IntervalCount = Stats.FrameCount;
+        const double Delta = Interval - Stats.MeanIntervalSeconds;
+        Stats.MeanIntervalSeconds += Delta / IntervalCount;
+        Stats.IntervalM2 += Delta * (Interval - Stats.MeanIntervalSeconds);
+        Stats.MaxIntervalSeconds = FMath::Max(Stats.MaxIntervalSeconds, Interval);
+        Stats.MissingFrames += FMath::Max(0, Metadata.FrameIndex - LastFrameIndex - 1);
+    }
+
+    const int64 FrameDelta = static_cast<int64>(Metadata.FrameIndex) - LastFrameIndex;
+    const int64 TimeDelta = TimecodeUs - LastTimecodeUs;
+    const bool bNeedsChunk = ResidentChunks.Num() == 0
+        || ResidentChunks.Last().TimecodeDeltasUs.Num() >= ChunkCapacity
+        || LastFrameIndex == INDEX_NONE
+        || FrameDelta < 0 || FrameDelta > MAX_uint16
+        || TimeDelta < 0 || TimeDelta > MAX_uint32;
+
+    if (bNeedsChunk)
+    {
+        StartChunk(Metadata.FrameIndex, TimecodeUs);
+    }
+
+    FChunk& Chunk = ResidentChunks.Last();
+    const int32 Slot = Chunk.TimecodeDeltasUs.Num();
+    Chunk.FrameIndexDeltas.Add(bNeedsChunk ? 0 : static_cast<uint16>(FrameDelta));
+    Chunk.TimecodeDeltasUs.Add(bNeedsChunk ? 0 : static_cast<uint32>(TimeDelta));
+    if ((Slot & 7) == 0)
+    {
+        Chunk.KeyFrameBits.Add(0);
+    }
+
+    if (Metadata.bKeyFrame)
+    {
+        Chunk.KeyFrameBits.Last() |= static_cast<uint8>(1u << (Slot & 7));
+        if (FirstKeyFrameIndex == INDEX_NONE)
+        {
+            FirstKeyFrameIndex = Metadata.FrameIndex;
+        }
+        ++Stats.KeyFrameCount;
+        if (Stats.KeyFrameCount > 1)
+        {
+            Stats.MeanKeyFrameInterval = static_cast<double>(Metadata.FrameIndex - FirstKeyFrameIndex) / (Stats.KeyFrameCount - 1);
+        }
+    }
+
+    ++Stats.FrameCount;
+    Stats.LastTimecode = Metadata.Timecode;
+    LastFrameIndex = Metadata.FrameIndex;
+    LastTimecodeUs = TimecodeUs;
+}
+
+void FOmniCaptureFrameMetadataStore::SpillOldestChunk()
+{
+    if (!SpillWriter)
+    {
+        SpillWriter.Reset(IFileManager::Get().CreateFileWriter(*SpillFilePath, FILEWRITE_AllowRead));
+        if (!SpillWriter)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to open frame metadata spill file %s; keeping metadata resident."), *SpillFilePath);
+            SpillFilePath.Reset();
+            return;
+        }
+    }
+
+    SerializeChunk(*SpillWriter, ResidentChunks[0]);
+    ResidentChunks.RemoveAt(0, 1, EAllowShrinking::No);
+    ++SpilledChunkCount;
+}
+
+void FOmniCaptureFrameMetadataStore::CloseSpillFile()
+{
+    if (SpillWriter)
+    {
+        SpillWriter->Close();
+        SpillWriter.Reset();
+    }
+}
+
+void FOmniCaptureFrameMetadataStore::DiscardSpillFile()
+{
+    FScopeLock Lock(&StoreCS);
+    CloseSpillFile();
+    if (!SpillFilePath.IsEmpty())
+    {
+        IFileManager::Get().Delete(*SpillFilePath, false, true, true);
+    }
+    SpilledChunkCount = 0;
+}
+
+void FOmniCaptureFrameMetadataStore::SerializeChunk(FArchive& Ar, FChunk& Chunk)
+{
+    Ar << Chunk.FirstFrameIndex;
+    Ar << Chunk.FirstTimecodeUs;
+    Chunk.FrameIndexDeltas.BulkSerialize(Ar);
+    Chunk.TimecodeDeltasUs.BulkSerialize(Ar);
+    Chunk.KeyFrameBits.BulkSerialize(Ar);
+}
+
+void FOmniCaptureFrameMetadataStore::VisitChunk(const FChunk& Chunk, TFunctionRef<void(const FOmniCaptureFrameMetadata&)> Visitor)
+{
+    FOmniCaptureFrameMetadata Metadata;
+    int32 FrameIndex = Chunk.FirstFrameIndex;
+    int64 TimecodeUs = Chunk.FirstTimecodeUs;
+
+    for (int32 Slot = 0; Slot < Chunk.TimecodeDeltasUs.Num(); ++Slot)
+    {
+        FrameIndex += Chunk.FrameIndexDeltas[Slot];
+        TimecodeUs += Chunk.TimecodeDeltasUs[Slot];
+
+        Metadata.FrameIndex = FrameIndex;
+        Metadata.Timecode = static_cast<double>(TimecodeUs) / 1000000.0;
+        Metadata.bKeyFrame = (Chunk.KeyFrameBits[Slot >> 3] & (1u << (Slot & 7))) != 0;
+        Visitor(Metadata);
+    }
+}
+
+void FOmniCaptureFrameMetadataStore::ForEachFrame(TFunctionRef<void(const FOmniCaptureFrameMetadata&)> Visitor) const
+{
+    FScopeLock Lock(&StoreCS);
+    if (SpilledChunkCount > 0 && !SpillFilePath.IsEmpty())
+    {
+        if (SpillWriter)
+        {
+            SpillWriter->Flush();
+        }
+
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*SpillFilePath, FILEREAD_AllowWrite));
+        if (Reader)
+        {
+            for (int32 ChunkIndex = 0; ChunkIndex < SpilledChunkCount && !Reader->AtEnd(); ++ChunkIndex)
+            {
+                FChunk Chunk;
+                SerializeChunk(*Reader, Chunk);
+                VisitChunk(Chunk, Visitor);
+            }
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to read frame metadata spill file %s"), *SpillFilePath);
+        }
+    }
+
+    for (const FChunk& Chunk : ResidentChunks)
+    {
+        VisitChunk(Chunk, Visitor);
+    }
+}
+
+void FOmniCaptureFrameMetadataStore::UpdateResidentBytes()
+{
+    int64 Bytes = ResidentChunks.GetAllocatedSize();
+    for (const FChunk& Chunk : ResidentChunks)
+    {
+        Bytes += Chunk.FrameIndexDeltas.GetAllocatedSize() + Chunk.TimecodeDeltasUs.GetAllocatedSize() + Chunk.KeyFrameBits.GetAllocatedSize();
+    }
+    ResidentBytes = Bytes;
+}
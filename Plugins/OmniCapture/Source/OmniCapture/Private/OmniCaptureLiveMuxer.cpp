@@ -0,0 +1,150 @@
+#include "OmniCaptureLiveMuxer.h"
+
+#include "OmniCaptureMuxer.h"
+#include "HAL/FileManager.h"
+#include "ImagePixelData.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/Paths.h"
+
+bool FOmniCaptureLiveMuxer::Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory)
+{
+    ActiveSettings = Settings;
+    OutputDirectory = FPaths::ConvertRelativePathToFull(InOutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : InOutputDirectory);
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+
+    const FString BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    OutputFilePath = OutputDirectory / (BaseFileName + TEXT("_live.mkv"));
+
+    FramesWritten = 0;
+    FrameSize = FIntPoint::ZeroValue;
+    bFailed = false;
+
+    const double FrameInterval = 1.0 / FMath::Max(1.0f, Settings.TargetFrameRate);
+    StallThresholdSeconds = FrameInterval * 2.0;
+
+    if (!FOmniCaptureMuxer::IsFFmpegAvailable(Settings, &Binary))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live FFmpeg mux requested but FFmpeg was not found."));
+        bFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool FOmniCaptureLiveMuxer::OpenPipe(const FIntPoint& Size, bool bLinear)
+{
+    const bool bTenBit = ActiveSettings.ColorSpace != EOmniCaptureColorSpace::BT709;
+    const TCHAR* CodecName = ActiveSettings.Codec == EOmniCaptureCodec::HEVC ? TEXT("libx265") : TEXT("libx264");
+
+    FString Arguments = FString::Printf(TEXT("-y -loglevel error -nostats -f rawvideo -pix_fmt %s -s %dx%d -framerate %.3f -i pipe:0"),
+        bLinear ? TEXT("rgb48le") : TEXT("bgra"),
+        Size.X,
+        Size.Y,
+        FMath::Max(1.0f, ActiveSettings.TargetFrameRate));
+
+    Arguments += FString::Printf(TEXT(" -c:v %s -preset veryfast -pix_fmt %s -b:v %dk -maxrate %dk -bufsize %dk -g %d -bf %d"),
+        CodecName,
+        bTenBit ? TEXT("yuv420p10le") : TEXT("yuv420p"),
+        ActiveSettings.Quality.TargetBitrateKbps,
+        ActiveSettings.Quality.MaxBitrateKbps,
+        ActiveSettings.Quality.MaxBitrateKbps * 2,
+        FMath::Max(1, ActiveSettings.Quality.GOPLength),
+        FMath::Max(0, ActiveSettings.Quality.BFrames));
+
+    Arguments += FString::Printf(TEXT(" -threads %d \"%s\""), FMath::Max(1, ActiveSettings.MuxThreadsPerJob), *OutputFilePath);
+
+    if (!Pipe.Open(Binary, Arguments, OutputDirectory))
+    {
+        return false;
+    }
+
+    FrameSize = Size;
+    bLinearInput = bLinear;
+    return true;
+}
+
+bool FOmniCaptureLiveMuxer::PushFrame(const FOmniCaptureFrame& Frame)
+{
+    if (bFailed || !Frame.PixelData.IsValid())
+    {
+        return false;
+    }
+
+    const FImagePixelData& PixelData = *Frame.PixelData;
+    const FIntPoint Size = PixelData.GetSize();
+    const bool bLinear = PixelData.GetType() == EImagePixelType::Float16;
+
+    if (!Pipe.IsOpen())
+    {
+        if (!OpenPipe(Size, bLinear))
+        {
+            bFailed = true;
+            return false;
+        }
+    }
+    else if (Size != FrameSize || bLinear != bLinearInput)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live mux frame format changed mid-stream; dropping frame %d."), Frame.Metadata.FrameIndex);
+        return false;
+    }
+
+    const void* RawData = nullptr;
+    int64 RawSize = 0;
+    PixelData.GetRawData(RawData, RawSize);
+
+    bool bWritten = false;
+    if (bLinear)
+    {
+        const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+        ConversionBuffer.SetNumUninitialized(PixelCount * 3, EAllowShrinking::No);
+
+        const FFloat16Color* Source = static_cast<const FFloat16Color*>(RawData);
+        uint16* Dest = ConversionBuffer.GetData();
+        for (int64 Index = 0; Index < PixelCount; ++Index)
+        {
+            const FFloat16Color& Pixel = Source[Index];
+            Dest[Index * 3 + 0] = static_cast<uint16>(FMath::Clamp(Pixel.R.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+            Dest[Index * 3 + 1] = static_cast<uint16>(FMath::Clamp(Pixel.G.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+            Dest[Index * 3 + 2] = static_cast<uint16>(FMath::Clamp(Pixel.B.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+
+        bWritten = Pipe.Write(ConversionBuffer.GetData(), ConversionBuffer.Num() * sizeof(uint16));
+    }
+    else
+    {
+        bWritten = Pipe.Write(RawData, RawSize);
+    }
+
+    if (!bWritten)
+    {
+        bFailed = true;
+        return false;
+    }
+
+    ++FramesWritten;
+    return true;
+}
+
+bool FOmniCaptureLiveMuxer::Finalize()
+{
+    if (!Pipe.IsOpen())
+    {
+        return false;
+    }
+
+    const int32 ReturnCode = Pipe.Close();
+    if (ReturnCode != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live FFmpeg mux exited with code %d (%s)"), ReturnCode, *OutputFilePath);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Live FFmpeg mux complete: %s (%d frames)"), *OutputFilePath, FramesWritten);
+    return !bFailed;
+}
+
+bool FOmniCaptureLiveMuxer::IsStalled() const
+{
+    return Pipe.IsStalled(StallThresholdSeconds);
+}
@@ -0,0 +1,125 @@
+#include "OmniCaptureManifestWriter.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/Archive.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    constexpr int32 ManifestFlushInterval = 120;
+}
+
+FOmniCaptureManifestWriter::~FOmniCaptureManifestWriter()
+{
+    FScopeLock Lock(&WriterCS);
+    if (Archive)
+    {
+        Archive->Close();
+        Archive.Reset();
+    }
+}
+
+bool FOmniCaptureManifestWriter::Open(const FString& InManifestPath, const TSharedRef<FJsonObject>& Header)
+{
+    FScopeLock Lock(&WriterCS);
+
+    if (Archive)
+    {
+        Archive->Close();
+    }
+
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*InManifestPath, FILEWRITE_AllowRead));
+    if (!Archive)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to open OmniCapture manifest %s"), *InManifestPath);
+        return false;
+    }
+
+    ManifestPath = InManifestPath;
+    LinesSinceFlush = 0;
+
+    Header->SetStringField(TEXT("type"), TEXT("header"));
+    WriteObjectLine(Header);
+    Archive->Flush();
+    return true;
+}
+
+void FOmniCaptureManifestWriter::AppendFrame(const FOmniCaptureFrameMetadata& Metadata)
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Archive)
+    {
+        return;
+    }
+
+    WriteLine(FString::Printf(TEXT("{\"index\":%d,\"timecode\":%.6f,\"keyFrame\":%s}"),
+        Metadata.FrameIndex,
+        Metadata.Timecode,
+        Metadata.bKeyFrame ? TEXT("true") : TEXT("false")));
+
+    if (++LinesSinceFlush >= ManifestFlushInterval)
+    {
+        Archive->Flush();
+        LinesSinceFlush = 0;
+    }
+}
+
+void FOmniCaptureManifestWriter::AppendDrop(const FOmniCaptureDropEvent& Drop)
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Archive)
+    {
+        return;
+    }
+
+    WriteLine(FString::Printf(TEXT("{\"type\":\"drop\",\"sequence\":%d,\"index\":%d,\"time\":%.6f,\"cause\":\"%s\",\"bottleneck\":\"%s\",\"stage\":\"%s\",\"stageMs\":%.3f}"),
+        Drop.Sequence,
+        Drop.FrameIndex,
+        Drop.CaptureSeconds,
+        *StaticEnum<EOmniCaptureDropCause>()->GetNameStringByValue(static_cast<int64>(Drop.Cause)),
+        *StaticEnum<EOmniCaptureBottleneck>()->GetNameStringByValue(static_cast<int64>(Drop.Bottleneck)),
+        *StaticEnum<EOmniCaptureStage>()->GetNameStringByValue(static_cast<int64>(Drop.Stage)),
+        Drop.StageMs));
+
+    // Drops are rare and are exactly what a post-mortem needs, so they are not left buffered.
+    Archive->Flush();
+    LinesSinceFlush = 0;
+}
+
+bool FOmniCaptureManifestWriter::Close(const TSharedRef<FJsonObject>& Footer)
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Archive)
+    {
+        return false;
+    }
+
+    Footer->SetStringField(TEXT("type"), TEXT("footer"));
+    WriteObjectLine(Footer);
+
+    Archive->Close();
+    Archive.Reset();
+    return true;
+}
+
+void FOmniCaptureManifestWriter::WriteLine(const FString& Line)
+{
+    FTCHARToUTF8 Converted(*Line);
+    Archive->Serialize(const_cast<ANSICHAR*>(Converted.Get()), Converted.Length());
+    ANSICHAR NewLine = '\n';
+    Archive->Serialize(&NewLine, 1);
+}
+
+void FOmniCaptureManifestWriter::WriteObjectLine(const TSharedRef<FJsonObject>& Object)
+{
+    FString OutputString;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+    if (FJsonSerializer::Serialize(Object, Writer))
+    {
+        WriteLine(OutputString);
+    }
+}
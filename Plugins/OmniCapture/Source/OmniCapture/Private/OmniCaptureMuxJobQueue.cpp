@@ -0,0 +1,457 @@
+#include "OmniCaptureMuxJobQueue.h"
+
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureMux, Log, All);
+
+namespace
+{
+    // Finished jobs kept for status display; older ones are dropped once their callbacks have run.
+    constexpr int32 MaxFinishedJobHistory = 8;
+
+    bool IsFinished(EOmniCaptureMuxJobState State)
+    {
+        return State != EOmniCaptureMuxJobState::Queued && State != EOmniCaptureMuxJobState::Running;
+    }
+}
+
+class FOmniCaptureMuxScheduler final : public FRunnable
+{
+public:
+    FOmniCaptureMuxScheduler(FOmniCaptureMuxJobQueue& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning.Load())
+        {
+            Owner.Pump();
+            WakeEvent->Wait(100);
+        }
+
+        Owner.Pump();
+
+        return 0;
+    }
+
+private:
+    FOmniCaptureMuxJobQueue& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+
+FOmniCaptureMuxJobQueue::FOmniCaptureMuxJobQueue()
+{
+    bRunning = false;
+}
+
+FOmniCaptureMuxJobQueue::~FOmniCaptureMuxJobQueue()
+{
+    CancelAll();
+    StopWorker();
+
+    FScopeLock Lock(&JobsCS);
+    for (TUniquePtr<FJob>& Job : Jobs)
+    {
+        if (Job->ProcHandle.IsValid())
+        {
+            FPlatformProcess::TerminateProc(Job->ProcHandle, true);
+        }
+        ReleaseJobProcess(*Job);
+    }
+    Jobs.Empty();
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+int32 FOmniCaptureMuxJobQueue::ResolveCoreBudget(int32 RequestedBudget)
+{
+    const int32 AvailableCores = FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    if (RequestedBudget <= 0)
+    {
+        return FMath::Max(1, AvailableCores - 1);
+    }
+
+    return FMath::Clamp(RequestedBudget, 1, AvailableCores);
+}
+
+void FOmniCaptureMuxJobQueue::Initialize(int32 InCoreBudget, int32 InThreadsPerJob)
+{
+    const int32 CoreBudget = ResolveCoreBudget(InCoreBudget);
+
+    {
+        FScopeLock Lock(&JobsCS);
+        ThreadsPerJob = FMath::Clamp(InThreadsPerJob, 1, CoreBudget);
+        MaxConcurrentJobs = FMath::Max(1, CoreBudget / ThreadsPerJob);
+    }
+
+    UE_LOG(LogOmniCaptureMux, Log, TEXT("Mux job queue ready (%d concurrent jobs x %d threads)"), MaxConcurrentJobs, ThreadsPerJob);
+
+    StartWorker();
+}
+
+int32 FOmniCaptureMuxJobQueue::Submit(FOmniCaptureMuxJobDesc&& Job, FOnJobComplete&& OnComplete)
+{
+    TUniquePtr<FJob> NewJob = MakeUnique<FJob>();
+    NewJob->Desc = MoveTemp(Job);
+    NewJob->OnComplete = MoveTemp(OnComplete);
+    NewJob->Status.SegmentIndex = NewJob->Desc.SegmentIndex;
+    NewJob->Status.OutputFile = NewJob->Desc.OutputFile;
+    NewJob->Status.State = EOmniCaptureMuxJobState::Queued;
+
+    int32 JobId = 0;
+    {
+        FScopeLock Lock(&JobsCS);
+        JobId = NextJobId++;
+        NewJob->Status.JobId = JobId;
+        Jobs.Add(MoveTemp(NewJob));
+    }
+
+    StartWorker();
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+
+    return JobId;
+}
+
+void FOmniCaptureMuxJobQueue::Cancel(int32 JobId)
+{
+    {
+        FScopeLock Lock(&JobsCS);
+        for (TUniquePtr<FJob>& Job : Jobs)
+        {
+            if (Job->Status.JobId == JobId)
+            {
+                Job->bCancelRequested = true;
+                break;
+            }
+        }
+    }
+
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FOmniCaptureMuxJobQueue::CancelAll()
+{
+    {
+        FScopeLock Lock(&JobsCS);
+        for (TUniquePtr<FJob>& Job : Jobs)
+        {
+            Job->bCancelRequested = true;
+        }
+    }
+
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+bool FOmniCaptureMuxJobQueue::HasPendingJobs() const
+{
+    FScopeLock Lock(&JobsCS);
+    for (const TUniquePtr<FJob>& Job : Jobs)
+    {
+        if (Job->Status.State == EOmniCaptureMuxJobState::Queued || Job->Status.State == EOmniCaptureMuxJobState::Running)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+TArray<FOmniCaptureMuxJobStatus> FOmniCaptureMuxJobQueue::GetJobStatuses() const
+{
+    TArray<FOmniCaptureMuxJobStatus> Result;
+
+    FScopeLock Lock(&JobsCS);
+    Result.Reserve(Jobs.Num());
+    for (const TUniquePtr<FJob>& Job : Jobs)
+    {
+        Result.Add(Job->Status);
+    }
+    return Result;
+}
+
+void FOmniCaptureMuxJobQueue::StartWorker()
+{
+    if (WorkerThread.IsValid())
+    {
+        return;
+    }
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+    }
+    bRunning = true;
+
+    Scheduler = new FOmniCaptureMuxScheduler(*this, WakeEvent, bRunning);
+    WorkerThread.Reset(FRunnableThread::Create(Scheduler, TEXT("OmniCaptureMuxScheduler")));
+}
+
+void FOmniCaptureMuxJobQueue::StopWorker()
+{
+    if (!WorkerThread.IsValid())
+    {
+        return;
+    }
+
+    bRunning = false;
+
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+
+    WorkerThread->WaitForCompletion();
+    WorkerThread.Reset();
+
+    delete Scheduler;
+    Scheduler = nullptr;
+}
+
+void FOmniCaptureMuxJobQueue::Pump()
+{
+    TArray<TPair<FOnJobComplete, FOmniCaptureMuxJobStatus>> Completed;
+
+    {
+        FScopeLock Lock(&JobsCS);
+
+        const double Now = FPlatformTime::Seconds();
+        int32 RunningCount = 0;
+
+        for (TUniquePtr<FJob>& JobPtr : Jobs)
+        {
+            FJob& Job = *JobPtr;
+
+            if (Job.Status.State == EOmniCaptureMuxJobState::Queued && Job.bCancelRequested)
+            {
+                Job.Status.State = EOmniCaptureMuxJobState::Cancelled;
+                Completed.Emplace(MoveTemp(Job.OnComplete), Job.Status);
+                continue;
+            }
+
+            if (Job.Status.State != EOmniCaptureMuxJobState::Running)
+            {
+                continue;
+            }
+
+            ReadJobOutput(Job);
+            Job.Status.ElapsedSeconds = Now - Job.StartTime;
+
+            if (Job.bCancelRequested)
+            {
+                FPlatformProcess::TerminateProc(Job.ProcHandle, true);
+                ReleaseJobProcess(Job);
+                Job.Status.State = EOmniCaptureMuxJobState::Cancelled;
+                Job.Status.EstimatedSecondsRemaining = -1.0;
+                UE_LOG(LogOmniCaptureMux, Warning, TEXT("Mux job %d cancelled (%s)"), Job.Status.JobId, *Job.Desc.OutputFile);
+                Completed.Emplace(MoveTemp(Job.OnComplete), Job.Status);
+                continue;
+            }
+
+            if (FPlatformProcess::IsProcRunning(Job.ProcHandle))
+            {
+                ++RunningCount;
+                continue;
+            }
+
+            ReadJobOutput(Job);
+
+            int32 ReturnCode = 0;
+            FPlatformProcess::GetProcReturnCode(Job.ProcHandle, &ReturnCode);
+            ReleaseJobProcess(Job);
+
+            Job.Status.ExitCode = ReturnCode;
+            Job.Status.EstimatedSecondsRemaining = 0.0;
+            if (ReturnCode == 0)
+            {
+                Job.Status.State = EOmniCaptureMuxJobState::Succeeded;
+                Job.Status.Progress = 1.0f;
+                UE_LOG(LogOmniCaptureMux, Log, TEXT("FFmpeg muxing complete: %s (%.1fs)"), *Job.Desc.OutputFile, Job.Status.ElapsedSeconds);
+            }
+            else
+            {
+                Job.Status.State = EOmniCaptureMuxJobState::Failed;
+                UE_LOG(LogOmniCaptureMux, Warning, TEXT("FFmpeg returned non-zero exit code %d for %s"), ReturnCode, *Job.Desc.OutputFile);
+            }
+
+            Completed.Emplace(MoveTemp(Job.OnComplete), Job.Status);
+        }
+
+        for (TUniquePtr<FJob>& JobPtr : Jobs)
+        {
+            if (RunningCount >= MaxConcurrentJobs)
+            {
+                break;
+            }
+
+            FJob& Job = *JobPtr;
+            if (Job.Status.State != EOmniCaptureMuxJobState::Queued)
+            {
+                continue;
+            }
+
+            if (LaunchJob(Job))
+            {
+                ++RunningCount;
+            }
+            else
+            {
+                Job.Status.State = EOmniCaptureMuxJobState::Failed;
+                Completed.Emplace(MoveTemp(Job.OnComplete), Job.Status);
+            }
+        }
+    }
+
+    for (TPair<FOnJobComplete, FOmniCaptureMuxJobStatus>& Entry : Completed)
+    {
+        if (Entry.Key)
+        {
+            Entry.Key(Entry.Value);
+        }
+    }
+
+    if (Completed.Num() > 0)
+    {
+        PruneFinishedJobs();
+    }
+}
+
+void FOmniCaptureMuxJobQueue::PruneFinishedJobs()
+{
+    FScopeLock Lock(&JobsCS);
+
+    int32 FinishedCount = 0;
+    for (const TUniquePtr<FJob>& Job : Jobs)
+    {
+        FinishedCount += IsFinished(Job->Status.State) ? 1 : 0;
+    }
+
+    // Jobs are kept in submission order, so the oldest finished jobs go first.
+    for (int32 Index = 0; Index < Jobs.Num() && FinishedCount > MaxFinishedJobHistory;)
+    {
+        if (IsFinished(Jobs[Index]->Status.State))
+        {
+            Jobs.RemoveAt(Index, 1, EAllowShrinking::No);
+            --FinishedCount;
+        }
+        else
+        {
+            ++Index;
+        }
+    }
+}
+
+bool FOmniCaptureMuxJobQueue::LaunchJob(FJob& Job)
+{
+    if (!FPlatformProcess::CreatePipe(Job.ReadPipe, Job.WritePipe))
+    {
+        Job.ReadPipe = nullptr;
+        Job.WritePipe = nullptr;
+    }
+
+    UE_LOG(LogOmniCaptureMux, Log, TEXT("Invoking FFmpeg (job %d): %s %s"), Job.Status.JobId, *Job.Desc.Binary, *Job.Desc.Arguments);
+
+    Job.ProcHandle = FPlatformProcess::CreateProc(*Job.Desc.Binary, *Job.Desc.Arguments, false, true, true, nullptr, -1, *Job.Desc.WorkingDirectory, Job.WritePipe, nullptr);
+    if (!Job.ProcHandle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureMux, Warning, TEXT("Failed to launch FFmpeg process for %s"), *Job.Desc.OutputFile);
+        ReleaseJobProcess(Job);
+        return false;
+    }
+
+    Job.StartTime = FPlatformTime::Seconds();
+    Job.Status.State = EOmniCaptureMuxJobState::Running;
+    Job.Status.Progress = 0.0f;
+    Job.Status.ElapsedSeconds = 0.0;
+    Job.Status.EstimatedSecondsRemaining = -1.0;
+    return true;
+}
+
+void FOmniCaptureMuxJobQueue::ReadJobOutput(FJob& Job)
+{
+    if (!Job.ReadPipe)
+    {
+        return;
+    }
+
+    Job.PendingOutput += FPlatformProcess::ReadPipe(Job.ReadPipe);
+
+    int32 LineEnd = INDEX_NONE;
+    while (Job.PendingOutput.FindChar(TEXT('\n'), LineEnd))
+    {
+        ParseProgressLine(Job, Job.PendingOutput.Left(LineEnd).TrimStartAndEnd());
+        Job.PendingOutput.RightChopInline(LineEnd + 1, EAllowShrinking::No);
+    }
+}
+
+void FOmniCaptureMuxJobQueue::ParseProgressLine(FJob& Job, const FString& Line)
+{
+    FString Key;
+    FString Value;
+    if (!Line.Split(TEXT("="), &Key, &Value))
+    {
+        return;
+    }
+
+    double Fraction = -1.0;
+    if (Key == TEXT("frame") && Job.Desc.TotalFrames > 0)
+    {
+        Fraction = static_cast<double>(FCString::Atoi(*Value)) / Job.Desc.TotalFrames;
+    }
+    else if ((Key == TEXT("out_time_us") || Key == TEXT("out_time_ms")) && Job.Desc.TotalFrames <= 0 && Job.Desc.DurationSeconds > 0.0)
+    {
+        // FFmpeg reports out_time_ms in microseconds as well.
+        Fraction = (FCString::Atod(*Value) / 1000000.0) / Job.Desc.DurationSeconds;
+    }
+    else if (Key == TEXT("progress") && Value == TEXT("end"))
+    {
+        Fraction = 1.0;
+    }
+
+    if (Fraction < 0.0)
+    {
+        return;
+    }
+
+    Job.Status.Progress = static_cast<float>(FMath::Clamp(Fraction, 0.0, 1.0));
+    const double Elapsed = FPlatformTime::Seconds() - Job.StartTime;
+    Job.Status.EstimatedSecondsRemaining = Job.Status.Progress > KINDA_SMALL_NUMBER
+        ? Elapsed * (1.0 - Job.Status.Progress) / Job.Status.Progress
+        : -1.0;
+}
+
+void FOmniCaptureMuxJobQueue::ReleaseJobProcess(FJob& Job)
+{
+    if (Job.ProcHandle.IsValid())
+    {
+        FPlatformProcess::CloseProc(Job.ProcHandle);
+    }
+
+    if (Job.ReadPipe || Job.WritePipe)
+    {
+        FPlatformProcess::ClosePipe(Job.ReadPipe, Job.WritePipe);
+        Job.ReadPipe = nullptr;
+        Job.WritePipe = nullptr;
+    }
+}
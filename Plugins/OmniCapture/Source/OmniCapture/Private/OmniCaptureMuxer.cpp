@@ -1,12 +1,82 @@
 #include "OmniCaptureMuxer.h"
 
+#include "OmniCaptureSoftwareEncoder.h"
+
 #include "HAL/FileManager.h"
-#include "HAL/PlatformProcess.h"
-#include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformMisc.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    bool IsFragmentedMP4(const FString& VideoPath)
+    {
+        return FPaths::GetExtension(VideoPath).Equals(TEXT("mp4"), ESearchCase::IgnoreCase) && FPaths::FileExists(VideoPath);
+    }
+
+    bool IsTileManifest(const FString& VideoPath)
+    {
+        return FPaths::GetExtension(VideoPath).Equals(TEXT("json"), ESearchCase::IgnoreCase);
+    }
+
+    // Adds one FFmpeg input per tile column listed in the tiled encoder's manifest.
+    int32 AppendTileInputs(const FString& ManifestPath, double FrameRate, FString& CommandLine)
+    {
+        FString ManifestText;
+        if (!FFileHelper::LoadFileToString(ManifestText, *ManifestPath))
+        {
+            return 0;
+        }
+
+        TSharedPtr<FJsonObject> Root;
+        const TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(ManifestText);
+        const TArray<TSharedPtr<FJsonValue>>* Tiles = nullptr;
+        if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("tiles"), Tiles))
+        {
+            return 0;
+        }
+
+        int32 NumInputs = 0;
+        for (const TSharedPtr<FJsonValue>& TileValue : *Tiles)
+        {
+            const TSharedPtr<FJsonObject>* TileObject = nullptr;
+            FString TilePath;
+            if (!TileValue->TryGetObject(TileObject) || !(*TileObject)->TryGetStringField(TEXT("path"), TilePath) || !FPaths::FileExists(TilePath))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Tile %d of %s is missing; cannot stitch."), NumInputs, *ManifestPath);
+                return 0;
+            }
+
+            CommandLine += IsFragmentedMP4(TilePath)
+                ? FString::Printf(TEXT(" -i \"%s\""), *TilePath)
+                : FString::Printf(TEXT(" -framerate %.3f -i \"%s\""), FrameRate, *TilePath);
+            ++NumInputs;
+        }
+        return NumInputs;
+    }
+
+    // PNG frames are named by the capture-wide frame index, so later segments and sequences that
+    // only start after a failed live mux do not begin at zero.
+    int32 FindFirstPNGFrameNumber(const FString& OutputDirectory, const FString& BaseFileName)
+    {
+        TArray<FString> FrameFiles;
+        IFileManager::Get().FindFiles(FrameFiles, *(OutputDirectory / (BaseFileName + TEXT("_*.png"))), true, false);
+
+        int32 FirstFrame = MAX_int32;
+        for (const FString& FrameFile : FrameFiles)
+        {
+            const FString Suffix = FPaths::GetBaseFilename(FrameFile).RightChop(BaseFileName.Len() + 1);
+            if (Suffix.Len() == 6 && Suffix.IsNumeric())
+            {
+                FirstFrame = FMath::Min(FirstFrame, FCString::Atoi(*Suffix));
+            }
+        }
+        return FirstFrame == MAX_int32 ? 0 : FirstFrame;
+    }
+}
 
 FString FOmniCaptureMuxer::ResolveFFmpegBinary(const FOmniCaptureSettings& Settings)
 {
@@ -72,8 +142,18 @@ void FOmniCaptureMuxer::EndRealtimeSession()
     LastAudioTimestamp = 0.0;
 }
 
+void FOmniCaptureMuxer::RecordDrop(const FOmniCaptureDropEvent& Drop)
+{
+    ManifestWriter.AppendDrop(Drop);
+    ++DropsByCause[FMath::Clamp(static_cast<int32>(Drop.Cause), 0, static_cast<int32>(EOmniCaptureDropCause::Count) - 1)];
+    ++DropsByBottleneck[FMath::Clamp(static_cast<int32>(Drop.Bottleneck), 0, UE_ARRAY_COUNT(DropsByBottleneck) - 1)];
+}
+
 void FOmniCaptureMuxer::PushFrame(const FOmniCaptureFrame& Frame)
 {
+    ManifestWriter.AppendFrame(Frame.Metadata);
+    FrameStore.Add(Frame.Metadata);
+
     if (!bRealtimeSessionActive)
     {
         return;
@@ -85,12 +165,12 @@ void FOmniCaptureMuxer::PushFrame(const FOmniCaptureFrame& Frame)
     int32 PacketCount = 0;
     double LatestAudioTime = LastAudioTimestamp;
 
-    for (const FOmniAudioPacket& Packet : Frame.AudioPackets)
+    for (const FOmniAudioSpan& Span : Frame.AudioSpans)
     {
-        const double Duration = (Packet.SampleRate > 0 && Packet.NumChannels > 0)
-            ? static_cast<double>(Packet.PCM16.Num()) / (static_cast<double>(Packet.SampleRate) * FMath::Max(Packet.NumChannels, 1))
+        const double Duration = (Span.SampleRate > 0 && Span.NumChannels > 0)
+            ? static_cast<double>(Span.Num()) / (static_cast<double>(Span.SampleRate) * FMath::Max(Span.NumChannels, 1))
             : 0.0;
-        LatestAudioTime = FMath::Max(LatestAudioTime, Packet.Timestamp + Duration);
+        LatestAudioTime = FMath::Max(LatestAudioTime, Span.Timestamp + Duration);
         ++PacketCount;
     }
 
@@ -102,94 +182,183 @@ void FOmniCaptureMuxer::PushFrame(const FOmniCaptureFrame& Frame)
     AudioStats.bInError = FMath::Abs(AudioStats.DriftMilliseconds) > DriftWarningThresholdMs;
 }
 
-bool FOmniCaptureMuxer::FinalizeCapture(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath)
+bool FOmniCaptureMuxer::OpenManifest(const FOmniCaptureSettings& Settings)
 {
-    FString ManifestPath;
-    if (!WriteManifest(Settings, Frames, AudioPath, VideoPath, ManifestPath))
-    {
-        return false;
-    }
-
-    UE_LOG(LogTemp, Log, TEXT("OmniCapture manifest written to %s"), *ManifestPath);
-
-    TryInvokeFFmpeg(Settings, Frames, AudioPath, VideoPath);
-
-    return true;
-}
-
-bool FOmniCaptureMuxer::WriteManifest(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, FString& OutManifestPath) const
-{
-    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
-
-    Root->SetStringField(TEXT("fileBase"), BaseFileName);
-    Root->SetStringField(TEXT("directory"), OutputDirectory);
-    Root->SetStringField(TEXT("outputFormat"), Settings.OutputFormat == EOmniOutputFormat::PNGSequence ? TEXT("PNGSequence") : TEXT("NVENC"));
-    Root->SetStringField(TEXT("mode"), Settings.Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"));
-    Root->SetStringField(TEXT("gamma"), Settings.Gamma == EOmniCaptureGamma::Linear ? TEXT("Linear") : TEXT("sRGB"));
-    Root->SetNumberField(TEXT("resolution"), Settings.Resolution);
-    Root->SetNumberField(TEXT("frameCount"), Frames.Num());
-    Root->SetNumberField(TEXT("frameRate"), CalculateFrameRate(Frames));
-    Root->SetStringField(TEXT("stereoLayout"), Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom ? TEXT("TopBottom") : TEXT("SideBySide"));
+    TSharedRef<FJsonObject> Header = MakeShared<FJsonObject>();
+
+    Header->SetStringField(TEXT("fileBase"), BaseFileName);
+    Header->SetStringField(TEXT("directory"), OutputDirectory);
+    Header->SetStringField(TEXT("outputFormat"), Settings.OutputFormat == EOmniOutputFormat::PNGSequence ? TEXT("PNGSequence") : (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware ? TEXT("NVENC") : TEXT("Software")));
+    Header->SetStringField(TEXT("mode"), Settings.Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"));
+    Header->SetStringField(TEXT("gamma"), Settings.Gamma == EOmniCaptureGamma::Linear ? TEXT("Linear") : TEXT("sRGB"));
+    Header->SetNumberField(TEXT("resolution"), Settings.Resolution);
+    Header->SetNumberField(TEXT("targetFrameRate"), Settings.TargetFrameRate);
+    Header->SetStringField(TEXT("stereoLayout"), Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom ? TEXT("TopBottom") : TEXT("SideBySide"));
     switch (Settings.ColorSpace)
     {
     case EOmniCaptureColorSpace::BT2020:
-        Root->SetStringField(TEXT("colorSpace"), TEXT("BT.2020"));
+        Header->SetStringField(TEXT("colorSpace"), TEXT("BT.2020"));
         break;
     case EOmniCaptureColorSpace::HDR10:
-        Root->SetStringField(TEXT("colorSpace"), TEXT("HDR10"));
+        Header->SetStringField(TEXT("colorSpace"), TEXT("HDR10"));
         break;
     default:
-        Root->SetStringField(TEXT("colorSpace"), TEXT("BT.709"));
+        Header->SetStringField(TEXT("colorSpace"), TEXT("BT.709"));
         break;
     }
-    Root->SetStringField(TEXT("audio"), AudioPath);
-    const FString FinalVideo = OutputDirectory / (BaseFileName + TEXT(".mp4"));
-    Root->SetStringField(TEXT("videoFile"), FinalVideo);
-    if (!VideoPath.IsEmpty())
-    {
-        Root->SetStringField(TEXT("nvencBitstream"), VideoPath);
-    }
-    Root->SetBoolField(TEXT("zeroCopy"), Settings.bZeroCopy);
-    Root->SetStringField(TEXT("codec"), Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H264"));
+    Header->SetStringField(TEXT("videoFile"), OutputDirectory / (BaseFileName + TEXT(".mp4")));
+    Header->SetBoolField(TEXT("zeroCopy"), Settings.bZeroCopy);
+    Header->SetStringField(TEXT("codec"), Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H264"));
     switch (Settings.NVENCColorFormat)
     {
     case EOmniCaptureColorFormat::NV12:
-        Root->SetStringField(TEXT("nvencColorFormat"), TEXT("NV12"));
+        Header->SetStringField(TEXT("nvencColorFormat"), TEXT("NV12"));
         break;
     case EOmniCaptureColorFormat::P010:
-        Root->SetStringField(TEXT("nvencColorFormat"), TEXT("P010"));
+        Header->SetStringField(TEXT("nvencColorFormat"), TEXT("P010"));
         break;
     case EOmniCaptureColorFormat::BGRA:
-        Root->SetStringField(TEXT("nvencColorFormat"), TEXT("BGRA"));
+        Header->SetStringField(TEXT("nvencColorFormat"), TEXT("BGRA"));
         break;
     }
 
-    TArray<TSharedPtr<FJsonValue>> FrameArray;
-    FrameArray.Reserve(Frames.Num());
-    for (const FOmniCaptureFrameMetadata& Metadata : Frames)
+    // A store that was never closed has nobody left to read its spill file.
+    FrameStore.DiscardSpillFile();
+    FrameStore.Reset(OutputDirectory / (BaseFileName + TEXT("_FrameIndex.bin")));
+    FMemory::Memzero(DropsByCause);
+    FMemory::Memzero(DropsByBottleneck);
+
+    const FString ManifestPath = OutputDirectory / (BaseFileName + TEXT("_Manifest.jsonl"));
+    return ManifestWriter.Open(ManifestPath, Header);
+}
+
+FOmniCaptureManifestSummary FOmniCaptureMuxer::CloseManifest(const FOmniCaptureSettings& Settings, const FString& AudioPath, const FOmniCaptureAudioTimelineSummary& AudioTimeline, const FString& VideoPath)
+{
+    FOmniCaptureManifestSummary Summary;
+    Summary.Timing = FrameStore.GetStats();
+
+    if (AudioTimeline.IsValid())
+    {
+        // Positive offsets mean audio starts after the first video frame.
+        Summary.AudioSampleRate = AudioTimeline.SampleRate;
+        Summary.AudioOffsetSamples = FMath::RoundToInt64((AudioTimeline.StartTime - Summary.Timing.FirstTimecode) * AudioTimeline.SampleRate);
+    }
+
+    if (!ManifestWriter.IsOpen())
     {
-        TSharedRef<FJsonObject> FrameObject = MakeShared<FJsonObject>();
-        FrameObject->SetNumberField(TEXT("index"), Metadata.FrameIndex);
-        FrameObject->SetNumberField(TEXT("timecode"), Metadata.Timecode);
-        FrameObject->SetBoolField(TEXT("keyFrame"), Metadata.bKeyFrame);
-        FrameArray.Add(MakeShared<FJsonValueObject>(FrameObject));
+        FrameStore.DiscardSpillFile();
+        FrameStore.Reset();
+        return Summary;
     }
-    Root->SetArrayField(TEXT("frames"), FrameArray);
 
-    FString OutputString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    if (!FJsonSerializer::Serialize(Root, Writer))
+    const FOmniCaptureFrameTimingStats& Timing = Summary.Timing;
+
+    // Seek index for players and editors: every key frame with its timecode, replayed from the
+    // metadata store (including chunks spilled to disk during long captures).
+    TArray<TSharedPtr<FJsonValue>> KeyFrames;
+    KeyFrames.Reserve(Timing.KeyFrameCount);
+    FrameStore.ForEachFrame([&KeyFrames](const FOmniCaptureFrameMetadata& Metadata)
     {
-        return false;
+        if (Metadata.bKeyFrame)
+        {
+            TArray<TSharedPtr<FJsonValue>> Entry;
+            Entry.Add(MakeShared<FJsonValueNumber>(Metadata.FrameIndex));
+            Entry.Add(MakeShared<FJsonValueNumber>(Metadata.Timecode));
+            KeyFrames.Add(MakeShared<FJsonValueArray>(Entry));
+        }
+    });
+    FrameStore.DiscardSpillFile();
+
+    TSharedRef<FJsonObject> Footer = MakeShared<FJsonObject>();
+    Footer->SetStringField(TEXT("audio"), AudioPath);
+    if (!VideoPath.IsEmpty())
+    {
+        const TCHAR* VideoKey = Settings.OutputFormat == EOmniOutputFormat::NVENCHardware ? TEXT("nvencBitstream")
+            : (Settings.OutputFormat == EOmniOutputFormat::SoftwareEncoder ? TEXT("softwareBitstream") : TEXT("liveIntermediate"));
+        Footer->SetStringField(VideoKey, VideoPath);
+    }
+    Footer->SetNumberField(TEXT("frameCount"), Timing.FrameCount);
+    Footer->SetNumberField(TEXT("keyFrameCount"), Timing.KeyFrameCount);
+    Footer->SetNumberField(TEXT("frameRate"), Timing.GetFrameRate());
+    Footer->SetNumberField(TEXT("firstTimecode"), Timing.FirstTimecode);
+    Footer->SetNumberField(TEXT("lastTimecode"), Timing.LastTimecode);
+    Footer->SetNumberField(TEXT("jitterMs"), Timing.GetJitterMilliseconds());
+    Footer->SetNumberField(TEXT("maxFrameIntervalMs"), Timing.MaxIntervalSeconds * 1000.0);
+    Footer->SetNumberField(TEXT("missingFrames"), Timing.MissingFrames);
+    Footer->SetNumberField(TEXT("meanKeyFrameInterval"), Timing.MeanKeyFrameInterval);
+    Footer->SetArrayField(TEXT("keyFrames"), KeyFrames);
+    if (AudioTimeline.IsValid())
+    {
+        Footer->SetNumberField(TEXT("audioSampleRate"), AudioTimeline.SampleRate);
+        Footer->SetNumberField(TEXT("audioChannels"), AudioTimeline.NumChannels);
+        Footer->SetNumberField(TEXT("audioOffsetSamples"), static_cast<double>(Summary.AudioOffsetSamples));
+        Footer->SetNumberField(TEXT("audioFrames"), static_cast<double>(AudioTimeline.FramesWritten));
+        Footer->SetNumberField(TEXT("audioFramesInserted"), static_cast<double>(AudioTimeline.FramesInserted));
+        Footer->SetNumberField(TEXT("audioFramesDropped"), static_cast<double>(AudioTimeline.FramesDropped));
+        Footer->SetNumberField(TEXT("audioMaxDriftMs"), AudioTimeline.MaxDriftMilliseconds);
+    }
+
+    int32 TotalDrops = 0;
+    TSharedRef<FJsonObject> DropCauses = MakeShared<FJsonObject>();
+    for (int32 CauseIndex = 0; CauseIndex < static_cast<int32>(EOmniCaptureDropCause::Count); ++CauseIndex)
+    {
+        TotalDrops += DropsByCause[CauseIndex];
+        DropCauses->SetNumberField(StaticEnum<EOmniCaptureDropCause>()->GetNameStringByValue(CauseIndex), DropsByCause[CauseIndex]);
+    }
+    TSharedRef<FJsonObject> DropBottlenecks = MakeShared<FJsonObject>();
+    int32 DominantBottleneck = 0;
+    for (int32 BottleneckIndex = 0; BottleneckIndex < UE_ARRAY_COUNT(DropsByBottleneck); ++BottleneckIndex)
+    {
+        DropBottlenecks->SetNumberField(StaticEnum<EOmniCaptureBottleneck>()->GetNameStringByValue(BottleneckIndex), DropsByBottleneck[BottleneckIndex]);
+        if (DropsByBottleneck[BottleneckIndex] > DropsByBottleneck[DominantBottleneck])
+        {
+            DominantBottleneck = BottleneckIndex;
+        }
+    }
+    Footer->SetNumberField(TEXT("droppedFrames"), TotalDrops);
+    Footer->SetObjectField(TEXT("dropsByCause"), DropCauses);
+    Footer->SetObjectField(TEXT("dropsByBottleneck"), DropBottlenecks);
+    if (TotalDrops > 0)
+    {
+        Footer->SetStringField(TEXT("dropBottleneck"), StaticEnum<EOmniCaptureBottleneck>()->GetNameStringByValue(DominantBottleneck));
+    }
+
+    if (ManifestWriter.Close(Footer))
+    {
+        Summary.ManifestPath = ManifestWriter.GetManifestPath();
+        UE_LOG(LogTemp, Log, TEXT("OmniCapture manifest written to %s (%d frames)"), *Summary.ManifestPath, Timing.FrameCount);
+    }
+
+    FrameStore.Reset();
+    return Summary;
+}
+
+bool FOmniCaptureMuxer::FinalizeCapture(const FOmniCaptureSettings& Settings, const FOmniCaptureManifestSummary& Summary, const FString& AudioPath, const FString& VideoPath, FOmniCaptureMuxJobDesc& OutJob)
+{
+    OutJob = FOmniCaptureMuxJobDesc();
+
+    // A fragmented MP4 from the encoder is already the deliverable; without audio to add there
+    // is nothing for FFmpeg to do.
+    const bool bFragmentedVideo = Settings.OutputFormat == EOmniOutputFormat::NVENCHardware && IsFragmentedMP4(VideoPath);
+    const bool bHasAudio = !AudioPath.IsEmpty() && FPaths::FileExists(AudioPath);
+    if (bFragmentedVideo && !bHasAudio)
+    {
+        const FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
+        if (!IFileManager::Get().Move(*OutputFile, *VideoPath, /*bReplace=*/true))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Unable to move fragmented MP4 %s to %s."), *VideoPath, *OutputFile);
+        }
+        return !Summary.ManifestPath.IsEmpty();
     }
 
-    OutManifestPath = OutputDirectory / (BaseFileName + TEXT("_Manifest.json"));
-    return FFileHelper::SaveStringToFile(OutputString, *OutManifestPath);
+    BuildFFmpegJob(Settings, Summary, AudioPath, VideoPath, OutJob);
+
+    return !Summary.ManifestPath.IsEmpty();
 }
 
-bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath) const
+bool FOmniCaptureMuxer::BuildFFmpegJob(const FOmniCaptureSettings& Settings, const FOmniCaptureManifestSummary& Summary, const FString& AudioPath, const FString& VideoPath, FOmniCaptureMuxJobDesc& OutJob) const
 {
-    if (Frames.Num() == 0)
+    if (Summary.Timing.FrameCount == 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("No frames captured; skipping FFmpeg mux."));
         return false;
@@ -213,7 +382,7 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         return false;
     }
 
-    const double FrameRate = CalculateFrameRate(Frames);
+    const double FrameRate = Summary.Timing.GetFrameRate();
     const double EffectiveFrameRate = FrameRate <= 0.0 ? 30.0 : FrameRate;
 
     FString ColorSpaceArg = TEXT("bt709");
@@ -242,30 +411,96 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
     FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
     FString CommandLine;
 
-    if (Settings.OutputFormat == EOmniOutputFormat::PNGSequence)
+    int32 NumTileInputs = 0;
+    // In PNG mode the subsystem only passes a video path when the live mux finalized cleanly.
+    const bool bLiveIntermediate = Settings.OutputFormat == EOmniOutputFormat::PNGSequence && Settings.bLiveFFmpegMux && !VideoPath.IsEmpty();
+
+    if (bLiveIntermediate)
+    {
+        CommandLine = FString::Printf(TEXT("-y -i \"%s\""), *VideoPath);
+    }
+    else if (Settings.OutputFormat == EOmniOutputFormat::PNGSequence)
     {
         FString Pattern = OutputDirectory / FString::Printf(TEXT("%s_%%06d.png"), *BaseFileName);
-        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *Pattern);
+        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -start_number %d -i \"%s\""), EffectiveFrameRate, FindFirstPNGFrameNumber(OutputDirectory, BaseFileName), *Pattern);
     }
-    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware || Settings.OutputFormat == EOmniOutputFormat::SoftwareEncoder)
     {
         const FString BitstreamPath = !VideoPath.IsEmpty() ? VideoPath : (OutputDirectory / (BaseFileName + TEXT(".h264")));
         if (!FPaths::FileExists(BitstreamPath))
         {
-            UE_LOG(LogTemp, Warning, TEXT("NVENC bitstream %s not found; skipping FFmpeg mux."), *BitstreamPath);
+            UE_LOG(LogTemp, Warning, TEXT("Encoded bitstream %s not found; skipping FFmpeg mux."), *BitstreamPath);
             return false;
         }
 
-        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *BitstreamPath);
+        if (IsTileManifest(BitstreamPath))
+        {
+            CommandLine = TEXT("-y");
+            NumTileInputs = AppendTileInputs(BitstreamPath, EffectiveFrameRate, CommandLine);
+            if (NumTileInputs == 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Tile manifest %s could not be read; skipping FFmpeg mux."), *BitstreamPath);
+                return false;
+            }
+        }
+        else
+        {
+            // Fragmented MP4 already carries per-sample timing; only raw Annex B needs a rate.
+            CommandLine = IsFragmentedMP4(BitstreamPath)
+                ? FString::Printf(TEXT("-y -i \"%s\""), *BitstreamPath)
+                : FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *BitstreamPath);
+        }
     }
     else
     {
         return false;
     }
 
-    if (!AudioPath.IsEmpty() && FPaths::FileExists(AudioPath))
+    const bool bHasAudioInput = !AudioPath.IsEmpty() && FPaths::FileExists(AudioPath);
+    if (bHasAudioInput)
     {
-        CommandLine += FString::Printf(TEXT(" -i \"%s\" -c:a aac -b:a 192k"), *AudioPath);
+        const bool bEncodedAudio = !FPaths::GetExtension(AudioPath).Equals(TEXT("wav"), ESearchCase::IgnoreCase);
+        if (bEncodedAudio)
+        {
+            // Already encoded by the streaming audio encoder, so only shift and copy it.
+            const double OffsetSeconds = Summary.AudioSampleRate > 0 ? static_cast<double>(Summary.AudioOffsetSamples) / Summary.AudioSampleRate : 0.0;
+            if (OffsetSeconds > 0.0)
+            {
+                CommandLine += FString::Printf(TEXT(" -itsoffset %.9f"), OffsetSeconds);
+            }
+            else if (OffsetSeconds < 0.0)
+            {
+                CommandLine += FString::Printf(TEXT(" -ss %.9f"), -OffsetSeconds);
+            }
+            CommandLine += FString::Printf(TEXT(" -i \"%s\" -c:a copy"), *AudioPath);
+            if (FPaths::GetExtension(AudioPath).Equals(TEXT("opus"), ESearchCase::IgnoreCase))
+            {
+                CommandLine += TEXT(" -strict experimental");
+            }
+        }
+        else
+        {
+            CommandLine += FString::Printf(TEXT(" -i \"%s\""), *AudioPath);
+            if (Settings.AmbisonicOrder == EOmniCaptureAmbisonicOrder::ThirdOrder)
+            {
+                // AAC tops out at 8 channels, so third-order AmbiX goes to Opus with discrete channel mapping.
+                CommandLine += FString::Printf(TEXT(" -c:a libopus -mapping_family 255 -b:a %dk -strict experimental"), FMath::Max(32, Settings.AudioBitrateKbps));
+            }
+            else
+            {
+                CommandLine += FString::Printf(TEXT(" -c:a aac -b:a %dk"), FMath::Max(32, Settings.AudioBitrateKbps));
+            }
+
+            // Align the audio start to the first frame in samples rather than relying on -shortest.
+            if (Summary.AudioOffsetSamples > 0)
+            {
+                CommandLine += FString::Printf(TEXT(" -af \"adelay=%lldS:all=1\""), Summary.AudioOffsetSamples);
+            }
+            else if (Summary.AudioOffsetSamples < 0)
+            {
+                CommandLine += FString::Printf(TEXT(" -af \"atrim=start_sample=%lld,asetpts=PTS-STARTPTS\""), -Summary.AudioOffsetSamples);
+            }
+        }
     }
     else
     {
@@ -282,12 +517,44 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         StereoMode = Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom ? TEXT("top-bottom") : TEXT("left-right");
     }
 
-    if (Settings.OutputFormat == EOmniOutputFormat::PNGSequence)
+    if (bLiveIntermediate)
+    {
+        CommandLine += TEXT(" -c:v copy");
+    }
+    else if (Settings.OutputFormat == EOmniOutputFormat::PNGSequence)
     {
         const TCHAR* CodecName = Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("libx265") : TEXT("libx264");
         CommandLine += FString::Printf(TEXT(" -c:v %s -pix_fmt %s"), CodecName, *PixelFormatArg);
+
+        const int32 GOPLength = Summary.Timing.MeanKeyFrameInterval > 0.0 ? FMath::RoundToInt(Summary.Timing.MeanKeyFrameInterval) : Settings.Quality.GOPLength;
+        if (GOPLength > 0)
+        {
+            CommandLine += FString::Printf(TEXT(" -g %d"), GOPLength);
+        }
     }
-    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    else if (NumTileInputs > 0)
+    {
+        // Tile columns are separate streams, so stitching them back means one re-encode.
+        FString StitchFilter = FString::Printf(TEXT("hstack=inputs=%d"), NumTileInputs);
+        const FString ROIFilter = FOmniCaptureSoftwareEncoder::BuildLatitudeROIFilter(Settings);
+        if (!ROIFilter.IsEmpty())
+        {
+            StitchFilter += TEXT(",") + ROIFilter;
+        }
+        CommandLine += FString::Printf(TEXT(" -filter_complex \"%s[v]\" -map \"[v]\""), *StitchFilter);
+        if (bHasAudioInput)
+        {
+            CommandLine += FString::Printf(TEXT(" -map %d:a"), NumTileInputs);
+        }
+
+        const TCHAR* CodecName = Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("libx265") : TEXT("libx264");
+        CommandLine += FString::Printf(TEXT(" -c:v %s -preset %s -pix_fmt %s %s"), CodecName, *Settings.SoftwareEncoderPreset, *PixelFormatArg, *FOmniCaptureSoftwareEncoder::BuildRateControlArguments(Settings));
+        if (Settings.Quality.GOPLength > 0)
+        {
+            CommandLine += FString::Printf(TEXT(" -g %d"), Settings.Quality.GOPLength);
+        }
+    }
+    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware || Settings.OutputFormat == EOmniOutputFormat::SoftwareEncoder)
     {
         CommandLine += TEXT(" -c:v copy");
     }
@@ -300,32 +567,21 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         CommandLine += TEXT(" -vsync cfr");
     }
 
-    if (Settings.bEnableFastStart)
+    // Spatial audio metadata is appended to moov after muxing, which needs moov to stay at the end of the file.
+    if (Settings.bEnableFastStart && Settings.AmbisonicOrder == EOmniCaptureAmbisonicOrder::None)
     {
         CommandLine += TEXT(" -movflags +faststart");
     }
 
-    CommandLine += FString::Printf(TEXT(" -shortest \"%s\""), *OutputFile);
-
-    UE_LOG(LogTemp, Log, TEXT("Invoking FFmpeg: %s %s"), *Binary, *CommandLine);
-
-    FProcHandle ProcHandle = FPlatformProcess::CreateProc(*Binary, *CommandLine, true, true, true, nullptr, 0, *OutputDirectory, nullptr);
-    if (!ProcHandle.IsValid())
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Failed to launch FFmpeg process."));
-        return false;
-    }
-
-    FPlatformProcess::WaitForProc(ProcHandle);
-    int32 ReturnCode = 0;
-    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
-    if (ReturnCode != 0)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("FFmpeg returned non-zero exit code %d"), ReturnCode);
-        return false;
-    }
+    CommandLine += FString::Printf(TEXT(" -threads %d -progress pipe:1 -nostats"), FMath::Max(1, Settings.MuxThreadsPerJob));
+    CommandLine += FString::Printf(TEXT(" -t %.6f \"%s\""), Summary.Timing.FrameCount / EffectiveFrameRate, *OutputFile);
 
-    UE_LOG(LogTemp, Log, TEXT("FFmpeg muxing complete: %s"), *OutputFile);
+    OutJob.Binary = Binary;
+    OutJob.Arguments = CommandLine;
+    OutJob.WorkingDirectory = OutputDirectory;
+    OutJob.OutputFile = OutputFile;
+    OutJob.TotalFrames = Summary.Timing.FrameCount;
+    OutJob.DurationSeconds = Summary.Timing.FrameCount / EffectiveFrameRate;
     return true;
 }
 
@@ -333,19 +589,3 @@ FString FOmniCaptureMuxer::BuildFFmpegBinaryPath() const
 {
     return ResolveFFmpegBinary(FOmniCaptureSettings());
 }
-
-double FOmniCaptureMuxer::CalculateFrameRate(const TArray<FOmniCaptureFrameMetadata>& Frames) const
-{
-    if (Frames.Num() < 2)
-    {
-        return 30.0;
-    }
-
-    double Duration = Frames.Last().Timecode - Frames[0].Timecode;
-    if (Duration <= 0.0)
-    {
-        return 30.0;
-    }
-
-    return static_cast<double>(Frames.Num() - 1) / Duration;
-}
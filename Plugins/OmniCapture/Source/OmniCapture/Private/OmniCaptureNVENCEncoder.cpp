@@ -1,7 +1,14 @@
 #include "OmniCaptureNVENCEncoder.h"
 
+#include "OmniCaptureBitstreamWriter.h"
+#include "OmniCaptureFragmentedMP4Writer.h"
+
 #include "HAL/PlatformFileManager.h"
 #include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
 #include "OmniCaptureTypes.h"
@@ -22,7 +29,122 @@
 
 namespace
 {
+    // Frames that can sit between conversion and a finished packet before new frames
+    // fall back to one-off input frames.
+    constexpr int32 NVENCFramesInFlight = 4;
+
 #if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    // Emits an Annex B frame packing arrangement SEI (payload 45) for a top-bottom or side-by-side
+    // stereo picture. H.264 and HEVC share the payload apart from the persistence field.
+    void BuildFramePackingSEI(bool bHEVC, bool bTopBottom, TArray<uint8>& OutNal)
+    {
+        TArray<uint8> Payload;
+        uint32 BitBuffer = 0;
+        int32 BitCount = 0;
+        auto PutBits = [&Payload, &BitBuffer, &BitCount](uint32 Value, int32 NumBits)
+        {
+            for (int32 Bit = NumBits - 1; Bit >= 0; --Bit)
+            {
+                BitBuffer = (BitBuffer << 1) | ((Value >> Bit) & 1u);
+                if (++BitCount == 8)
+                {
+                    Payload.Add(static_cast<uint8>(BitBuffer));
+                    BitBuffer = 0;
+                    BitCount = 0;
+                }
+            }
+        };
+
+        PutBits(1, 1);                      // frame_packing_arrangement_id ue(0)
+        PutBits(0, 1);                      // cancel_flag
+        PutBits(bTopBottom ? 4 : 3, 7);     // arrangement type
+        PutBits(0, 1);                      // quincunx_sampling_flag
+        PutBits(1, 6);                      // content_interpretation_type: frame 0 is the left view
+        PutBits(0, 6);                      // flipping, field views, frame0 and self-contained flags
+        PutBits(0, 16);                     // grid positions
+        PutBits(0, 8);                      // reserved byte
+        if (bHEVC)
+        {
+            PutBits(1, 1);                  // persistence_flag
+            PutBits(0, 1);                  // upsampled_aspect_ratio_flag
+        }
+        else
+        {
+            PutBits(2, 3);                  // repetition_period ue(1): persists for the sequence
+            PutBits(0, 1);                  // extension_flag
+        }
+        if (BitCount > 0)
+        {
+            PutBits(1, 1);                  // payload alignment
+            while (BitCount > 0)
+            {
+                PutBits(0, 1);
+            }
+        }
+
+        TArray<uint8> Rbsp;
+        if (bHEVC)
+        {
+            Rbsp.Append({ 0x4E, 0x01 });    // PREFIX_SEI_NUT, layer 0, temporal id 0
+        }
+        else
+        {
+            Rbsp.Add(0x06);
+        }
+        Rbsp.Add(45);
+        Rbsp.Add(static_cast<uint8>(Payload.Num()));
+        Rbsp.Append(Payload);
+        Rbsp.Add(0x80);
+
+        OutNal = { 0x00, 0x00, 0x00, 0x01 };
+        int32 Zeros = 0;
+        for (int32 Index = 0; Index < Rbsp.Num(); ++Index)
+        {
+            const uint8 Byte = Rbsp[Index];
+            if (Zeros >= 2 && Byte <= 0x03)
+            {
+                OutNal.Add(0x03);
+                Zeros = 0;
+            }
+            OutNal.Add(Byte);
+            Zeros = Byte == 0 ? Zeros + 1 : 0;
+        }
+    }
+
+    // Offset of the start code of the access unit's first slice if that slice is a random access
+    // point, or INDEX_NONE. The SEI has to precede it and follow the parameter sets.
+    int32 FindRandomAccessSlice(const TArray<uint8>& AnnexB, bool bHEVC)
+    {
+        for (int32 Index = 0; Index + 3 < AnnexB.Num(); ++Index)
+        {
+            if (AnnexB[Index] != 0 || AnnexB[Index + 1] != 0 || AnnexB[Index + 2] != 1)
+            {
+                continue;
+            }
+
+            const int32 StartCode = Index > 0 && AnnexB[Index - 1] == 0 ? Index - 1 : Index;
+            const uint8 Header = AnnexB[Index + 3];
+            if (bHEVC)
+            {
+                const uint8 Type = (Header >> 1) & 0x3F;
+                if (Type < 32)
+                {
+                    return Type >= 16 && Type <= 23 ? StartCode : INDEX_NONE;
+                }
+            }
+            else
+            {
+                const uint8 Type = Header & 0x1F;
+                if (Type >= 1 && Type <= 5)
+                {
+                    return Type == 5 ? StartCode : INDEX_NONE;
+                }
+            }
+            Index += 3;
+        }
+        return INDEX_NONE;
+    }
+
     AVEncoder::EVideoFormat ToVideoFormat(EOmniCaptureColorFormat Format)
     {
         switch (Format)
@@ -39,6 +161,36 @@ namespace
 #endif
 }
 
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+class FOmniNVENCSubmitWorker final : public FRunnable
+{
+public:
+    FOmniNVENCSubmitWorker(FOmniCaptureNVENCEncoder& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        // Short wait: fences are polled, so this bounds how long a finished frame waits for NVENC.
+        while (bRunning.Load())
+        {
+            Owner.SubmitReadyFrames();
+            WakeEvent->Wait(1);
+        }
+
+        return 0;
+    }
+
+private:
+    FOmniCaptureNVENCEncoder& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+#endif
+
 FOmniCaptureNVENCEncoder::FOmniCaptureNVENCEncoder()
 {
 }
@@ -112,13 +264,15 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
 
     RequestedCodec = Settings.Codec;
     const bool bUseHEVC = RequestedCodec == EOmniCaptureCodec::HEVC;
-    OutputFilePath = Directory / (Settings.OutputFileName + (bUseHEVC ? TEXT(".h265") : TEXT(".h264")));
+    const TCHAR* Extension = Settings.bFragmentedMP4 ? TEXT("_video.mp4") : (bUseHEVC ? TEXT(".h265") : TEXT(".h264"));
+    OutputFilePath = Directory / (Settings.OutputFileName + Extension);
     ColorFormat = Settings.NVENCColorFormat;
     bZeroCopyRequested = Settings.bZeroCopy;
 
 #if WITH_OMNI_NVENC && PLATFORM_WINDOWS
-    const int32 OutputWidth = Settings.Resolution * 2;
-    const int32 OutputHeight = Settings.Mode == EOmniCaptureMode::Stereo ? Settings.Resolution * 2 : Settings.Resolution;
+    const FIntPoint EncodeSize = GetEncodeSize(Settings);
+    const int32 OutputWidth = EncodeSize.X;
+    const int32 OutputHeight = EncodeSize.Y;
 
     if (!FModuleManager::Get().IsModuleLoaded(TEXT("AVEncoder")))
     {
@@ -148,6 +302,36 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
     LayerConfig.MaxBitrate = FMath::Max<int32>(LayerConfig.TargetBitrate, Settings.Quality.MaxBitrateKbps * 1000);
     LayerConfig.MinQp = 0;
     LayerConfig.MaxQp = 51;
+    switch (Settings.Quality.RateControlMode)
+    {
+    case EOmniCaptureRateControlMode::ConstantQP:
+        // Pinning the QP range is how AVEncoder expresses a fixed QP.
+        LayerConfig.RateControlMode = AVEncoder::FVideoEncoder::RateControlMode::CONSTQP;
+        LayerConfig.MinQp = FMath::Clamp(Settings.Quality.ConstantQP, 0, 51);
+        LayerConfig.MaxQp = LayerConfig.MinQp;
+        break;
+    case EOmniCaptureRateControlMode::Lossless:
+        LayerConfig.RateControlMode = AVEncoder::FVideoEncoder::RateControlMode::CONSTQP;
+        LayerConfig.MinQp = 0;
+        LayerConfig.MaxQp = 0;
+        break;
+    case EOmniCaptureRateControlMode::VariableBitrate:
+        // Full-resolution two-pass is NVENC's high-quality VBR; the first pass doubles as lookahead.
+        LayerConfig.RateControlMode = AVEncoder::FVideoEncoder::RateControlMode::VBR;
+        LayerConfig.MultipassMode = AVEncoder::FVideoEncoder::MultipassMode::FULL;
+        break;
+    case EOmniCaptureRateControlMode::ConstantBitrate:
+    default:
+        LayerConfig.RateControlMode = AVEncoder::FVideoEncoder::RateControlMode::CBR;
+        LayerConfig.MaxBitrate = LayerConfig.TargetBitrate;
+        LayerConfig.MultipassMode = Settings.Quality.bLowLatency ? AVEncoder::FVideoEncoder::MultipassMode::DISABLED : AVEncoder::FVideoEncoder::MultipassMode::QUARTER;
+        break;
+    }
+
+    if (Settings.Quality.bLatitudeAdaptiveQuantization)
+    {
+        UE_LOG(LogTemp, Log, TEXT("NVENC through AVEncoder takes no per-region QP; latitude adaptive quantization is skipped."));
+    }
 
     CodecConfig = AVEncoder::FVideoEncoder::FCodecConfig();
     CodecConfig.bLowLatency = Settings.Quality.bLowLatency;
@@ -162,17 +346,56 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
 
     auto OnEncodedPacket = AVEncoder::FVideoEncoder::FOnEncodedPacket::CreateLambda([this](const AVEncoder::FVideoEncoder::FEncodedPacket& Packet)
     {
-        FScopeLock Lock(&EncoderCS);
-        if (!BitstreamFile)
+        {
+            FScopeLock Lock(&EncoderCS);
+
+            // Packets carry no input handle. With B-frames an input can still be referenced until
+            // ReorderDepth later packets arrive, so slots are returned that far behind.
+            if (InFlightSlots.Num() > ReorderDepth)
+            {
+                InFlightSlots.RemoveAt(0, 1, EAllowShrinking::No);
+            }
+
+            // Packets echo the input timestamp, which keys the submit time even after reordering.
+            double SubmitTime = 0.0;
+            if (SubmitTimes.RemoveAndCopyValue(Packet.Timestamp.GetTicks() / ETimespan::TicksPerMicrosecond, SubmitTime))
+            {
+                RecordLatency(LatencyStats, FPlatformTime::Seconds() - SubmitTime);
+            }
+            LatencyStats.PendingFrames = SubmitTimes.Num();
+        }
+
+        // Callbacks are serialized by the encoder, so the scratch buffer needs no lock and the
+        // writer only copies into its front buffer; disk I/O happens on the writer thread.
+        if (!BitstreamWriter && !FragmentedWriter)
         {
             return;
         }
 
         AnnexBBuffer.Reset();
         Packet.ToAnnexB(AnnexBBuffer);
-        if (AnnexBBuffer.Num() > 0)
+        if (AnnexBBuffer.Num() == 0)
+        {
+            return;
+        }
+
+        if (FramePackingSEI.Num() > 0)
+        {
+            const int32 SliceOffset = FindRandomAccessSlice(AnnexBBuffer, RequestedCodec == EOmniCaptureCodec::HEVC);
+            if (SliceOffset != INDEX_NONE)
+            {
+                AnnexBBuffer.Insert(FramePackingSEI, SliceOffset);
+            }
+        }
+
+        if (FragmentedWriter)
+        {
+            // The packet carries the input's timestamp back, so B-frame reordering keeps exact PTS.
+            FragmentedWriter->WriteSample(AnnexBBuffer.GetData(), AnnexBBuffer.Num(), Packet.Timestamp.GetTotalSeconds());
+        }
+        else
         {
-            BitstreamFile->Write(AnnexBBuffer.GetData(), AnnexBBuffer.Num());
+            BitstreamWriter->AppendPacket(AnnexBBuffer.GetData(), AnnexBBuffer.Num());
         }
     });
 
@@ -184,10 +407,66 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
         return;
     }
 
-    BitstreamFile.Reset(PlatformFile.OpenWrite(*OutputFilePath, /*bAppend=*/false));
-    if (!BitstreamFile)
+    if (Settings.bFragmentedMP4)
+    {
+        FOmniCaptureFMP4Config FMP4Config;
+        FMP4Config.Codec = RequestedCodec;
+        FMP4Config.Width = OutputWidth;
+        FMP4Config.Height = OutputHeight;
+        FMP4Config.BitDepth = ColorFormat == EOmniCaptureColorFormat::P010 ? 10 : 8;
+        FMP4Config.FrameRate = Settings.TargetFrameRate;
+        FMP4Config.Mode = Settings.Mode;
+        FMP4Config.StereoLayout = Settings.StereoLayout;
+        FMP4Config.ColorSpace = Settings.ColorSpace;
+
+        FragmentedWriter = MakeUnique<FOmniCaptureFragmentedMP4Writer>();
+        if (!FragmentedWriter->Open(OutputFilePath, FMP4Config))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Unable to open NVENC fragmented MP4 output file."));
+            FragmentedWriter.Reset();
+        }
+    }
+    else
+    {
+        BitstreamWriter = MakeUnique<FOmniCaptureBitstreamWriter>();
+        if (!BitstreamWriter->Open(OutputFilePath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Unable to open NVENC bitstream output file."));
+            BitstreamWriter.Reset();
+        }
+    }
+
+    // A side-by-side column tile holds only part of one eye, so it must not claim to be a pair.
+    FramePackingSEI.Reset();
+    const bool bTopBottom = Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom;
+    if (Settings.Mode == EOmniCaptureMode::Stereo && Settings.bSignalStereoFramePacking && (bTopBottom || EncodeRegion.Area() == 0))
     {
-        UE_LOG(LogTemp, Warning, TEXT("Unable to open NVENC bitstream output file."));
+        BuildFramePackingSEI(bUseHEVC, bTopBottom, FramePackingSEI);
+    }
+
+    ReorderDepth = FMath::Max(0, Settings.Quality.BFrames);
+    InputSlots.Reset();
+    InFlightSlots.Reset();
+    SubmitTimes.Reset();
+    LatencyStats = FOmniCaptureEncoderLatencyStats();
+    for (int32 SlotIndex = 0; SlotIndex < NVENCFramesInFlight + ReorderDepth; ++SlotIndex)
+    {
+        InputSlots.Add(MakeShared<FOmniNVENCInputSlot, ESPMode::ThreadSafe>());
+    }
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+
+    bSubmitRunning = true;
+    SubmitWorker = new FOmniNVENCSubmitWorker(*this, WakeEvent, bSubmitRunning);
+    SubmitThread = FRunnableThread::Create(SubmitWorker, TEXT("OmniCaptureNVENCSubmit"), 0, TPri_AboveNormal);
+    if (!SubmitThread)
+    {
+        bSubmitRunning = false;
+        delete SubmitWorker;
+        SubmitWorker = nullptr;
     }
 
     bInitialized = true;
@@ -197,17 +476,35 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
 #endif
 }
 
-void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
+TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> FOmniCaptureNVENCEncoder::AcquireInputSlot()
 {
 #if WITH_OMNI_NVENC && PLATFORM_WINDOWS
-    if (!bInitialized || !VideoEncoder.IsValid() || !EncoderInput.IsValid())
+    if (!bInitialized)
     {
-        return;
+        return nullptr;
+    }
+
+    // Each encoder instance has a single acquiring thread (the game thread, or the ring worker for
+    // tile encoders); other owners only ever drop references, so a count of one (the pool's own)
+    // cannot race back up.
+    for (const TSharedPtr<FOmniNVENCInputSlot, ESPMode::ThreadSafe>& Slot : InputSlots)
+    {
+        if (Slot.GetSharedReferenceCount() == 1)
+        {
+            return Slot;
+        }
     }
+#endif
+
+    return nullptr;
+}
 
-    if (Frame.ReadyFence.IsValid())
+void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    if (!bInitialized || !VideoEncoder.IsValid() || !EncoderInput.IsValid())
     {
-        RHIWaitGPUFence(Frame.ReadyFence);
+        return;
     }
 
     if (Frame.bUsedCPUFallback)
@@ -221,17 +518,112 @@ void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
         return;
     }
 
+    FPendingFrame Pending;
+    Pending.Metadata = Frame.Metadata;
+    Pending.ReadyFence = Frame.ReadyFence;
+    Pending.Texture = Frame.Texture;
+    Pending.EncoderTextures = Frame.EncoderTextures;
+
+    // A slot from an encoder that has since been replaced (segment rotation) is not ours to reuse.
+    for (const TSharedPtr<FOmniNVENCInputSlot, ESPMode::ThreadSafe>& Slot : InputSlots)
+    {
+        if (Frame.EncoderSlot.IsValid() && Slot.Get() == Frame.EncoderSlot.Get())
+        {
+            Pending.Slot = Slot;
+            break;
+        }
+    }
+
+    if (!SubmitThread)
+    {
+        if (Pending.ReadyFence.IsValid())
+        {
+            RHIWaitGPUFence(Pending.ReadyFence);
+        }
+        SubmitFrame(Pending);
+        return;
+    }
+
+    {
+        FScopeLock Lock(&PendingCS);
+        PendingFrames.Add(MoveTemp(Pending));
+    }
+    WakeEvent->Trigger();
+#else
+    (void)Frame;
+#endif
+}
+
+void FOmniCaptureNVENCEncoder::SubmitReadyFrames()
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    for (;;)
+    {
+        FPendingFrame Pending;
+        {
+            FScopeLock Lock(&PendingCS);
+            if (PendingFrames.Num() == 0)
+            {
+                return;
+            }
+
+            // Submission stays in capture order, so a slow fence holds back the frames behind it.
+            if (PendingFrames[0].ReadyFence.IsValid() && !PendingFrames[0].ReadyFence->Poll())
+            {
+                return;
+            }
+
+            Pending = MoveTemp(PendingFrames[0]);
+            PendingFrames.RemoveAt(0, 1, EAllowShrinking::No);
+        }
+
+        SubmitFrame(Pending);
+    }
+#endif
+}
+
+void FOmniCaptureNVENCEncoder::SubmitFrame(FPendingFrame& Pending)
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    if (!VideoEncoder.IsValid() || !EncoderInput.IsValid())
+    {
+        return;
+    }
+
     TSharedPtr<AVEncoder::FVideoEncoderInputFrame> InputFrame;
-    if (Frame.EncoderTextures.Num() > 0)
+    if (Pending.Slot.IsValid() && Pending.EncoderTextures.Num() > 0)
+    {
+        FOmniNVENCInputSlot& Slot = *Pending.Slot;
+        if (!Slot.InputFrame.IsValid())
+        {
+            Slot.InputFrame = EncoderInput->CreateEncoderInputFrame();
+        }
+
+        // Slot planes are persistent, so binding only repeats if the converter had to reallocate them.
+        if (Slot.InputFrame.IsValid() && Slot.BoundTexture != Pending.EncoderTextures[0])
+        {
+            for (int32 PlaneIndex = 0; PlaneIndex < Pending.EncoderTextures.Num(); ++PlaneIndex)
+            {
+                if (Pending.EncoderTextures[PlaneIndex].IsValid())
+                {
+                    Slot.InputFrame->SetTexture(PlaneIndex, Pending.EncoderTextures[PlaneIndex]);
+                }
+            }
+            Slot.BoundTexture = Pending.EncoderTextures[0];
+        }
+
+        InputFrame = Slot.InputFrame;
+    }
+    else if (Pending.EncoderTextures.Num() > 0)
     {
         InputFrame = EncoderInput->CreateEncoderInputFrame();
         if (InputFrame.IsValid())
         {
-            for (int32 PlaneIndex = 0; PlaneIndex < Frame.EncoderTextures.Num(); ++PlaneIndex)
+            for (int32 PlaneIndex = 0; PlaneIndex < Pending.EncoderTextures.Num(); ++PlaneIndex)
             {
-                if (Frame.EncoderTextures[PlaneIndex].IsValid())
+                if (Pending.EncoderTextures[PlaneIndex].IsValid())
                 {
-                    InputFrame->SetTexture(PlaneIndex, Frame.EncoderTextures[PlaneIndex]);
+                    InputFrame->SetTexture(PlaneIndex, Pending.EncoderTextures[PlaneIndex]);
                 }
             }
         }
@@ -239,7 +631,7 @@ void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
 
     if (!InputFrame.IsValid())
     {
-        InputFrame = EncoderInput->CreateEncoderInputFrameFromRHITexture(Frame.Texture);
+        InputFrame = EncoderInput->CreateEncoderInputFrameFromRHITexture(Pending.Texture);
     }
 
     if (!InputFrame.IsValid())
@@ -247,13 +639,84 @@ void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
         return;
     }
 
-    InputFrame->SetTimestampUs(static_cast<uint64>(Frame.Metadata.Timecode * 1'000'000.0));
-    InputFrame->SetFrameIndex(Frame.Metadata.FrameIndex);
-    InputFrame->SetKeyFrame(Frame.Metadata.bKeyFrame);
+    const int64 TimestampUs = static_cast<int64>(Pending.Metadata.Timecode * 1'000'000.0);
+    InputFrame->SetTimestampUs(static_cast<uint64>(TimestampUs));
+    InputFrame->SetFrameIndex(Pending.Metadata.FrameIndex);
+    InputFrame->SetKeyFrame(Pending.Metadata.bKeyFrame);
+
+    {
+        // Unpooled frames push an empty entry so packet accounting stays aligned.
+        FScopeLock Lock(&EncoderCS);
+        InFlightSlots.Add(Pending.Slot);
+        SubmitTimes.Add(TimestampUs, FPlatformTime::Seconds());
+    }
 
     VideoEncoder->Encode(InputFrame);
 #else
-    (void)Frame;
+    (void)Pending;
+#endif
+}
+
+FOmniCaptureBitstreamStats FOmniCaptureNVENCEncoder::GetBitstreamStats() const
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    if (FragmentedWriter)
+    {
+        return FragmentedWriter->GetStats();
+    }
+
+    if (BitstreamWriter)
+    {
+        return BitstreamWriter->GetStats();
+    }
+#endif
+
+    return LastBitstreamStats;
+}
+
+FOmniCaptureEncoderLatencyStats FOmniCaptureNVENCEncoder::GetLatencyStats() const
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    FScopeLock Lock(&EncoderCS);
+#endif
+    return LatencyStats;
+}
+
+void FOmniCaptureNVENCEncoder::StopSubmitWorker()
+{
+#if WITH_OMNI_NVENC && PLATFORM_WINDOWS
+    if (SubmitThread)
+    {
+        bSubmitRunning = false;
+        WakeEvent->Trigger();
+        SubmitThread->WaitForCompletion();
+        delete SubmitThread;
+        SubmitThread = nullptr;
+        delete SubmitWorker;
+        SubmitWorker = nullptr;
+    }
+
+    TArray<FPendingFrame> Remaining;
+    {
+        FScopeLock Lock(&PendingCS);
+        Remaining = MoveTemp(PendingFrames);
+        PendingFrames.Reset();
+    }
+
+    for (FPendingFrame& Pending : Remaining)
+    {
+        if (Pending.ReadyFence.IsValid())
+        {
+            RHIWaitGPUFence(Pending.ReadyFence);
+        }
+        SubmitFrame(Pending);
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
 #endif
 }
 
@@ -265,13 +728,31 @@ void FOmniCaptureNVENCEncoder::Finalize()
         return;
     }
 
+    StopSubmitWorker();
+
     VideoEncoder.Reset();
     EncoderInput.Reset();
 
-    if (BitstreamFile)
     {
-        BitstreamFile->Flush();
-        BitstreamFile.Reset();
+        FScopeLock Lock(&EncoderCS);
+        InFlightSlots.Reset();
+        SubmitTimes.Reset();
+    }
+    InputSlots.Reset();
+
+    if (BitstreamWriter)
+    {
+        LastBitstreamStats = BitstreamWriter->GetStats();
+        BitstreamWriter->Close();
+        BitstreamWriter.Reset();
+    }
+
+    if (FragmentedWriter)
+    {
+        // Flushes the last GOP as its own fragment; everything before it is already playable.
+        FragmentedWriter->Close();
+        LastBitstreamStats = FragmentedWriter->GetStats();
+        FragmentedWriter.Reset();
     }
 
     bInitialized = false;
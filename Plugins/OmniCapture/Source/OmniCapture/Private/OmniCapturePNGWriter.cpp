@@ -1,5 +1,7 @@
 #include "OmniCapturePNGWriter.h"
 
+#include "OmniCaptureStageTimings.h"
+
 #include "ImageWriteQueue/Public/ImageWriteQueue.h"
 #include "ImageWriteQueue/Public/ImageWriteTask.h"
 #include "Modules/ModuleManager.h"
@@ -53,10 +55,22 @@ void FOmniCapturePNGWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame,
     Task->PixelData = MoveTemp(Frame->PixelData);
     Task->bSupports16Bit = Frame->bLinearColor;
 
+    // Compression and disk I/O happen on the write queue, so the stage spans enqueue to completion.
+    const uint64 EnqueueCycles = FPlatformTime::Cycles64();
+    // The writer outlives its tasks: Flush waits for the queue before destruction.
+    Task->OnCompleted = [this, EnqueueCycles, FilePath = Task->Filename](bool bSuccess)
+    {
+        FOmniCaptureStageTimings::Get().Record(EOmniCaptureStage::PNGWrite, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - EnqueueCycles));
+        if (bSuccess)
+        {
+            BytesWritten += FMath::Max<int64>(IFileManager::Get().FileSize(*FilePath), 0);
+            ++FramesWritten;
+        }
+        --PendingWrites;
+    };
+
+    ++PendingWrites;
     ImageWriteQueue->Enqueue(MoveTemp(Task));
-
-    FScopeLock Lock(&MetadataCS);
-    CapturedMetadata.Add(Frame->Metadata);
 }
 
 void FOmniCapturePNGWriter::Flush()
@@ -67,12 +81,3 @@ void FOmniCapturePNGWriter::Flush()
         ImageWriteQueue = nullptr;
     }
 }
-
-TArray<FOmniCaptureFrameMetadata> FOmniCapturePNGWriter::ConsumeCapturedFrames()
-{
-    FScopeLock Lock(&MetadataCS);
-    TArray<FOmniCaptureFrameMetadata> Result = MoveTemp(CapturedMetadata);
-    CapturedMetadata.Reset();
-    return Result;
-}
-
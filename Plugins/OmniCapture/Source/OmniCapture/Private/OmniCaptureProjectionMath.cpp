@@ -0,0 +1,87 @@
+#include "OmniCaptureProjectionMath.h"
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureProjectionTest, "OmniCapture.Projection.Core",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureProjectionTest::RunTest(const FString& Parameters)
+{
+    using namespace OmniCaptureProjection;
+
+    constexpr int32 Width = 512;
+    constexpr int32 Height = 256;
+    constexpr int32 FaceResolution = 128;
+
+    bool bUnitLength = true;
+    bool bRoundTrips = true;
+    bool bUVInRange = true;
+    bool bTexelInRange = true;
+    bool bSeamInset = true;
+    const double SeamMin = 0.5 / FaceResolution - 1e-9;
+    const double SeamMax = 1.0 - 0.5 / FaceResolution + 1e-9;
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; X < Width; ++X)
+        {
+            double Latitude = 0.0;
+            const FDirection Direction = DirectionFromEquirectPixel(X, Y, Width, Height, Latitude);
+            bUnitLength &= std::abs(Direction.X * Direction.X + Direction.Y * Direction.Y + Direction.Z * Direction.Z - 1.0) < 1e-9;
+
+            const FFaceUV Exact = DirectionToFaceUV(Direction, FaceResolution, 0.0);
+            const FDirection Back = FaceUVToDirection(Exact);
+            bRoundTrips &= (Direction.X * Back.X + Direction.Y * Back.Y + Direction.Z * Back.Z) > 1.0 - 1e-9;
+            bUVInRange &= Exact.Face < 6 && Exact.U >= 0.0 && Exact.U <= 1.0 && Exact.V >= 0.0 && Exact.V <= 1.0;
+
+            const FFaceUV Inset = DirectionToFaceUV(Direction, FaceResolution, 1.0);
+            bSeamInset &= Inset.U >= SeamMin && Inset.U <= SeamMax && Inset.V >= SeamMin && Inset.V <= SeamMax;
+            const int32 Texel = FaceTexelIndex(Inset, FaceResolution);
+            bTexelInRange &= Texel >= 0 && Texel < FaceResolution * FaceResolution;
+        }
+    }
+    TestTrue(TEXT("Equirect directions are unit length"), bUnitLength);
+    TestTrue(TEXT("Face UV maps back to the same direction"), bRoundTrips);
+    TestTrue(TEXT("Face index and UV stay in range"), bUVInRange);
+    TestTrue(TEXT("Full seam strength keeps UVs half a texel inside the face"), bSeamInset);
+    TestTrue(TEXT("Texel lookup stays inside the face"), bTexelInRange);
+
+    FDirection Horizon = { 1.0, 0.0, 0.0 };
+    ApplyPolarMitigation(1.0, 0.0, Horizon);
+    TestTrue(TEXT("Polar mitigation leaves the horizon untouched"), Horizon.X == 1.0 && Horizon.Y == 0.0 && Horizon.Z == 0.0);
+
+    double NearPoleLatitude = 0.0;
+    const FDirection NearPole = DirectionFromEquirectPixel(Width / 3, 1, Width, Height, NearPoleLatitude);
+    FDirection Mitigated = NearPole;
+    ApplyPolarMitigation(1.0, NearPoleLatitude, Mitigated);
+    TestTrue(TEXT("Polar mitigation bends toward the pole and stays normalized"),
+        Mitigated.Y > NearPole.Y && std::abs(Mitigated.X * Mitigated.X + Mitigated.Y * Mitigated.Y + Mitigated.Z * Mitigated.Z - 1.0) < 1e-9);
+
+    // Full per-pixel path of the CPU converter at a 4K mono equirect.
+    constexpr int32 BenchWidth = 4096;
+    constexpr int32 BenchHeight = 2048;
+    int64 Checksum = 0;
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 Y = 0; Y < BenchHeight; ++Y)
+    {
+        for (int32 X = 0; X < BenchWidth; ++X)
+        {
+            double Latitude = 0.0;
+            FDirection Direction = DirectionFromEquirectPixel(X, Y, BenchWidth, BenchHeight, Latitude);
+            ApplyPolarMitigation(0.5, Latitude, Direction);
+            const FFaceUV FaceUV = DirectionToFaceUV(Direction, 2048, 0.25);
+            Checksum += FaceUV.Face + FaceTexelIndex(FaceUV, 2048);
+        }
+    }
+    const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime, KINDA_SMALL_NUMBER);
+
+    AddInfo(FString::Printf(TEXT("Projection: %.1f Mpix/s single-threaded (%dx%d in %.3fs, checksum %lld)"),
+        (static_cast<double>(BenchWidth) * BenchHeight) / Seconds / 1.0e6, BenchWidth, BenchHeight, Seconds, Checksum));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
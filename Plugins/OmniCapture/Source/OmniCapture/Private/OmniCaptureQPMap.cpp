@@ -0,0 +1,127 @@
+#include "OmniCaptureQPMap.h"
+
+#include "OmniCaptureVideoEncoder.h"
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/AutomationTest.h"
+
+void FOmniCaptureQPMapGenerator::Configure(const FOmniCaptureSettings& Settings, const FIntRect& InRegion, int32 InBlockSize)
+{
+    Region = InRegion.Area() > 0 ? InRegion : FIntRect(FIntPoint::ZeroValue, IOmniVideoEncoder::GetEquirectSize(Settings));
+    BitDepth = Settings.ColorSpace != EOmniCaptureColorSpace::BT709 ? 10 : 8;
+
+    LatitudeMap.BlockSize = FMath::Max(4, InBlockSize);
+    LatitudeMap.BlocksX = FMath::DivideAndRoundUp(Region.Width(), LatitudeMap.BlockSize);
+    LatitudeMap.BlocksY = FMath::DivideAndRoundUp(Region.Height(), LatitudeMap.BlockSize);
+    LatitudeMap.Deltas.SetNumUninitialized(LatitudeMap.BlocksX * LatitudeMap.BlocksY);
+
+    // Latitude only depends on the row, sampled at each block's centre in full-frame coordinates.
+    for (int32 BlockY = 0; BlockY < LatitudeMap.BlocksY; ++BlockY)
+    {
+        const int32 Row = Region.Min.Y + FMath::Min(BlockY * LatitudeMap.BlockSize + LatitudeMap.BlockSize / 2, Region.Height() - 1);
+        const int8 Offset = Settings.Quality.bLatitudeAdaptiveQuantization ? static_cast<int8>(IOmniVideoEncoder::GetLatitudeQPOffset(Settings, Row)) : 0;
+        FMemory::Memset(LatitudeMap.Deltas.GetData() + BlockY * LatitudeMap.BlocksX, static_cast<uint8>(Offset), LatitudeMap.BlocksX);
+    }
+}
+
+FString FOmniCaptureQPMapGenerator::BuildROIFilter() const
+{
+    if (LatitudeMap.BlocksX == 0 || LatitudeMap.BlocksY == 0)
+    {
+        return FString();
+    }
+
+    // addroi takes a fraction of the encoder's QP range, which grows with bit depth.
+    const double QPRange = 51.0 + 6.0 * (BitDepth - 8);
+    const int32 Height = Region.Height();
+
+    // Runs of block rows with the same offset become one region each.
+    TArray<FString> Regions;
+    auto FlushRun = [this, &Regions, Height, QPRange](int32 RunStart, int32 RunEnd, int32 Offset)
+    {
+        const int32 StartRow = RunStart * LatitudeMap.BlockSize;
+        const int32 EndRow = FMath::Min(Height, RunEnd * LatitudeMap.BlockSize);
+        if (Offset != 0 && EndRow > StartRow)
+        {
+            Regions.Add(FString::Printf(TEXT("addroi=x=0:y=ih*%.6f:w=iw:h=ih*%.6f:qoffset=%.4f"),
+                static_cast<double>(StartRow) / Height,
+                static_cast<double>(EndRow - StartRow) / Height,
+                Offset / QPRange));
+        }
+    };
+
+    int32 RunStart = 0;
+    int32 RunOffset = LatitudeMap.Get(0, 0);
+    for (int32 BlockY = 1; BlockY < LatitudeMap.BlocksY; ++BlockY)
+    {
+        const int32 Offset = LatitudeMap.Get(0, BlockY);
+        if (Offset != RunOffset)
+        {
+            FlushRun(RunStart, BlockY, RunOffset);
+            RunStart = BlockY;
+            RunOffset = Offset;
+        }
+    }
+    FlushRun(RunStart, LatitudeMap.BlocksY, RunOffset);
+
+    return FString::Join(Regions, TEXT(","));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureQPMapTest, "OmniCapture.Encoder.QPMap",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureQPMapTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.Mode = EOmniCaptureMode::Mono;
+    Settings.Resolution = 1024;
+    Settings.ColorSpace = EOmniCaptureColorSpace::BT709;
+    Settings.Quality.bLatitudeAdaptiveQuantization = true;
+    Settings.Quality.MaxPolarQPOffset = 8;
+
+    FOmniCaptureQPMapGenerator Generator;
+    Generator.Configure(Settings, FIntRect());
+    const FOmniCaptureQPMap& Latitude = Generator.GetLatitudeMap();
+    if (!TestTrue(TEXT("Block grid matches a 2048x1024 equirect"), Latitude.BlocksX == 128 && Latitude.BlocksY == 64))
+    {
+        return false;
+    }
+    TestTrue(TEXT("Pole rows reach the offset cap"), Latitude.Get(0, 0) == 8 && Latitude.Get(0, Latitude.BlocksY - 1) == 8);
+    TestTrue(TEXT("Equator rows carry no offset"), Latitude.Get(0, Latitude.BlocksY / 2) == 0 && Latitude.Get(0, Latitude.BlocksY / 2 - 1) == 0);
+
+    bool bSymmetric = true;
+    bool bMonotonic = true;
+    for (int32 BlockY = 0; BlockY < Latitude.BlocksY; ++BlockY)
+    {
+        bSymmetric &= Latitude.Get(0, BlockY) == Latitude.Get(0, Latitude.BlocksY - 1 - BlockY);
+        bMonotonic &= BlockY == 0 || BlockY >= Latitude.BlocksY / 2 || Latitude.Get(0, BlockY) <= Latitude.Get(0, BlockY - 1);
+        for (int32 BlockX = 1; BlockX < Latitude.BlocksX; ++BlockX)
+        {
+            bSymmetric &= Latitude.Get(BlockX, BlockY) == Latitude.Get(0, BlockY);
+        }
+    }
+    TestTrue(TEXT("Map is constant along rows and mirrored about the equator"), bSymmetric);
+    TestTrue(TEXT("Offset never grows toward the equator"), bMonotonic);
+
+    FOmniCaptureSettings StereoSettings = Settings;
+    StereoSettings.Mode = EOmniCaptureMode::Stereo;
+    StereoSettings.StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+    FOmniCaptureQPMapGenerator StereoGenerator;
+    StereoGenerator.Configure(StereoSettings, FIntRect());
+    const FOmniCaptureQPMap& Stereo = StereoGenerator.GetLatitudeMap();
+    bool bEyesMatch = Stereo.BlocksY == Latitude.BlocksY * 2;
+    for (int32 BlockY = 0; bEyesMatch && BlockY < Latitude.BlocksY; ++BlockY)
+    {
+        bEyesMatch = Stereo.Get(0, BlockY) == Latitude.Get(0, BlockY) && Stereo.Get(0, BlockY + Latitude.BlocksY) == Latitude.Get(0, BlockY);
+    }
+    TestTrue(TEXT("Top-bottom stereo repeats the mono profile per eye"), bEyesMatch);
+
+    const FString ROIFilter = Generator.BuildROIFilter();
+    TestTrue(TEXT("ROI chain starts at the top pole and skips zero-offset rows"), ROIFilter.StartsWith(TEXT("addroi=x=0:y=ih*0.000000")) && !ROIFilter.Contains(TEXT("qoffset=0.0000")));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -83,6 +83,24 @@ void AOmniCaptureRigActor::Capture(FOmniEyeCapture& OutLeftEye, FOmniEyeCapture&
     }
 }
 
+void AOmniCaptureRigActor::SetSubpixelJitter(const FVector2D& JitterPixels)
+{
+    // A 90 degree face spans Resolution pixels, so a sub-pixel shift near the face centre is a
+    // tiny rotation of the whole eye; rotating the eye root keeps all six faces consistent.
+    const double DegreesPerPixel = 90.0 / FMath::Max(1, CachedSettings.Resolution);
+    const FRotator JitterRotation(JitterPixels.Y * DegreesPerPixel, JitterPixels.X * DegreesPerPixel, 0.0);
+
+    if (LeftEyeRoot)
+    {
+        LeftEyeRoot->SetRelativeRotation(JitterRotation);
+    }
+
+    if (RightEyeRoot)
+    {
+        RightEyeRoot->SetRelativeRotation(JitterRotation);
+    }
+}
+
 void AOmniCaptureRigActor::BuildEyeRig(EOmniCaptureEye Eye, float IPDHalfCm)
 {
     USceneComponent* EyeRoot = Eye == EOmniCaptureEye::Left ? LeftEyeRoot : RightEyeRoot;
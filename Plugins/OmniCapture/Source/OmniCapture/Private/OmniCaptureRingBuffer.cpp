@@ -101,19 +101,27 @@ void FOmniCaptureRingBuffer::Initialize(const FOmniCaptureSettings& Settings, co
     StartWorker();
 }
 
-void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
+void FOmniCaptureRingBuffer::SetBackpressureProbe(TFunction<bool()>&& InProbe)
+{
+    BackpressureProbe = MoveTemp(InProbe);
+}
+
+int32 FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
 {
     if (!Consumer)
     {
-        return;
+        return INDEX_NONE;
     }
 
+    int32 EvictedFrameIndex = INDEX_NONE;
+
     if (Capacity > 0)
     {
         for (;;)
         {
             const int32 Current = PendingCount.Load();
-            if (Current < Capacity)
+            const bool bDownstreamStalled = Current > 0 && BackpressureProbe && BackpressureProbe();
+            if (Current < Capacity && !bDownstreamStalled)
             {
                 break;
             }
@@ -128,7 +136,13 @@ void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
                         PendingCount.DecrementExchange();
                     }
                 }
-                DroppedCount.IncrementExchange();
+
+                // The consumer may have taken the oldest frame first, in which case nothing was lost.
+                if (Discarded.IsValid())
+                {
+                    EvictedFrameIndex = Discarded->Metadata.FrameIndex;
+                    DroppedCount.IncrementExchange();
+                }
                 break;
             }
             else
@@ -149,6 +163,8 @@ void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
     {
         DataEvent->Trigger();
     }
+
+    return EvictedFrameIndex;
 }
 
 void FOmniCaptureRingBuffer::Flush()
@@ -175,6 +191,13 @@ void FOmniCaptureRingBuffer::Flush()
             PendingCount.DecrementExchange();
         }
     }
+
+    // The worker only releases its count once the consumer returns, so this also waits out a frame
+    // it dequeued before we started; callers close the manifest and writers right after flushing.
+    while (PendingCount.Load() > 0)
+    {
+        FPlatformProcess::Sleep(0.0f);
+    }
 }
 
 void FOmniCaptureRingBuffer::StartWorker()
@@ -0,0 +1,571 @@
+#include "OmniCaptureSoftwareEncoder.h"
+
+#include "OmniCaptureMuxer.h"
+#include "OmniCaptureQPMap.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "ImagePixelData.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureSoftwareEncoder, Log, All);
+
+namespace
+{
+    // Rows per parallel packing task; large enough that task overhead stays negligible at 8K.
+    constexpr int32 PackRowsPerTask = 64;
+
+#if WITH_DEV_AUTOMATION_TESTS
+    // Encodes the first frames of a reference clip at a fixed CRF and returns the output size and
+    // the PSNR of the +/-18 degree horizon band against the source, or a negative size on failure.
+    int64 EncodeReferenceClip(const FString& Binary, const FString& ClipPath, int32 NumFrames, const FString& ROIFilter, const FString& OutputPath, double& OutHorizonPSNR)
+    {
+        FString Arguments = FString::Printf(TEXT("-y -loglevel error -i \"%s\" -frames:v %d -an"), *ClipPath, NumFrames);
+        if (!ROIFilter.IsEmpty())
+        {
+            Arguments += FString::Printf(TEXT(" -vf \"%s\""), *ROIFilter);
+        }
+        Arguments += FString::Printf(TEXT(" -c:v libx264 -preset medium -crf 23 \"%s\""), *OutputPath);
+
+        int32 ReturnCode = -1;
+        FString StdOut;
+        FString StdErr;
+        if (!FPlatformProcess::ExecProcess(*Binary, *Arguments, &ReturnCode, &StdOut, &StdErr) || ReturnCode != 0)
+        {
+            UE_LOG(LogOmniCaptureSoftwareEncoder, Warning, TEXT("Reference encode failed (%d): %s"), ReturnCode, *StdErr);
+            return -1;
+        }
+
+        const FString BandCrop = TEXT("crop=iw:ih*0.2:0:ih*0.4");
+        const FString PSNRArguments = FString::Printf(TEXT("-i \"%s\" -i \"%s\" -frames:v %d -lavfi \"[0:v]%s[a];[1:v]%s[b];[a][b]psnr\" -f null -"),
+            *OutputPath, *ClipPath, NumFrames, *BandCrop, *BandCrop);
+        OutHorizonPSNR = 0.0;
+        if (FPlatformProcess::ExecProcess(*Binary, *PSNRArguments, &ReturnCode, &StdOut, &StdErr) && ReturnCode == 0)
+        {
+            const int32 AverageIndex = StdErr.Find(TEXT("average:"));
+            if (AverageIndex != INDEX_NONE)
+            {
+                OutHorizonPSNR = FCString::Atod(*StdErr.Mid(AverageIndex + 8, 16));
+            }
+        }
+
+        return IFileManager::Get().FileSize(*OutputPath);
+    }
+#endif // WITH_DEV_AUTOMATION_TESTS
+}
+
+class FOmniSoftwareEncoderWorker final : public FRunnable
+{
+public:
+    FOmniSoftwareEncoderWorker(FOmniCaptureSoftwareEncoder& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning.Load())
+        {
+            Owner.DrainQueue();
+            WakeEvent->Wait(20);
+        }
+
+        Owner.DrainQueue();
+        return 0;
+    }
+
+private:
+    FOmniCaptureSoftwareEncoder& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+
+FOmniCaptureSoftwareEncoder::FOmniCaptureSoftwareEncoder()
+{
+    bRunning = false;
+}
+
+FOmniCaptureSoftwareEncoder::~FOmniCaptureSoftwareEncoder()
+{
+    Finalize();
+}
+
+bool FOmniCaptureSoftwareEncoder::IsAvailable(const FOmniCaptureSettings& Settings)
+{
+    return FOmniCaptureMuxer::IsFFmpegAvailable(Settings);
+}
+
+void FOmniCaptureSoftwareEncoder::Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory)
+{
+    ActiveSettings = Settings;
+    OutputDirectory = FPaths::ConvertRelativePathToFull(InOutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : InOutputDirectory);
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+
+    const FString BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    OutputFilePath = OutputDirectory / (BaseFileName + (Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT(".h265") : TEXT(".h264")));
+
+    FrameSize = FIntPoint::ZeroValue;
+    QueueDepth = FMath::Clamp(Settings.SoftwareEncoderQueueDepth, 1, 16);
+    StallThresholdSeconds = 2.0 / FMath::Max(1.0f, Settings.TargetFrameRate);
+    LatencyStats = FOmniCaptureEncoderLatencyStats();
+    bFailed = false;
+
+    if (!FOmniCaptureMuxer::IsFFmpegAvailable(Settings, &Binary))
+    {
+        UE_LOG(LogOmniCaptureSoftwareEncoder, Warning, TEXT("Software encoder requested but FFmpeg was not found."));
+        return;
+    }
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+    if (!SpaceEvent)
+    {
+        SpaceEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+
+    bRunning = true;
+    Worker = new FOmniSoftwareEncoderWorker(*this, WakeEvent, bRunning);
+    Thread = FRunnableThread::Create(Worker, TEXT("OmniCaptureSoftwareEncoder"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        bRunning = false;
+        delete Worker;
+        Worker = nullptr;
+    }
+
+    bInitialized = true;
+}
+
+FString FOmniCaptureSoftwareEncoder::BuildRateControlArguments(const FOmniCaptureSettings& Settings)
+{
+    const FOmniCaptureQuality& Quality = Settings.Quality;
+    const bool bHEVC = Settings.Codec == EOmniCaptureCodec::HEVC;
+    const int32 TargetKbps = FMath::Max(1, Quality.TargetBitrateKbps);
+    const int32 MaxKbps = FMath::Max(TargetKbps, Quality.MaxBitrateKbps);
+
+    FString Arguments;
+    TArray<FString> X265Params;
+    switch (Quality.RateControlMode)
+    {
+    case EOmniCaptureRateControlMode::ConstantQP:
+        Arguments = FString::Printf(TEXT("-qp %d"), FMath::Clamp(Quality.ConstantQP, 0, 51));
+        break;
+    case EOmniCaptureRateControlMode::Lossless:
+        if (bHEVC)
+        {
+            X265Params.Add(TEXT("lossless=1"));
+        }
+        else
+        {
+            Arguments = TEXT("-qp 0");
+        }
+        break;
+    case EOmniCaptureRateControlMode::VariableBitrate:
+        Arguments = FString::Printf(TEXT("-b:v %dk -maxrate %dk -bufsize %dk"), TargetKbps, MaxKbps, MaxKbps * 2);
+        break;
+    case EOmniCaptureRateControlMode::ConstantBitrate:
+    default:
+        // One second of HRD buffer at the target rate keeps the output genuinely constant.
+        Arguments = FString::Printf(TEXT("-b:v %dk -minrate %dk -maxrate %dk -bufsize %dk"), TargetKbps, TargetKbps, TargetKbps, TargetKbps);
+        if (bHEVC)
+        {
+            X265Params.Add(TEXT("strict-cbr=1"));
+        }
+        else
+        {
+            Arguments += TEXT(" -nal-hrd cbr");
+        }
+        break;
+    }
+
+    if (Quality.LookaheadFrames > 0)
+    {
+        if (bHEVC)
+        {
+            X265Params.Add(FString::Printf(TEXT("rc-lookahead=%d"), Quality.LookaheadFrames));
+        }
+        else
+        {
+            Arguments += FString::Printf(TEXT(" -rc-lookahead %d"), Quality.LookaheadFrames);
+        }
+    }
+
+    if (X265Params.Num() > 0)
+    {
+        Arguments += FString::Printf(TEXT(" -x265-params %s"), *FString::Join(X265Params, TEXT(":")));
+    }
+    return Arguments.TrimStart();
+}
+
+FString FOmniCaptureSoftwareEncoder::BuildLatitudeROIFilter(const FOmniCaptureSettings& Settings)
+{
+    const EOmniCaptureRateControlMode Mode = Settings.Quality.RateControlMode;
+    if (!Settings.Quality.bLatitudeAdaptiveQuantization || Settings.Quality.MaxPolarQPOffset <= 0
+        || Mode == EOmniCaptureRateControlMode::ConstantQP || Mode == EOmniCaptureRateControlMode::Lossless)
+    {
+        return FString();
+    }
+
+    FOmniCaptureQPMapGenerator Generator;
+    Generator.Configure(Settings, FIntRect());
+    return Generator.BuildROIFilter();
+}
+
+bool FOmniCaptureSoftwareEncoder::OpenPipe(const FIntPoint& Size, bool bLinear)
+{
+    const bool bHEVC = ActiveSettings.Codec == EOmniCaptureCodec::HEVC;
+    const bool bTenBit = ActiveSettings.ColorSpace != EOmniCaptureColorSpace::BT709;
+
+    FString Arguments = FString::Printf(TEXT("-y -loglevel error -nostats -f rawvideo -pix_fmt %s -s %dx%d -framerate %.3f -i pipe:0"),
+        bLinear ? TEXT("rgb48le") : TEXT("bgra"),
+        Size.X,
+        Size.Y,
+        FMath::Max(1.0f, ActiveSettings.TargetFrameRate));
+
+    const FString ROIFilter = BuildLatitudeROIFilter(ActiveSettings);
+    if (!ROIFilter.IsEmpty())
+    {
+        Arguments += FString::Printf(TEXT(" -vf \"%s\""), *ROIFilter);
+    }
+
+    const FString Preset = ActiveSettings.SoftwareEncoderPreset.IsEmpty() ? FString(TEXT("superfast")) : ActiveSettings.SoftwareEncoderPreset;
+    Arguments += FString::Printf(TEXT(" -c:v %s -preset %s -pix_fmt %s %s -g %d -bf %d"),
+        bHEVC ? TEXT("libx265") : TEXT("libx264"),
+        *Preset,
+        bTenBit ? TEXT("yuv420p10le") : TEXT("yuv420p"),
+        *BuildRateControlArguments(ActiveSettings),
+        FMath::Max(1, ActiveSettings.Quality.GOPLength),
+        FMath::Max(0, ActiveSettings.Quality.BFrames));
+
+    // x264 writes the frame packing SEI itself; x265 has no equivalent option. A side-by-side
+    // column tile holds only part of one eye, so it must not claim to be a pair.
+    const bool bTopBottom = ActiveSettings.StereoLayout == EOmniCaptureStereoLayout::TopBottom;
+    if (!bHEVC && ActiveSettings.Mode == EOmniCaptureMode::Stereo && ActiveSettings.bSignalStereoFramePacking && (bTopBottom || EncodeRegion.Area() == 0))
+    {
+        Arguments += FString::Printf(TEXT(" -x264-params frame-packing=%d"), bTopBottom ? 4 : 3);
+    }
+
+    // Elementary stream, so the regular NVENC mux path applies unchanged.
+    Arguments += FString::Printf(TEXT(" -threads %d -f %s \"%s\""),
+        FMath::Max(0, ActiveSettings.SoftwareEncoderThreads),
+        bHEVC ? TEXT("hevc") : TEXT("h264"),
+        *OutputFilePath);
+
+    if (!Pipe.Open(Binary, Arguments, OutputDirectory))
+    {
+        return false;
+    }
+
+    FrameSize = Size;
+    bLinearInput = bLinear;
+    UE_LOG(LogOmniCaptureSoftwareEncoder, Log, TEXT("Software encoder ready (%dx%d, %s, preset %s)."), Size.X, Size.Y, bHEVC ? TEXT("x265") : TEXT("x264"), *Preset);
+    return true;
+}
+
+void FOmniCaptureSoftwareEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
+{
+    if (!bInitialized || !Frame.PixelData.IsValid())
+    {
+        return;
+    }
+
+    {
+        FScopeLock Lock(&QueueCS);
+        if (bFailed)
+        {
+            return;
+        }
+    }
+
+    const FImagePixelData& PixelData = *Frame.PixelData;
+    const FIntPoint Size = PixelData.GetSize();
+    const bool bLinear = PixelData.GetType() == EImagePixelType::Float16;
+
+    if (!Pipe.IsOpen())
+    {
+        if (!OpenPipe(Size, bLinear))
+        {
+            FScopeLock Lock(&QueueCS);
+            bFailed = true;
+            return;
+        }
+    }
+    else if (Size != FrameSize || bLinear != bLinearInput)
+    {
+        UE_LOG(LogOmniCaptureSoftwareEncoder, Warning, TEXT("Software encoder frame format changed mid-stream; dropping frame %d."), Frame.Metadata.FrameIndex);
+        return;
+    }
+
+    const double EnqueueTime = FPlatformTime::Seconds();
+
+    // Bounded queue: when x264 falls behind the ring buffer sees the stall and applies its policy.
+    TArray<uint8> Buffer;
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&QueueCS);
+            if (PendingFrames.Num() < QueueDepth || !Thread)
+            {
+                if (FreeBuffers.Num() > 0)
+                {
+                    Buffer = FreeBuffers.Pop(EAllowShrinking::No);
+                }
+                break;
+            }
+        }
+        SpaceEvent->Wait(5);
+    }
+
+    const void* RawData = nullptr;
+    int64 RawSize = 0;
+    PixelData.GetRawData(RawData, RawSize);
+
+    const int32 Width = Size.X;
+    const int32 Height = Size.Y;
+    const int32 NumTasks = FMath::DivideAndRoundUp(Height, PackRowsPerTask);
+    if (bLinear)
+    {
+        Buffer.SetNumUninitialized(static_cast<int32>(static_cast<int64>(Width) * Height * 3 * sizeof(uint16)), EAllowShrinking::No);
+        const FFloat16Color* Source = static_cast<const FFloat16Color*>(RawData);
+        uint16* Dest = reinterpret_cast<uint16*>(Buffer.GetData());
+        ParallelFor(NumTasks, [Source, Dest, Width, Height](int32 TaskIndex)
+        {
+            const int32 RowEnd = FMath::Min(Height, (TaskIndex + 1) * PackRowsPerTask);
+            for (int32 Row = TaskIndex * PackRowsPerTask; Row < RowEnd; ++Row)
+            {
+                const FFloat16Color* SourceRow = Source + static_cast<int64>(Row) * Width;
+                uint16* DestRow = Dest + static_cast<int64>(Row) * Width * 3;
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    const FFloat16Color& Pixel = SourceRow[X];
+                    DestRow[X * 3 + 0] = static_cast<uint16>(FMath::Clamp(Pixel.R.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+                    DestRow[X * 3 + 1] = static_cast<uint16>(FMath::Clamp(Pixel.G.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+                    DestRow[X * 3 + 2] = static_cast<uint16>(FMath::Clamp(Pixel.B.GetFloat(), 0.0f, 1.0f) * 65535.0f + 0.5f);
+                }
+            }
+        });
+    }
+    else
+    {
+        Buffer.SetNumUninitialized(static_cast<int32>(RawSize), EAllowShrinking::No);
+        const uint8* Source = static_cast<const uint8*>(RawData);
+        uint8* Dest = Buffer.GetData();
+        const int64 RowBytes = RawSize / FMath::Max(1, Height);
+        ParallelFor(NumTasks, [Source, Dest, RowBytes, Height](int32 TaskIndex)
+        {
+            const int32 RowStart = TaskIndex * PackRowsPerTask;
+            const int32 RowEnd = FMath::Min(Height, RowStart + PackRowsPerTask);
+            FMemory::Memcpy(Dest + RowStart * RowBytes, Source + RowStart * RowBytes, (RowEnd - RowStart) * RowBytes);
+        });
+    }
+
+    {
+        FScopeLock Lock(&QueueCS);
+        FQueuedFrame& Queued = PendingFrames.AddDefaulted_GetRef();
+        Queued.Data = MoveTemp(Buffer);
+        Queued.EnqueueTime = EnqueueTime;
+        LatencyStats.PendingFrames = PendingFrames.Num();
+    }
+
+    if (Thread)
+    {
+        WakeEvent->Trigger();
+    }
+    else
+    {
+        DrainQueue();
+    }
+}
+
+void FOmniCaptureSoftwareEncoder::DrainQueue()
+{
+    for (;;)
+    {
+        FQueuedFrame Queued;
+        bool bPipeFailed = false;
+        {
+            FScopeLock Lock(&QueueCS);
+            if (PendingFrames.Num() == 0)
+            {
+                return;
+            }
+
+            bPipeFailed = bFailed;
+
+            Queued = MoveTemp(PendingFrames[0]);
+            PendingFrames.RemoveAt(0, 1, EAllowShrinking::No);
+        }
+
+        // A full pipe blocks here, so the latency covers both packing and x264 catching up.
+        const bool bWritten = !bPipeFailed && Pipe.Write(Queued.Data.GetData(), Queued.Data.Num());
+
+        {
+            FScopeLock Lock(&QueueCS);
+            if (bWritten)
+            {
+                RecordLatency(LatencyStats, FPlatformTime::Seconds() - Queued.EnqueueTime);
+            }
+            else if (!bFailed)
+            {
+                UE_LOG(LogOmniCaptureSoftwareEncoder, Warning, TEXT("Software encoder pipe failed; remaining frames will be dropped."));
+                bFailed = true;
+            }
+            LatencyStats.PendingFrames = PendingFrames.Num();
+            FreeBuffers.Add(MoveTemp(Queued.Data));
+        }
+
+        if (SpaceEvent)
+        {
+            SpaceEvent->Trigger();
+        }
+    }
+}
+
+FOmniCaptureEncoderLatencyStats FOmniCaptureSoftwareEncoder::GetLatencyStats() const
+{
+    FScopeLock Lock(&QueueCS);
+    return LatencyStats;
+}
+
+bool FOmniCaptureSoftwareEncoder::IsStalled() const
+{
+    {
+        FScopeLock Lock(&QueueCS);
+        if (PendingFrames.Num() >= QueueDepth)
+        {
+            return true;
+        }
+    }
+
+    return Pipe.IsStalled(StallThresholdSeconds);
+}
+
+void FOmniCaptureSoftwareEncoder::StopWorker()
+{
+    if (Thread)
+    {
+        bRunning = false;
+        WakeEvent->Trigger();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+        delete Worker;
+        Worker = nullptr;
+    }
+
+    DrainQueue();
+}
+
+void FOmniCaptureSoftwareEncoder::Finalize()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    StopWorker();
+
+    if (Pipe.IsOpen())
+    {
+        const int32 ReturnCode = Pipe.Close();
+        if (ReturnCode != 0)
+        {
+            UE_LOG(LogOmniCaptureSoftwareEncoder, Warning, TEXT("Software encoder FFmpeg exited with code %d (%s)"), ReturnCode, *OutputFilePath);
+        }
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+    if (SpaceEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+        SpaceEvent = nullptr;
+    }
+
+    FreeBuffers.Empty();
+    bInitialized = false;
+
+    UE_LOG(LogOmniCaptureSoftwareEncoder, Log, TEXT("Software encoder finalize complete -> %s (%lld frames, mean latency %.2f ms, peak %.2f ms)"),
+        *OutputFilePath, LatencyStats.FramesEncoded, LatencyStats.AverageLatencyMs, LatencyStats.PeakLatencyMs);
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureLatitudeAQTest, "OmniCapture.Encoder.LatitudeAQ",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOmniCaptureLatitudeAQTest::RunTest(const FString& Parameters)
+{
+    // The reference clip comes from the command line: -OmniLatitudeAQClip=<path> [-OmniLatitudeAQFrames=120] [-OmniLatitudeAQMaxQP=8]
+    FString ClipPath;
+    if (!FParse::Value(FCommandLine::Get(), TEXT("OmniLatitudeAQClip="), ClipPath) || !FPaths::FileExists(ClipPath))
+    {
+        AddInfo(TEXT("No -OmniLatitudeAQClip=<path> reference clip given; skipping."));
+        return true;
+    }
+
+    FOmniCaptureSettings Settings;
+    Settings.Mode = EOmniCaptureMode::Mono;
+    Settings.Codec = EOmniCaptureCodec::H264;
+    Settings.ColorSpace = EOmniCaptureColorSpace::BT709;
+    Settings.Quality.RateControlMode = EOmniCaptureRateControlMode::VariableBitrate;
+    Settings.Quality.bLatitudeAdaptiveQuantization = true;
+    int32 MaxPolarQPOffset = Settings.Quality.MaxPolarQPOffset;
+    if (FParse::Value(FCommandLine::Get(), TEXT("OmniLatitudeAQMaxQP="), MaxPolarQPOffset))
+    {
+        Settings.Quality.MaxPolarQPOffset = FMath::Clamp(MaxPolarQPOffset, 1, 24);
+    }
+
+    FString Binary;
+    if (!FOmniCaptureMuxer::IsFFmpegAvailable(Settings, &Binary))
+    {
+        AddInfo(TEXT("FFmpeg is not available; skipping."));
+        return true;
+    }
+
+    int32 NumFrames = 120;
+    FParse::Value(FCommandLine::Get(), TEXT("OmniLatitudeAQFrames="), NumFrames);
+    NumFrames = FMath::Max(1, NumFrames);
+    const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("OmniCaptures"));
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    double BaselinePSNR = 0.0;
+    double WeightedPSNR = 0.0;
+    const int64 BaselineBytes = EncodeReferenceClip(Binary, ClipPath, NumFrames, FString(), Directory / TEXT("LatitudeAQ_Baseline.mp4"), BaselinePSNR);
+    const int64 WeightedBytes = EncodeReferenceClip(Binary, ClipPath, NumFrames, FOmniCaptureSoftwareEncoder::BuildLatitudeROIFilter(Settings), Directory / TEXT("LatitudeAQ_Weighted.mp4"), WeightedPSNR);
+    if (!TestTrue(TEXT("Reference encodes succeeded"), BaselineBytes > 0 && WeightedBytes > 0))
+    {
+        return false;
+    }
+
+    TestTrue(TEXT("Latitude AQ does not grow the stream"), WeightedBytes <= BaselineBytes);
+    AddInfo(FString::Printf(TEXT("Latitude AQ (max +%d QP, %d frames): %lld -> %lld bytes (%.1f%% saved), horizon PSNR %.2f -> %.2f dB"),
+        Settings.Quality.MaxPolarQPOffset,
+        NumFrames,
+        BaselineBytes,
+        WeightedBytes,
+        100.0 * (1.0 - static_cast<double>(WeightedBytes) / BaselineBytes),
+        BaselinePSNR,
+        WeightedPSNR));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,122 @@
+#include "OmniCaptureStageTimings.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    double Percentile(const TArray<double>& Sorted, double Fraction)
+    {
+        // Nearest rank, so p99 of a short window is its worst sample rather than an interpolation.
+        const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num());
+        return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+    }
+}
+
+FOmniCaptureStageTimings& FOmniCaptureStageTimings::Get()
+{
+    static FOmniCaptureStageTimings Instance;
+    return Instance;
+}
+
+const TCHAR* FOmniCaptureStageTimings::GetStageName(EOmniCaptureStage Stage)
+{
+    switch (Stage)
+    {
+    case EOmniCaptureStage::Capture:
+        return TEXT("Capture");
+    case EOmniCaptureStage::Convert:
+        return TEXT("Convert");
+    case EOmniCaptureStage::GPUEquirect:
+        return TEXT("GPU Equirect");
+    case EOmniCaptureStage::GPUYUV:
+        return TEXT("GPU YUV");
+    case EOmniCaptureStage::GPUBGRA:
+        return TEXT("GPU BGRA");
+    case EOmniCaptureStage::Readback:
+        return TEXT("Readback");
+    case EOmniCaptureStage::RingConsumer:
+        return TEXT("Ring Consumer");
+    case EOmniCaptureStage::PNGWrite:
+        return TEXT("PNG Write");
+    case EOmniCaptureStage::VideoEncode:
+        return TEXT("Video Encode");
+    default:
+        return TEXT("Unknown");
+    }
+}
+
+void FOmniCaptureStageTimings::Record(EOmniCaptureStage Stage, double Milliseconds)
+{
+    const int32 StageIndex = static_cast<int32>(Stage);
+    if (StageIndex < 0 || StageIndex >= static_cast<int32>(EOmniCaptureStage::Count))
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CS);
+    FStageWindow& Window = Windows[StageIndex];
+    Window.Samples[Window.Next] = Milliseconds;
+    Window.Next = (Window.Next + 1) % WindowSize;
+    Window.Count = FMath::Min(Window.Count + 1, WindowSize);
+    ++Window.Total;
+    Window.LastMs = Milliseconds;
+    Window.MaxMs = FMath::Max(Window.MaxMs, Milliseconds);
+}
+
+double FOmniCaptureStageTimings::GetLastMs(EOmniCaptureStage Stage) const
+{
+    const int32 StageIndex = static_cast<int32>(Stage);
+    if (StageIndex < 0 || StageIndex >= static_cast<int32>(EOmniCaptureStage::Count))
+    {
+        return 0.0;
+    }
+
+    FScopeLock Lock(&CS);
+    return Windows[StageIndex].LastMs;
+}
+
+void FOmniCaptureStageTimings::Reset()
+{
+    FScopeLock Lock(&CS);
+    for (FStageWindow& Window : Windows)
+    {
+        Window.Count = 0;
+        Window.Next = 0;
+        Window.Total = 0;
+        Window.LastMs = 0.0;
+        Window.MaxMs = 0.0;
+    }
+}
+
+TArray<FOmniCaptureStageTiming> FOmniCaptureStageTimings::GetSnapshot() const
+{
+    TArray<FOmniCaptureStageTiming> Result;
+    TArray<double> Sorted;
+    for (int32 StageIndex = 0; StageIndex < static_cast<int32>(EOmniCaptureStage::Count); ++StageIndex)
+    {
+        FOmniCaptureStageTiming& Timing = Result.AddDefaulted_GetRef();
+        {
+            FScopeLock Lock(&CS);
+            const FStageWindow& Window = Windows[StageIndex];
+            if (Window.Count == 0)
+            {
+                Result.Pop(EAllowShrinking::No);
+                continue;
+            }
+
+            Sorted.Reset();
+            Sorted.Append(Window.Samples, Window.Count);
+            Timing.Samples = Window.Total;
+            Timing.LastMs = Window.LastMs;
+            Timing.MaxMs = Window.MaxMs;
+        }
+
+        // Sorting happens outside the lock so recording threads never wait on a snapshot.
+        Sorted.Sort();
+        Timing.Stage = static_cast<EOmniCaptureStage>(StageIndex);
+        Timing.P50Ms = Percentile(Sorted, 0.50);
+        Timing.P95Ms = Percentile(Sorted, 0.95);
+        Timing.P99Ms = Percentile(Sorted, 0.99);
+    }
+    return Result;
+}
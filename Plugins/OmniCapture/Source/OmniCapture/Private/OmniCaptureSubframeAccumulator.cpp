@@ -0,0 +1,323 @@
+#include "OmniCaptureSubframeAccumulator.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+
+#include "ComputeShaderUtils.h"
+#include "GlobalShader.h"
+#include "Math/UnrealMathUtility.h"
+#include "PixelShaderUtils.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHIStaticStates.h"
+
+namespace
+{
+    constexpr int32 FaceCount = 6;
+    constexpr float MinSubframeShutter = 0.01f;
+
+    class FOmniAccumulateCS final : public FGlobalShader
+    {
+    public:
+        DECLARE_GLOBAL_SHADER(FOmniAccumulateCS);
+        SHADER_USE_PARAMETER_STRUCT(FOmniAccumulateCS, FGlobalShader);
+
+        BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+            SHADER_PARAMETER(int32, FaceResolution)
+            SHADER_PARAMETER(int32, SliceIndex)
+            SHADER_PARAMETER(int32, bFirstSample)
+            SHADER_PARAMETER(float, SampleWeight)
+            SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, SourceFace)
+            SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2DArray<float4>, Accumulation)
+        END_SHADER_PARAMETER_STRUCT()
+
+        static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+        {
+            return true;
+        }
+    };
+
+    IMPLEMENT_GLOBAL_SHADER(FOmniAccumulateCS, "/Plugin/OmniCapture/Private/OmniAccumulateCS.usf", "MainCS", SF_Compute);
+
+    class FOmniAccumulatePS final : public FGlobalShader
+    {
+    public:
+        DECLARE_GLOBAL_SHADER(FOmniAccumulatePS);
+        SHADER_USE_PARAMETER_STRUCT(FOmniAccumulatePS, FGlobalShader);
+
+        BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+            SHADER_PARAMETER(float, SampleWeight)
+            SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, SourceFace)
+            RENDER_TARGET_BINDING_SLOTS()
+        END_SHADER_PARAMETER_STRUCT()
+
+        static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+        {
+            return true;
+        }
+    };
+
+    IMPLEMENT_GLOBAL_SHADER(FOmniAccumulatePS, "/Plugin/OmniCapture/Private/OmniAccumulatePS.usf", "MainPS", SF_Pixel);
+
+    double Halton(int32 Index, int32 Base)
+    {
+        double Result = 0.0;
+        double Fraction = 1.0 / Base;
+        while (Index > 0)
+        {
+            Result += Fraction * (Index % Base);
+            Index /= Base;
+            Fraction /= Base;
+        }
+        return Result;
+    }
+
+    bool GatherFaceTextures(const FOmniEyeCapture& Eye, TArray<FTexture2DRHIRef, TInlineAllocator<6>>& OutFaces)
+    {
+        for (int32 FaceIndex = 0; FaceIndex < FaceCount; ++FaceIndex)
+        {
+            UTextureRenderTarget2D* RenderTarget = Eye.Faces[FaceIndex].RenderTarget;
+            FTextureRenderTargetResource* Resource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+            if (!Resource)
+            {
+                return false;
+            }
+
+            OutFaces.Add(Resource->GetRenderTargetTexture()->GetTexture2D());
+        }
+
+        return true;
+    }
+
+    FRDGTextureRef RegisterAccumulationTarget(
+        FRDGBuilder& GraphBuilder,
+        int32 FaceResolution,
+        ETextureCreateFlags Flags,
+        TRefCountPtr<IPooledRenderTarget>& InOutTarget,
+        const TCHAR* DebugName,
+        bool& bInOutFirstSample)
+    {
+        if (InOutTarget.IsValid() && InOutTarget->GetDesc().Extent == FIntPoint(FaceResolution, FaceResolution))
+        {
+            return GraphBuilder.RegisterExternalTexture(InOutTarget);
+        }
+
+        // FP32 so eight or more HDR samples can be summed without the banding FP16 would add.
+        FRDGTextureDesc Desc = FRDGTextureDesc::Create2DArray(FIntPoint(FaceResolution, FaceResolution), PF_A32B32G32R32F, FClearValueBinding::Transparent, TexCreate_ShaderResource | Flags, FaceCount);
+        FRDGTextureRef Accumulation = GraphBuilder.CreateTexture(Desc, DebugName);
+        GraphBuilder.QueueTextureExtraction(Accumulation, &InOutTarget);
+        bInOutFirstSample = true;
+        return Accumulation;
+    }
+
+    void AddAccumulatePasses(
+        FRDGBuilder& GraphBuilder,
+        const TArray<FTexture2DRHIRef, TInlineAllocator<6>>& Faces,
+        int32 FaceResolution,
+        float Weight,
+        bool bFirstSample,
+        TRefCountPtr<IPooledRenderTarget>& InOutTarget,
+        const TCHAR* DebugName)
+    {
+        FRDGTextureRef Accumulation = RegisterAccumulationTarget(GraphBuilder, FaceResolution, TexCreate_UAV, InOutTarget, DebugName, bFirstSample);
+        FRDGTextureUAVRef AccumulationUAV = GraphBuilder.CreateUAV(Accumulation);
+        TShaderMapRef<FOmniAccumulateCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        const FIntVector GroupCount(
+            FMath::DivideAndRoundUp(FaceResolution, 8),
+            FMath::DivideAndRoundUp(FaceResolution, 8),
+            1);
+
+        for (int32 FaceIndex = 0; FaceIndex < Faces.Num(); ++FaceIndex)
+        {
+            if (!Faces[FaceIndex].IsValid())
+            {
+                continue;
+            }
+
+            FOmniAccumulateCS::FParameters* Parameters = GraphBuilder.AllocParameters<FOmniAccumulateCS::FParameters>();
+            Parameters->FaceResolution = FaceResolution;
+            Parameters->SliceIndex = FaceIndex;
+            Parameters->bFirstSample = bFirstSample ? 1 : 0;
+            Parameters->SampleWeight = Weight;
+            Parameters->SourceFace = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(Faces[FaceIndex], *FString::Printf(TEXT("%sFace%d"), DebugName, FaceIndex)));
+            Parameters->Accumulation = AccumulationUAV;
+
+            FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("OmniCapture::AccumulateSubframe"), ComputeShader, Parameters, GroupCount);
+        }
+    }
+
+    void AddRasterAccumulatePasses(
+        FRDGBuilder& GraphBuilder,
+        const TArray<FTexture2DRHIRef, TInlineAllocator<6>>& Faces,
+        int32 FaceResolution,
+        float Weight,
+        bool bFirstSample,
+        TRefCountPtr<IPooledRenderTarget>& InOutTarget,
+        const TCHAR* DebugName)
+    {
+        FRDGTextureRef Accumulation = RegisterAccumulationTarget(GraphBuilder, FaceResolution, TexCreate_RenderTargetable, InOutTarget, DebugName, bFirstSample);
+        FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+        TShaderMapRef<FOmniAccumulatePS> PixelShader(ShaderMap);
+        FRHIBlendState* BlendState = bFirstSample
+            ? TStaticBlendState<>::GetRHI()
+            : TStaticBlendState<CW_RGBA, BO_Add, BF_One, BF_One, BO_Add, BF_One, BF_One>::GetRHI();
+
+        for (int32 FaceIndex = 0; FaceIndex < Faces.Num(); ++FaceIndex)
+        {
+            if (!Faces[FaceIndex].IsValid())
+            {
+                continue;
+            }
+
+            FOmniAccumulatePS::FParameters* Parameters = GraphBuilder.AllocParameters<FOmniAccumulatePS::FParameters>();
+            Parameters->SampleWeight = Weight;
+            Parameters->SourceFace = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(Faces[FaceIndex], *FString::Printf(TEXT("%sFace%d"), DebugName, FaceIndex)));
+            Parameters->RenderTargets[0] = FRenderTargetBinding(Accumulation, bFirstSample ? ERenderTargetLoadAction::ENoAction : ERenderTargetLoadAction::ELoad, 0, FaceIndex);
+
+            FPixelShaderUtils::AddFullscreenPass(
+                GraphBuilder,
+                ShaderMap,
+                RDG_EVENT_NAME("OmniCapture::AccumulateSubframeRaster"),
+                PixelShader,
+                Parameters,
+                FIntRect(0, 0, FaceResolution, FaceResolution),
+                BlendState);
+        }
+    }
+
+    void ReadbackAccumulation(FRHICommandListImmediate& RHICmdList, const TRefCountPtr<IPooledRenderTarget>& Target, int32 FaceResolution, TArray<FLinearColor> (&OutFaces)[6])
+    {
+        if (!Target.IsValid())
+        {
+            return;
+        }
+
+        for (int32 FaceIndex = 0; FaceIndex < FaceCount; ++FaceIndex)
+        {
+            FReadSurfaceDataFlags Flags(RCM_MinMax);
+            Flags.SetLinearToGamma(false);
+            Flags.SetArrayIndex(FaceIndex);
+            RHICmdList.ReadSurfaceData(Target->GetRHI(), FIntRect(0, 0, FaceResolution, FaceResolution), OutFaces[FaceIndex], Flags);
+        }
+    }
+}
+
+FOmniCaptureSubframeAccumulator::~FOmniCaptureSubframeAccumulator()
+{
+    Release();
+}
+
+void FOmniCaptureSubframeAccumulator::Begin(const FOmniCaptureSettings& Settings)
+{
+    if (FaceResolution != Settings.Resolution)
+    {
+        Release();
+        FaceResolution = Settings.Resolution;
+    }
+
+    NumSamples = FMath::Max(1, Settings.SubframeSamples);
+    SamplesAccumulated = 0;
+    bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+    bUseGPU = GDynamicRHI != nullptr && GRHISupportsComputeShaders;
+}
+
+void FOmniCaptureSubframeAccumulator::Release()
+{
+    if (GPUFaceArrays[0].IsValid() || GPUFaceArrays[1].IsValid())
+    {
+        // Pending accumulate commands write through these handles.
+        FlushRenderingCommands();
+        GPUFaceArrays[0].SafeRelease();
+        GPUFaceArrays[1].SafeRelease();
+    }
+
+    for (int32 EyeIndex = 0; EyeIndex < 2; ++EyeIndex)
+    {
+        for (TArray<FLinearColor>& Face : CPUFaces[EyeIndex])
+        {
+            Face.Empty();
+        }
+    }
+
+    NumSamples = 0;
+    SamplesAccumulated = 0;
+}
+
+bool FOmniCaptureSubframeAccumulator::Accumulate(const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+{
+    if (NumSamples <= 0 || IsComplete() || FaceResolution <= 0)
+    {
+        return false;
+    }
+
+    if (GDynamicRHI == nullptr)
+    {
+        return false;
+    }
+
+    const float Weight = 1.0f / static_cast<float>(NumSamples);
+    const bool bFirstSample = SamplesAccumulated == 0;
+    const bool bLastSample = SamplesAccumulated + 1 >= NumSamples;
+
+    TArray<FTexture2DRHIRef, TInlineAllocator<6>> LeftFaces;
+    TArray<FTexture2DRHIRef, TInlineAllocator<6>> RightFaces;
+    if (!GatherFaceTextures(LeftEye, LeftFaces) || (bStereo && !GatherFaceTextures(RightEye, RightFaces)))
+    {
+        return false;
+    }
+
+    const int32 Resolution = FaceResolution;
+    const bool bCompute = bUseGPU;
+    ENQUEUE_RENDER_COMMAND(OmniCaptureAccumulateSubframe)([this, LeftFaces, RightFaces, Resolution, Weight, bFirstSample, bLastSample, bCompute](FRHICommandListImmediate& RHICmdList)
+    {
+        {
+            FRDGBuilder GraphBuilder(RHICmdList);
+            auto AddPasses = bCompute ? &AddAccumulatePasses : &AddRasterAccumulatePasses;
+            AddPasses(GraphBuilder, LeftFaces, Resolution, Weight, bFirstSample, GPUFaceArrays[0], TEXT("OmniAccumLeft"));
+            if (RightFaces.Num() > 0)
+            {
+                AddPasses(GraphBuilder, RightFaces, Resolution, Weight, bFirstSample, GPUFaceArrays[1], TEXT("OmniAccumRight"));
+            }
+            GraphBuilder.Execute();
+        }
+
+        // The CPU converter needs the faces in memory; read them back once per output frame
+        // rather than once per sample.
+        if (!bCompute && bLastSample)
+        {
+            ReadbackAccumulation(RHICmdList, GPUFaceArrays[0], Resolution, CPUFaces[0]);
+            if (RightFaces.Num() > 0)
+            {
+                ReadbackAccumulation(RHICmdList, GPUFaceArrays[1], Resolution, CPUFaces[1]);
+            }
+        }
+    });
+
+    if (!bUseGPU && bLastSample)
+    {
+        FlushRenderingCommands();
+    }
+
+    ++SamplesAccumulated;
+    return true;
+}
+
+FVector2D FOmniCaptureSubframeAccumulator::GetJitterOffset(int32 SampleIndex)
+{
+    // Halton(2,3) starting at 1 so sample 0 is not biased towards the pixel corner.
+    return FVector2D(Halton(SampleIndex + 1, 2) - 0.5, Halton(SampleIndex + 1, 3) - 0.5);
+}
+
+double FOmniCaptureSubframeAccumulator::GetDeltaAfterSample(const FOmniCaptureSettings& Settings, int32 SampleIndex)
+{
+    const int32 Samples = FMath::Max(1, Settings.SubframeSamples);
+    const double FrameInterval = 1.0 / FMath::Max(1.0f, Settings.TargetFrameRate);
+    const double SubframeStep = FrameInterval * FMath::Clamp(Settings.SubframeShutter, MinSubframeShutter, 1.0f) / Samples;
+
+    // Samples are spread over the open part of the shutter; the last one absorbs the closed
+    // interval so output frames stay exactly one frame interval apart. The shutter floor keeps
+    // every step non-zero, since a zero fixed delta would freeze the world between samples.
+    return SampleIndex < Samples - 1
+        ? SubframeStep
+        : FrameInterval - SubframeStep * (Samples - 1);
+}
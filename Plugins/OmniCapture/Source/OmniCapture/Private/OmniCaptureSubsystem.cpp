@@ -1,17 +1,25 @@
 #include "OmniCaptureSubsystem.h"
 
 #include "OmniCaptureAudioRecorder.h"
+#include "OmniCaptureAmbisonics.h"
 #include "OmniCaptureDirectorActor.h"
 #include "OmniCaptureEquirectConverter.h"
 #include "OmniCaptureNVENCEncoder.h"
+#include "OmniCaptureSoftwareEncoder.h"
 #include "OmniCapturePNGWriter.h"
 #include "OmniCaptureRigActor.h"
 #include "OmniCaptureRingBuffer.h"
 #include "OmniCapturePreviewActor.h"
 #include "OmniCaptureMuxer.h"
+#include "OmniCaptureMuxJobQueue.h"
+#include "OmniCaptureLiveMuxer.h"
+#include "OmniCaptureStageTimings.h"
+#include "OmniCaptureSubframeAccumulator.h"
 
+#include "Async/Async.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
+#include "Misc/App.h"
 #include "Misc/Paths.h"
 #include "Misc/DateTime.h"
 #include "HAL/FileManager.h"
@@ -30,8 +38,15 @@ namespace OmniCapture
     static constexpr TCHAR RigActorName[] = TEXT("OmniCaptureRig");
     static constexpr TCHAR DirectorActorName[] = TEXT("OmniCaptureDirector");
     static const FString WarningLowDisk = TEXT("Storage space is low for OmniCapture output");
-    static const FString WarningFrameDrop = TEXT("Frame drops detected - rendering slower than encode path");
+    static const FString WarningFrameDrop = TEXT("Frame drops detected - see telemetry for the cause and bottleneck");
     static const FString WarningLowFps = TEXT("Capture frame rate is below the configured target");
+
+    // The control panel polls at 4 Hz; publishing a little faster keeps it current without
+    // re-sorting the stage windows every tick.
+    static constexpr double TelemetryPublishInterval = 0.1;
+
+    // Drop timeline depth kept for telemetry; the manifest records every drop.
+    static constexpr int32 MaxRecentDrops = 16;
 }
 
 void UOmniCaptureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
@@ -43,6 +58,11 @@ void UOmniCaptureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 void UOmniCaptureSubsystem::Deinitialize()
 {
     EndCapture(false);
+    if (MuxJobQueue)
+    {
+        MuxJobQueue->CancelAll();
+        MuxJobQueue.Reset();
+    }
     Super::Deinitialize();
 }
 
@@ -67,9 +87,10 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     BaseOutputDirectory = ActiveSettings.OutputDirectory;
     BaseOutputFileName = ActiveSettings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : ActiveSettings.OutputFileName;
     CurrentSegmentIndex = 0;
-    CapturedFrameMetadata.Empty();
+    ActiveSegmentFrameCount = 0;
     CompletedSegments.Empty();
     RecordedAudioPath.Reset();
+    RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
     RecordedVideoPath.Reset();
     LastFinalizedOutput.Empty();
     LastStillImagePath.Empty();
@@ -78,11 +99,20 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     ActiveWarnings.Empty();
     LatestRingBufferStats = FOmniCaptureRingBufferStats();
     AudioStats = FOmniAudioSyncStats();
+    FOmniCaptureStageTimings::Get().Reset();
+    Telemetry.Reset();
+    CompletedOutputBytes = 0;
+    LastTelemetryPublishTime = 0.0;
+    LastTelemetryStreamTime = 0.0;
     ResetDynamicWarnings();
 
     bIsPaused = false;
     bDroppedFrames = false;
     DroppedFrameCount = 0;
+    FMemory::Memzero(DropsByCause);
+    FMemory::Memzero(DropsByBottleneck);
+    RecentDrops.Reset();
+    LastWriterStalls = 0;
     CurrentCaptureFPS = 0.0;
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
@@ -132,6 +162,7 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     if (OutputMuxer)
     {
         OutputMuxer->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+        OutputMuxer->OpenManifest(ActiveSettings);
         OutputMuxer->BeginRealtimeSession(ActiveSettings);
     }
 
@@ -143,6 +174,8 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
             return;
         }
 
+        OMNICAPTURE_STAGE_SCOPE(RingConsumer);
+
         if (OutputMuxer)
         {
             OutputMuxer->PushFrame(*Frame);
@@ -156,6 +189,17 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
         switch (ActiveSettings.OutputFormat)
         {
         case EOmniOutputFormat::PNGSequence:
+            if (LiveMuxer && !LiveMuxer->HasFailed())
+            {
+                // A rejected frame with a healthy pipe is a format change the live mux already logged.
+                if (LiveMuxer->PushFrame(*Frame) || !LiveMuxer->HasFailed())
+                {
+                    break;
+                }
+
+                UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("Live FFmpeg mux failed; writing PNG frames from frame %d"), Frame->Metadata.FrameIndex);
+            }
+
             if (PNGWriter)
             {
                 const FString FileName = BuildFrameFileName(Frame->Metadata.FrameIndex, TEXT(".png"));
@@ -163,9 +207,10 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
             }
             break;
         case EOmniOutputFormat::NVENCHardware:
-            if (NVENCEncoder)
+        case EOmniOutputFormat::SoftwareEncoder:
+            if (VideoEncoder)
             {
-                NVENCEncoder->EnqueueFrame(*Frame);
+                VideoEncoder->EnqueueFrame(*Frame);
             }
             break;
         default:
@@ -174,34 +219,44 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
 
         if (RingBuffer.IsValid())
         {
+            // Evictions are attributed on the game thread after each enqueue; see CaptureFrame.
             LatestRingBufferStats = RingBuffer->GetStats();
-            if (LatestRingBufferStats.DroppedFrames > DroppedFrameCount)
-            {
-                DroppedFrameCount = LatestRingBufferStats.DroppedFrames;
-                HandleDroppedFrame();
-            }
         }
     });
+    RingBuffer->SetBackpressureProbe([this]()
+    {
+        return (LiveMuxer && LiveMuxer->IsStalled()) || (VideoEncoder && VideoEncoder->IsStalled());
+    });
 
+    CaptureStartTime = FPlatformTime::Seconds();
+    TotalPausedSeconds = 0.0;
+    PauseStartTime = 0.0;
+    BeginFixedTimestep();
     InitializeAudioRecording();
 
+    if (ActiveSettings.SubframeSamples > 1)
+    {
+        SubframeAccumulator = MakeUnique<FOmniCaptureSubframeAccumulator>();
+        SubframeAccumulator->Begin(ActiveSettings);
+    }
+
     bIsCapturing = true;
     bDroppedFrames = false;
     DroppedFrameCount = 0;
     FrameCounter = 0;
-    CaptureStartTime = FPlatformTime::Seconds();
     CurrentSegmentStartTime = CaptureStartTime;
     LastSegmentSizeCheckTime = CurrentSegmentStartTime;
     LastRuntimeWarningCheckTime = CurrentSegmentStartTime;
     PreviewFrameInterval = (ActiveSettings.bEnablePreviewWindow && ActiveSettings.PreviewFrameRate > 0.f) ? (1.0 / FMath::Max(1.0f, ActiveSettings.PreviewFrameRate)) : 0.0;
     LastPreviewUpdateTime = CaptureStartTime;
     State = EOmniCaptureState::Recording;
+    OpenTelemetryStream();
 
     UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Begin capture %s %dx%d (%s, %s, %s) -> %s"),
         ActiveSettings.Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"),
         ActiveSettings.Resolution,
         ActiveSettings.Resolution,
-        ActiveSettings.OutputFormat == EOmniOutputFormat::PNGSequence ? TEXT("PNG") : TEXT("NVENC"),
+        ActiveSettings.OutputFormat == EOmniOutputFormat::PNGSequence ? TEXT("PNG") : (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware ? TEXT("NVENC") : TEXT("Software")),
         ActiveSettings.Gamma == EOmniCaptureGamma::Linear ? TEXT("Linear") : TEXT("sRGB"),
         ActiveSettings.Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H.264"),
         *ActiveSettings.OutputDirectory);
@@ -223,8 +278,8 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
     DestroyTickActor();
     DestroyPreviewActor();
     DestroyRig();
-
-    ShutdownAudioRecording();
+    EndFixedTimestep();
+    SubframeAccumulator.Reset();
 
     if (RingBuffer)
     {
@@ -232,6 +287,8 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
         RingBuffer.Reset();
     }
 
+    ShutdownAudioRecording();
+
     ShutdownOutputWriters(bFinalize);
     if (OutputMuxer)
     {
@@ -239,7 +296,12 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
     }
     FinalizeOutputs(bFinalize);
 
-    State = EOmniCaptureState::Idle;
+    State = HasPendingMuxJobs() ? EOmniCaptureState::Finalizing : EOmniCaptureState::Idle;
+
+    // The closing row carries the final totals, before the live stats are cleared.
+    PublishTelemetry(true);
+    TelemetryStreamer.Reset();
+
     LatestRingBufferStats = FOmniCaptureRingBufferStats();
     AudioStats = FOmniAudioSyncStats();
 }
@@ -253,6 +315,7 @@ void UOmniCaptureSubsystem::PauseCapture()
 
     bIsPaused = true;
     State = EOmniCaptureState::Paused;
+    PauseStartTime = FPlatformTime::Seconds();
 
     if (RingBuffer)
     {
@@ -279,6 +342,8 @@ void UOmniCaptureSubsystem::ResumeCapture()
 
     bIsPaused = false;
     State = bDroppedFrames ? EOmniCaptureState::DroppedFrames : EOmniCaptureState::Recording;
+    TotalPausedSeconds += FPlatformTime::Seconds() - PauseStartTime;
+    PauseStartTime = 0.0;
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
 
@@ -412,6 +477,25 @@ FString UOmniCaptureSubsystem::GetStatusString() const
             Status = TEXT("Idle");
         }
 
+        if (MuxJobQueue)
+        {
+            for (const FOmniCaptureMuxJobStatus& Job : MuxJobQueue->GetJobStatuses())
+            {
+                if (Job.State == EOmniCaptureMuxJobState::Running)
+                {
+                    Status += FString::Printf(TEXT(" | Mux Segment %d: %.0f%%"), Job.SegmentIndex, Job.Progress * 100.0f);
+                    if (Job.EstimatedSecondsRemaining >= 0.0)
+                    {
+                        Status += FString::Printf(TEXT(" (ETA %.0fs)"), Job.EstimatedSecondsRemaining);
+                    }
+                }
+                else if (Job.State == EOmniCaptureMuxJobState::Queued)
+                {
+                    Status += FString::Printf(TEXT(" | Mux Segment %d: Queued"), Job.SegmentIndex);
+                }
+            }
+        }
+
         if (!LastStillImagePath.IsEmpty())
         {
             Status += TEXT(" | Last Still: ") + LastStillImagePath;
@@ -474,6 +558,98 @@ FOmniAudioSyncStats UOmniCaptureSubsystem::GetAudioSyncStats() const
     return AudioStats;
 }
 
+FOmniCaptureBitstreamStats UOmniCaptureSubsystem::GetBitstreamStats() const
+{
+    return VideoEncoder ? VideoEncoder->GetBitstreamStats() : FOmniCaptureBitstreamStats();
+}
+
+TArray<FOmniCaptureStageTiming> UOmniCaptureSubsystem::GetStageTimings() const
+{
+    return FOmniCaptureStageTimings::Get().GetSnapshot();
+}
+
+FOmniCaptureEncoderLatencyStats UOmniCaptureSubsystem::GetEncoderLatencyStats() const
+{
+    return VideoEncoder ? VideoEncoder->GetLatencyStats() : FOmniCaptureEncoderLatencyStats();
+}
+
+void UOmniCaptureSubsystem::PublishTelemetry(bool bForceStream)
+{
+    const double Now = FPlatformTime::Seconds();
+    LastTelemetryPublishTime = Now;
+
+    FOmniCaptureTelemetry Snapshot;
+    Snapshot.CaptureSeconds = Now - CaptureStartTime;
+    Snapshot.State = State;
+    Snapshot.FramesCaptured = FrameCounter;
+    Snapshot.CaptureFPS = CurrentCaptureFPS;
+    Snapshot.SegmentIndex = CurrentSegmentIndex;
+    Snapshot.RingPendingFrames = LatestRingBufferStats.PendingFrames;
+    Snapshot.RingBlockedPushes = LatestRingBufferStats.BlockedPushes;
+    Snapshot.PNGPendingWrites = PNGWriter ? PNGWriter->GetPendingWrites() : 0;
+    Snapshot.BytesWritten = CompletedOutputBytes + GetActiveOutputBytes();
+    Snapshot.FrameMetadataBytes = OutputMuxer ? OutputMuxer->GetFrameMetadataBytes() : 0;
+    Snapshot.DroppedFrames = DroppedFrameCount;
+    Snapshot.RingBufferDrops = LatestRingBufferStats.DroppedFrames;
+    Snapshot.DropsByCause.Append(DropsByCause, UE_ARRAY_COUNT(DropsByCause));
+    Snapshot.DropsByBottleneck.Append(DropsByBottleneck, UE_ARRAY_COUNT(DropsByBottleneck));
+    Snapshot.RecentDrops = RecentDrops;
+    Snapshot.AudioDriftMs = AudioStats.DriftMilliseconds;
+    Snapshot.MaxAudioDriftMs = AudioStats.MaxObservedDriftMilliseconds;
+    Snapshot.AudioPendingPackets = AudioStats.PendingPackets;
+    Snapshot.bAudioInError = AudioStats.bInError;
+    Snapshot.StageTimings = FOmniCaptureStageTimings::Get().GetSnapshot();
+
+    if (VideoEncoder)
+    {
+        const FOmniCaptureEncoderLatencyStats LatencyStats = VideoEncoder->GetLatencyStats();
+        Snapshot.EncoderPendingFrames = LatencyStats.PendingFrames;
+        Snapshot.EncoderLatencyMs = LatencyStats.AverageLatencyMs;
+        Snapshot.WriteBytesPerSecond = VideoEncoder->GetBitstreamStats().BytesPerSecond;
+    }
+    else if (Snapshot.CaptureSeconds > 0.0)
+    {
+        Snapshot.WriteBytesPerSecond = static_cast<double>(Snapshot.BytesWritten) / Snapshot.CaptureSeconds;
+    }
+
+    Telemetry.Publish(Snapshot);
+
+    if (TelemetryStreamer && (bForceStream || (Now - LastTelemetryStreamTime) >= ActiveSettings.TelemetryIntervalSeconds))
+    {
+        TelemetryStreamer->Write(Snapshot);
+        LastTelemetryStreamTime = Now;
+    }
+}
+
+void UOmniCaptureSubsystem::OpenTelemetryStream()
+{
+    TelemetryStreamer.Reset();
+    if (ActiveSettings.TelemetryStreamFormat == EOmniCaptureTelemetryFormat::None)
+    {
+        return;
+    }
+
+    // One stream per capture, beside the segments, so it spans rotations.
+    const FString StreamPath = BaseOutputDirectory / (BaseOutputFileName + TEXT("_telemetry") + FOmniCaptureTelemetryStreamer::GetFileExtension(ActiveSettings.TelemetryStreamFormat));
+    TelemetryStreamer = MakeUnique<FOmniCaptureTelemetryStreamer>();
+    if (!TelemetryStreamer->Open(StreamPath, ActiveSettings.TelemetryStreamFormat))
+    {
+        TelemetryStreamer.Reset();
+        return;
+    }
+
+    UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Streaming telemetry every %.2fs to %s"), ActiveSettings.TelemetryIntervalSeconds, *StreamPath);
+}
+
+int64 UOmniCaptureSubsystem::GetActiveOutputBytes() const
+{
+    if (VideoEncoder)
+    {
+        return VideoEncoder->GetBitstreamStats().TotalBytes;
+    }
+    return PNGWriter ? PNGWriter->GetBytesWritten() : 0;
+}
+
 void UOmniCaptureSubsystem::CreateRig()
 {
     DestroyRig();
@@ -582,15 +758,31 @@ void UOmniCaptureSubsystem::InitializeOutputWriters()
     switch (ActiveSettings.OutputFormat)
     {
     case EOmniOutputFormat::PNGSequence:
+        if (ActiveSettings.bLiveFFmpegMux)
+        {
+            LiveMuxer = MakeUnique<FOmniCaptureLiveMuxer>();
+            if (LiveMuxer->Initialize(ActiveSettings, ActiveSettings.OutputDirectory))
+            {
+                RecordedVideoPath = LiveMuxer->GetOutputFilePath();
+            }
+            else
+            {
+                AddWarningUnique(TEXT("Live FFmpeg mux unavailable - writing PNG sequence"));
+                LiveMuxer.Reset();
+            }
+        }
+
+        // Also the fallback when the live mux fails mid-capture, so frames keep landing on disk.
         PNGWriter = MakeUnique<FOmniCapturePNGWriter>();
         PNGWriter->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
         break;
     case EOmniOutputFormat::NVENCHardware:
-        NVENCEncoder = MakeUnique<FOmniCaptureNVENCEncoder>();
-        NVENCEncoder->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
-        if (NVENCEncoder->IsInitialized())
+    case EOmniOutputFormat::SoftwareEncoder:
+        VideoEncoder = IOmniVideoEncoder::Create(ActiveSettings);
+        VideoEncoder->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+        if (VideoEncoder->IsInitialized())
         {
-            RecordedVideoPath = NVENCEncoder->GetOutputFilePath();
+            RecordedVideoPath = VideoEncoder->GetOutputFilePath();
         }
         break;
     default:
@@ -600,19 +792,33 @@ void UOmniCaptureSubsystem::InitializeOutputWriters()
 
 void UOmniCaptureSubsystem::ShutdownOutputWriters(bool bFinalizeOutputs)
 {
+    if (LiveMuxer)
+    {
+        // Only a cleanly finalized live mux is handed on as the video input; a failed one leaves a
+        // truncated file behind, so finalization muxes the PNG fallback frames instead.
+        if (!LiveMuxer->Finalize())
+        {
+            UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("Live FFmpeg mux did not complete; ignoring %s"), *RecordedVideoPath);
+            RecordedVideoPath.Reset();
+        }
+        LiveMuxer.Reset();
+    }
+
     if (PNGWriter)
     {
         PNGWriter->Flush();
+        CompletedOutputBytes += PNGWriter->GetBytesWritten();
         PNGWriter.Reset();
     }
 
-    if (NVENCEncoder)
+    if (VideoEncoder)
     {
         if (bFinalizeOutputs)
         {
-            NVENCEncoder->Finalize();
+            VideoEncoder->Finalize();
         }
-        NVENCEncoder.Reset();
+        CompletedOutputBytes += VideoEncoder->GetBitstreamStats().TotalBytes;
+        VideoEncoder.Reset();
     }
 }
 
@@ -620,9 +826,10 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
 {
     if (!bFinalizeOutputs)
     {
-        CapturedFrameMetadata.Empty();
+        CompleteActiveSegment(false);
         CompletedSegments.Empty();
         RecordedAudioPath.Reset();
+        RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
         RecordedVideoPath.Reset();
         LastFinalizedOutput.Empty();
         LastStillImagePath.Empty();
@@ -630,16 +837,14 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         return;
     }
 
-    if (CapturedFrameMetadata.Num() > 0)
-    {
-        CompleteActiveSegment(true);
-    }
+    CompleteActiveSegment(true);
 
     if (CompletedSegments.Num() == 0)
     {
         UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("FinalizeOutputs called with no captured frames"));
         OutputMuxer.Reset();
         RecordedAudioPath.Reset();
+        RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
         RecordedVideoPath.Reset();
         LastFinalizedOutput.Empty();
         LastStillImagePath.Empty();
@@ -667,7 +872,8 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         OutputMuxer->Initialize(SegmentSettings, Segment.Directory);
         OutputMuxer->BeginRealtimeSession(SegmentSettings);
 
-        const bool bSuccess = OutputMuxer->FinalizeCapture(SegmentSettings, Segment.Frames, Segment.AudioPath, Segment.VideoPath);
+        FOmniCaptureMuxJobDesc MuxJob;
+        const bool bSuccess = OutputMuxer->FinalizeCapture(SegmentSettings, Segment.Manifest, Segment.AudioPath, Segment.VideoPath, MuxJob);
         if (!bSuccess)
         {
             UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("Output muxing failed for segment %d. Check OmniCapture manifest for details."), Segment.SegmentIndex);
@@ -675,21 +881,89 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         OutputMuxer->EndRealtimeSession();
 
         const FString FinalVideoPath = Segment.Directory / (Segment.BaseFileName + TEXT(".mp4"));
-        LastFinalizedOutput = FinalVideoPath;
+        if (!MuxJob.IsValid())
+        {
+            LastFinalizedOutput = FinalVideoPath;
+            continue;
+        }
 
-        if (SegmentSettings.bOpenPreviewOnFinalize && !FinalVideoPath.IsEmpty())
+        if (!MuxJobQueue)
         {
-            FPlatformProcess::LaunchFileInDefaultExternalApplication(*FinalVideoPath);
+            MuxJobQueue = MakeUnique<FOmniCaptureMuxJobQueue>();
         }
+        MuxJobQueue->Initialize(SegmentSettings.MuxCoreBudget, SegmentSettings.MuxThreadsPerJob);
+
+        MuxJob.SegmentIndex = Segment.SegmentIndex;
+        MuxJob.bOpenOnComplete = SegmentSettings.bOpenPreviewOnFinalize;
+        const bool bOpenOnComplete = MuxJob.bOpenOnComplete;
+        const EOmniCaptureAmbisonicOrder AmbisonicOrder = (SegmentSettings.bRecordAudio && !Segment.AudioPath.IsEmpty()) ? SegmentSettings.AmbisonicOrder : EOmniCaptureAmbisonicOrder::None;
+
+        TWeakObjectPtr<UOmniCaptureSubsystem> WeakThis(this);
+        MuxJobQueue->Submit(MoveTemp(MuxJob), [WeakThis, bOpenOnComplete, AmbisonicOrder](const FOmniCaptureMuxJobStatus& JobStatus)
+        {
+            if (JobStatus.State == EOmniCaptureMuxJobState::Succeeded && AmbisonicOrder != EOmniCaptureAmbisonicOrder::None)
+            {
+                FOmniCaptureSpatialAudioMetadata::InjectAmbisonicBox(JobStatus.OutputFile, AmbisonicOrder);
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, bOpenOnComplete, JobStatus]()
+            {
+                if (UOmniCaptureSubsystem* Subsystem = WeakThis.Get())
+                {
+                    Subsystem->HandleMuxJobComplete(JobStatus, bOpenOnComplete);
+                }
+            });
+        });
     }
 
     CompletedSegments.Empty();
-    CapturedFrameMetadata.Reset();
+    ActiveSegmentFrameCount = 0;
     RecordedAudioPath.Reset();
+    RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
     RecordedVideoPath.Reset();
     OutputMuxer.Reset();
 }
 
+void UOmniCaptureSubsystem::HandleMuxJobComplete(const FOmniCaptureMuxJobStatus& JobStatus, bool bOpenOnComplete)
+{
+    if (JobStatus.State == EOmniCaptureMuxJobState::Succeeded)
+    {
+        LastFinalizedOutput = JobStatus.OutputFile;
+
+        if (bOpenOnComplete && !JobStatus.OutputFile.IsEmpty())
+        {
+            FPlatformProcess::LaunchFileInDefaultExternalApplication(*JobStatus.OutputFile);
+        }
+    }
+    else if (JobStatus.State == EOmniCaptureMuxJobState::Failed)
+    {
+        UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("Output muxing failed for segment %d (exit code %d)."), JobStatus.SegmentIndex, JobStatus.ExitCode);
+    }
+
+    if (!bIsCapturing && State == EOmniCaptureState::Finalizing && !HasPendingMuxJobs())
+    {
+        State = EOmniCaptureState::Idle;
+    }
+}
+
+TArray<FOmniCaptureMuxJobStatus> UOmniCaptureSubsystem::GetMuxJobStatuses() const
+{
+    return MuxJobQueue ? MuxJobQueue->GetJobStatuses() : TArray<FOmniCaptureMuxJobStatus>();
+}
+
+bool UOmniCaptureSubsystem::HasPendingMuxJobs() const
+{
+    return MuxJobQueue && MuxJobQueue->HasPendingJobs();
+}
+
+void UOmniCaptureSubsystem::CancelMuxJobs()
+{
+    if (MuxJobQueue)
+    {
+        MuxJobQueue->CancelAll();
+    }
+}
+
 bool UOmniCaptureSubsystem::ValidateEnvironment()
 {
     bool bResult = true;
@@ -812,10 +1086,42 @@ bool UOmniCaptureSubsystem::ValidateEnvironment()
 
 bool UOmniCaptureSubsystem::ApplyFallbacks()
 {
+    if (ActiveSettings.bDeterministicCapture)
+    {
+        // Every rendered frame must reach the writers, so the producer waits instead of dropping.
+        ActiveSettings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+        ActiveSettings.bForceConstantFrameRate = true;
+        if (ActiveSettings.bLiveFFmpegMux)
+        {
+            ActiveSettings.bLiveFFmpegMux = false;
+            ActiveWarnings.Add(TEXT("Live FFmpeg mux disabled for deterministic capture"));
+        }
+    }
+    else if (ActiveSettings.SubframeSamples > 1)
+    {
+        // Sub-frames are spread across the shutter by stepping world time, which needs the fixed timestep.
+        ActiveSettings.SubframeSamples = 1;
+        ActiveWarnings.Add(TEXT("Sub-frame accumulation requires deterministic capture and has been disabled"));
+    }
+
+    if (ActiveSettings.OutputFormat == EOmniOutputFormat::SoftwareEncoder && !FOmniCaptureSoftwareEncoder::IsAvailable(ActiveSettings))
+    {
+        ActiveWarnings.Add(TEXT("Software encoder needs FFmpeg - falling back to PNG sequence"));
+        ActiveSettings.OutputFormat = EOmniOutputFormat::PNGSequence;
+        return true;
+    }
+
     if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware && !FOmniCaptureNVENCEncoder::IsNVENCAvailable())
     {
         if (ActiveSettings.bAllowNVENCFallback)
         {
+            if (FOmniCaptureSoftwareEncoder::IsAvailable(ActiveSettings))
+            {
+                ActiveWarnings.Add(TEXT("Falling back to the software encoder because NVENC is unavailable"));
+                ActiveSettings.OutputFormat = EOmniOutputFormat::SoftwareEncoder;
+                return true;
+            }
+
             ActiveWarnings.Add(TEXT("Falling back to PNG sequence because NVENC is unavailable"));
             ActiveSettings.OutputFormat = EOmniOutputFormat::PNGSequence;
             return true;
@@ -828,8 +1134,11 @@ bool UOmniCaptureSubsystem::ApplyFallbacks()
     if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
     {
 #if !PLATFORM_WINDOWS
-        ActiveWarnings.Add(TEXT("NVENC output is not supported on this platform; switching to PNG sequence."));
-        ActiveSettings.OutputFormat = EOmniOutputFormat::PNGSequence;
+        const bool bSoftwareAvailable = FOmniCaptureSoftwareEncoder::IsAvailable(ActiveSettings);
+        ActiveWarnings.Add(bSoftwareAvailable
+            ? TEXT("NVENC output is not supported on this platform; switching to the software encoder.")
+            : TEXT("NVENC output is not supported on this platform; switching to PNG sequence."));
+        ActiveSettings.OutputFormat = bSoftwareAvailable ? EOmniOutputFormat::SoftwareEncoder : EOmniOutputFormat::PNGSequence;
         return true;
 #endif
 
@@ -891,14 +1200,56 @@ void UOmniCaptureSubsystem::InitializeAudioRecording()
     }
 
     AudioRecorder = MakeUnique<FOmniCaptureAudioRecorder>();
-    if (AudioRecorder->Initialize(World, ActiveSettings))
+    // Recorders created after a pause (segment rotation) start with the earlier pauses already
+    // folded into their clock origin; pauses during their lifetime are tracked by the recorder.
+    if (!AudioRecorder->Initialize(World, ActiveSettings, CaptureStartTime + TotalPausedSeconds))
     {
-        AudioRecorder->Start();
+        AudioRecorder.Reset();
+        return;
     }
-    else
+
+    if (bFixedTimestepActive)
     {
-        AudioRecorder.Reset();
+        // A realtime device keeps producing audio on the wall clock, which cannot line up with a fixed-step world.
+        if (!AudioRecorder->IsNonRealtimeDevice())
+        {
+            AddWarningUnique(TEXT("Deterministic capture needs a non-realtime audio device; audio was not recorded"));
+            AudioRecorder.Reset();
+            return;
+        }
+        AudioRecorder->SetLockstep(true);
+    }
+
+    AudioRecorder->Start();
+}
+
+void UOmniCaptureSubsystem::BeginFixedTimestep()
+{
+    if (!ActiveSettings.bDeterministicCapture || bFixedTimestepActive)
+    {
+        return;
+    }
+
+    bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+    SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(1.0 / FMath::Max(1.0f, ActiveSettings.TargetFrameRate));
+    bFixedTimestepActive = true;
+
+    UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Deterministic capture: fixed timestep %.6fs"), FApp::GetFixedDeltaTime());
+}
+
+void UOmniCaptureSubsystem::EndFixedTimestep()
+{
+    if (!bFixedTimestepActive)
+    {
+        return;
     }
+
+    FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+    FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+    bFixedTimestepActive = false;
 }
 
 void UOmniCaptureSubsystem::ShutdownAudioRecording()
@@ -908,8 +1259,9 @@ void UOmniCaptureSubsystem::ShutdownAudioRecording()
         return;
     }
 
-    AudioRecorder->Stop(ActiveSettings.OutputDirectory, ActiveSettings.OutputFileName);
+    AudioRecorder->Stop();
     RecordedAudioPath = AudioRecorder->GetOutputFilePath();
+    RecordedAudioTimeline = AudioRecorder->GetTimelineSummary();
     if (!RecordedAudioPath.IsEmpty())
     {
         UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Audio recording saved to %s"), *RecordedAudioPath);
@@ -931,39 +1283,91 @@ void UOmniCaptureSubsystem::TickCapture(float DeltaTime)
     }
 
     UpdateRuntimeWarnings();
+
+    if ((FPlatformTime::Seconds() - LastTelemetryPublishTime) >= OmniCapture::TelemetryPublishInterval)
+    {
+        PublishTelemetry(false);
+    }
 }
 
 void UOmniCaptureSubsystem::CaptureFrame()
 {
     if (!RigActor.IsValid() || !RingBuffer)
     {
-        HandleDroppedFrame();
+        HandleDroppedFrame(EOmniCaptureDropCause::MissingRig);
         return;
     }
 
     FOmniEyeCapture LeftEye;
     FOmniEyeCapture RightEye;
-    RigActor->Capture(LeftEye, RightEye);
+    FOmniCaptureEquirectResult ConversionResult;
+    TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> EncoderSlot;
 
-    FlushRenderingCommands();
+    if (SubframeAccumulator)
+    {
+        const int32 SampleIndex = SubframeAccumulator->GetSampleIndex();
+        RigActor->SetSubpixelJitter(FOmniCaptureSubframeAccumulator::GetJitterOffset(SampleIndex));
+        {
+            OMNICAPTURE_STAGE_SCOPE(Capture);
+            RigActor->Capture(LeftEye, RightEye);
+        }
+
+        const bool bAccumulated = SubframeAccumulator->Accumulate(LeftEye, RightEye);
+        FApp::SetFixedDeltaTime(FOmniCaptureSubframeAccumulator::GetDeltaAfterSample(ActiveSettings, SampleIndex));
+        if (!bAccumulated)
+        {
+            SubframeAccumulator->Begin(ActiveSettings);
+            HandleDroppedFrame(EOmniCaptureDropCause::AccumulationFailed);
+            return;
+        }
+
+        if (!SubframeAccumulator->IsComplete())
+        {
+            return;
+        }
+
+        FlushRenderingCommands();
+        EncoderSlot = VideoEncoder ? VideoEncoder->AcquireInputSlot() : nullptr;
+        {
+            OMNICAPTURE_STAGE_SCOPE(Convert);
+            ConversionResult = FOmniCaptureEquirectConverter::ConvertAccumulated(ActiveSettings, *SubframeAccumulator, EncoderSlot.IsValid() ? &EncoderSlot->Planes : nullptr);
+        }
+        SubframeAccumulator->Begin(ActiveSettings);
+    }
+    else
+    {
+        {
+            // Scene capture rendering is only done once the render thread has been flushed.
+            OMNICAPTURE_STAGE_SCOPE(Capture);
+            RigActor->Capture(LeftEye, RightEye);
+            FlushRenderingCommands();
+        }
+
+        EncoderSlot = VideoEncoder ? VideoEncoder->AcquireInputSlot() : nullptr;
+        {
+            OMNICAPTURE_STAGE_SCOPE(Convert);
+            ConversionResult = FOmniCaptureEquirectConverter::ConvertToEquirectangular(ActiveSettings, LeftEye, RightEye, EncoderSlot.IsValid() ? &EncoderSlot->Planes : nullptr);
+        }
+    }
 
-    FOmniCaptureEquirectResult ConversionResult = FOmniCaptureEquirectConverter::ConvertToEquirectangular(ActiveSettings, LeftEye, RightEye);
     const bool bRequiresGPU = ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware;
     if (!ConversionResult.PixelData.IsValid())
     {
-        HandleDroppedFrame();
+        HandleDroppedFrame(EOmniCaptureDropCause::ConversionFailed);
         return;
     }
 
     if (bRequiresGPU && !ConversionResult.Texture.IsValid())
     {
-        HandleDroppedFrame();
+        HandleDroppedFrame(EOmniCaptureDropCause::GPUTextureMissing);
         return;
     }
 
     TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
     Frame->Metadata.FrameIndex = FrameCounter++;
-    Frame->Metadata.Timecode = FPlatformTime::Seconds() - CaptureStartTime;
+    Frame->Metadata.Timecode = bFixedTimestepActive
+        ? static_cast<double>(Frame->Metadata.FrameIndex) / FMath::Max(1.0f, ActiveSettings.TargetFrameRate)
+        : FPlatformTime::Seconds() - CaptureStartTime - TotalPausedSeconds;
     Frame->Metadata.bKeyFrame = (Frame->Metadata.FrameIndex % ActiveSettings.Quality.GOPLength) == 0;
 
     ++FramesSinceLastFpsSample;
@@ -1007,19 +1411,32 @@ void UOmniCaptureSubsystem::CaptureFrame()
     {
         Frame->EncoderTextures.Add(Frame->Texture);
     }
+    Frame->EncoderSlot = MoveTemp(EncoderSlot);
 
     if (AudioRecorder)
     {
-        AudioRecorder->GatherAudio(Frame->Metadata.Timecode, Frame->AudioPackets);
+        AudioRecorder->GatherAudio(Frame->Metadata.Timecode, Frame->AudioSpans);
     }
 
-    CapturedFrameMetadata.Add(Frame->Metadata);
+    ++ActiveSegmentFrameCount;
 
-    RingBuffer->Enqueue(MoveTemp(Frame));
+    const int32 EvictedFrameIndex = RingBuffer->Enqueue(MoveTemp(Frame));
 
     if (RingBuffer)
     {
+        // Sampled once per tick, so every eviction in a burst sees the same writer state.
+        const int32 WriterStalls = VideoEncoder ? VideoEncoder->GetBitstreamStats().WriterStalls : 0;
+        const bool bWriterStalled = WriterStalls > LastWriterStalls;
+        LastWriterStalls = WriterStalls;
+
         LatestRingBufferStats = RingBuffer->GetStats();
+
+        // Only this thread enqueues and each enqueue evicts at most one frame, so the return value
+        // accounts for every eviction the ring counts.
+        if (EvictedFrameIndex != INDEX_NONE)
+        {
+            HandleDroppedFrame(EOmniCaptureDropCause::RingBufferEviction, EvictedFrameIndex, bWriterStalled);
+        }
     }
 
     if (PreviewActor.IsValid())
@@ -1041,13 +1458,61 @@ void UOmniCaptureSubsystem::FlushRingBuffer()
     }
 }
 
-void UOmniCaptureSubsystem::HandleDroppedFrame()
+void UOmniCaptureSubsystem::HandleDroppedFrame(EOmniCaptureDropCause Cause, int32 FrameIndex, bool bWriterStalled)
 {
+    FOmniCaptureDropEvent Drop;
+    Drop.Sequence = DroppedFrameCount;
+    Drop.FrameIndex = FrameIndex != INDEX_NONE ? FrameIndex : FrameCounter;
+    Drop.CaptureSeconds = FPlatformTime::Seconds() - CaptureStartTime;
+    Drop.Cause = Cause;
+
+    if (Cause == EOmniCaptureDropCause::RingBufferEviction)
+    {
+        // The ring only evicts when its consumer falls behind, so blame whatever the consumer feeds.
+        // A bitstream writer that stalled during this tick means the encoder was waiting on disk.
+        if (ActiveSettings.OutputFormat == EOmniOutputFormat::PNGSequence)
+        {
+            Drop.Stage = EOmniCaptureStage::PNGWrite;
+            Drop.Bottleneck = EOmniCaptureBottleneck::Disk;
+        }
+        else
+        {
+            Drop.Stage = EOmniCaptureStage::VideoEncode;
+            Drop.Bottleneck = bWriterStalled ? EOmniCaptureBottleneck::Disk : EOmniCaptureBottleneck::Encoder;
+        }
+    }
+    else
+    {
+        Drop.Stage = (Cause == EOmniCaptureDropCause::ConversionFailed || Cause == EOmniCaptureDropCause::GPUTextureMissing)
+            ? EOmniCaptureStage::Convert
+            : EOmniCaptureStage::Capture;
+        Drop.Bottleneck = EOmniCaptureBottleneck::Render;
+    }
+    Drop.StageMs = FOmniCaptureStageTimings::Get().GetLastMs(Drop.Stage);
+
+    ++DropsByCause[static_cast<int32>(Cause)];
+    ++DropsByBottleneck[static_cast<int32>(Drop.Bottleneck)];
+    if (RecentDrops.Num() >= OmniCapture::MaxRecentDrops)
+    {
+        RecentDrops.RemoveAt(0, 1, EAllowShrinking::No);
+    }
+    RecentDrops.Add(Drop);
+
+    if (OutputMuxer)
+    {
+        OutputMuxer->RecordDrop(Drop);
+    }
+
     bDroppedFrames = true;
     State = EOmniCaptureState::DroppedFrames;
     ++DroppedFrameCount;
     AddWarningUnique(OmniCapture::WarningFrameDrop);
-    UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("OmniCapture frame dropped"));
+    UE_LOG(LogOmniCaptureSubsystem, Warning, TEXT("OmniCapture frame dropped at frame %d: %s (%s bound, %s %.2f ms)"),
+        Drop.FrameIndex,
+        *StaticEnum<EOmniCaptureDropCause>()->GetNameStringByValue(static_cast<int64>(Cause)),
+        *StaticEnum<EOmniCaptureBottleneck>()->GetNameStringByValue(static_cast<int64>(Drop.Bottleneck)),
+        FOmniCaptureStageTimings::GetStageName(Drop.Stage),
+        Drop.StageMs);
 }
 
 void UOmniCaptureSubsystem::ConfigureActiveSegment()
@@ -1067,8 +1532,9 @@ void UOmniCaptureSubsystem::ConfigureActiveSegment()
 
     IFileManager::Get().MakeDirectory(*ActiveSettings.OutputDirectory, true);
 
-    CapturedFrameMetadata.Empty();
+    ActiveSegmentFrameCount = 0;
     RecordedAudioPath.Reset();
+    RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
     RecordedVideoPath.Reset();
 
     CurrentSegmentStartTime = FPlatformTime::Seconds();
@@ -1108,7 +1574,7 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
         }
     }
 
-    if (!bShouldRotate || CapturedFrameMetadata.Num() == 0)
+    if (!bShouldRotate || ActiveSegmentFrameCount == 0)
     {
         return;
     }
@@ -1142,6 +1608,7 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
     if (OutputMuxer)
     {
         OutputMuxer->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+        OutputMuxer->OpenManifest(ActiveSettings);
         OutputMuxer->BeginRealtimeSession(ActiveSettings);
         AudioStats = FOmniAudioSyncStats();
     }
@@ -1156,18 +1623,17 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
 
 void UOmniCaptureSubsystem::CompleteActiveSegment(bool bStoreResults)
 {
-    if (!bStoreResults)
+    FOmniCaptureManifestSummary Manifest;
+    if (OutputMuxer)
     {
-        CapturedFrameMetadata.Empty();
-        RecordedAudioPath.Reset();
-        RecordedVideoPath.Reset();
-        return;
+        Manifest = OutputMuxer->CloseManifest(ActiveSettings, RecordedAudioPath, RecordedAudioTimeline, RecordedVideoPath);
     }
 
-    if (CapturedFrameMetadata.Num() == 0)
+    if (!bStoreResults || Manifest.Timing.FrameCount == 0)
     {
-        CapturedFrameMetadata.Empty();
+        ActiveSegmentFrameCount = 0;
         RecordedAudioPath.Reset();
+        RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
         RecordedVideoPath.Reset();
         return;
     }
@@ -1178,12 +1644,13 @@ void UOmniCaptureSubsystem::CompleteActiveSegment(bool bStoreResults)
     SegmentRecord.BaseFileName = ActiveSettings.OutputFileName;
     SegmentRecord.AudioPath = RecordedAudioPath;
     SegmentRecord.VideoPath = RecordedVideoPath;
-    SegmentRecord.Frames = MoveTemp(CapturedFrameMetadata);
+    SegmentRecord.Manifest = MoveTemp(Manifest);
 
     CompletedSegments.Add(MoveTemp(SegmentRecord));
 
-    CapturedFrameMetadata.Reset();
+    ActiveSegmentFrameCount = 0;
     RecordedAudioPath.Reset();
+    RecordedAudioTimeline = FOmniCaptureAudioTimelineSummary();
     RecordedVideoPath.Reset();
 }
 
@@ -1192,7 +1659,7 @@ int64 UOmniCaptureSubsystem::CalculateActiveSegmentSizeBytes() const
     int64 TotalBytes = 0;
     IFileManager& FileManager = IFileManager::Get();
 
-    if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    if (ActiveSettings.OutputFormat != EOmniOutputFormat::PNGSequence || (LiveMuxer && !LiveMuxer->HasFailed()))
     {
         if (!RecordedVideoPath.IsEmpty())
         {
@@ -1281,7 +1748,7 @@ void UOmniCaptureSubsystem::UpdateRuntimeWarnings()
     if (ActiveSettings.TargetFrameRate > 0.0f)
     {
         const double ThresholdFps = ActiveSettings.TargetFrameRate * FMath::Clamp(static_cast<double>(ActiveSettings.LowFrameRateWarningRatio), 0.1, 1.0);
-        if (!bIsPaused && CurrentCaptureFPS > 0.0 && CurrentCaptureFPS < ThresholdFps)
+        if (!bIsPaused && !bFixedTimestepActive && CurrentCaptureFPS > 0.0 && CurrentCaptureFPS < ThresholdFps)
         {
             AddWarningUnique(OmniCapture::WarningLowFps);
         }
@@ -0,0 +1,306 @@
+#include "OmniCaptureTelemetry.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/Archive.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    FString GetStageKey(EOmniCaptureStage Stage)
+    {
+        return StaticEnum<EOmniCaptureStage>()->GetNameStringByValue(static_cast<int64>(Stage));
+    }
+
+    FString GetStateName(EOmniCaptureState State)
+    {
+        return StaticEnum<EOmniCaptureState>()->GetNameStringByValue(static_cast<int64>(State));
+    }
+
+    FString GetDropCauseKey(int32 Cause)
+    {
+        return StaticEnum<EOmniCaptureDropCause>()->GetNameStringByValue(Cause);
+    }
+
+    FString GetBottleneckKey(int32 Bottleneck)
+    {
+        return StaticEnum<EOmniCaptureBottleneck>()->GetNameStringByValue(Bottleneck);
+    }
+
+    constexpr int32 BottleneckCount = static_cast<int32>(EOmniCaptureBottleneck::Disk) + 1;
+
+    const FOmniCaptureStageTiming* FindStageTiming(const FOmniCaptureTelemetry& Snapshot, EOmniCaptureStage Stage)
+    {
+        return Snapshot.StageTimings.FindByPredicate([Stage](const FOmniCaptureStageTiming& Timing)
+        {
+            return Timing.Stage == Stage;
+        });
+    }
+
+    FString BuildCSVHeader()
+    {
+        FString Header = TEXT("seconds,state,frames,fps,segment,ring_pending,ring_blocked,encoder_pending,png_pending,bytes_written,metadata_bytes,write_bytes_per_sec,dropped,ring_drops,encoder_latency_ms,audio_drift_ms,audio_max_drift_ms,audio_pending,audio_error");
+        for (int32 CauseIndex = 0; CauseIndex < static_cast<int32>(EOmniCaptureDropCause::Count); ++CauseIndex)
+        {
+            Header += FString::Printf(TEXT(",drops_%s"), *GetDropCauseKey(CauseIndex));
+        }
+        for (int32 BottleneckIndex = 0; BottleneckIndex < BottleneckCount; ++BottleneckIndex)
+        {
+            Header += FString::Printf(TEXT(",%s_bound_drops"), *GetBottleneckKey(BottleneckIndex));
+        }
+        for (int32 StageIndex = 0; StageIndex < static_cast<int32>(EOmniCaptureStage::Count); ++StageIndex)
+        {
+            const FString Key = GetStageKey(static_cast<EOmniCaptureStage>(StageIndex));
+            Header += FString::Printf(TEXT(",%s_p50,%s_p95,%s_p99"), *Key, *Key, *Key);
+        }
+        return Header;
+    }
+
+    FString BuildCSVRow(const FOmniCaptureTelemetry& Snapshot)
+    {
+        FString Row = FString::Printf(TEXT("%.3f,%s,%d,%.3f,%d,%d,%d,%d,%d,%lld,%lld,%.1f,%d,%d,%.3f,%.3f,%.3f,%d,%d"),
+            Snapshot.CaptureSeconds,
+            *GetStateName(Snapshot.State),
+            Snapshot.FramesCaptured,
+            Snapshot.CaptureFPS,
+            Snapshot.SegmentIndex,
+            Snapshot.RingPendingFrames,
+            Snapshot.RingBlockedPushes,
+            Snapshot.EncoderPendingFrames,
+            Snapshot.PNGPendingWrites,
+            Snapshot.BytesWritten,
+            Snapshot.FrameMetadataBytes,
+            Snapshot.WriteBytesPerSecond,
+            Snapshot.DroppedFrames,
+            Snapshot.RingBufferDrops,
+            Snapshot.EncoderLatencyMs,
+            Snapshot.AudioDriftMs,
+            Snapshot.MaxAudioDriftMs,
+            Snapshot.AudioPendingPackets,
+            Snapshot.bAudioInError ? 1 : 0);
+
+        for (int32 CauseIndex = 0; CauseIndex < static_cast<int32>(EOmniCaptureDropCause::Count); ++CauseIndex)
+        {
+            Row += FString::Printf(TEXT(",%d"), Snapshot.DropsByCause.IsValidIndex(CauseIndex) ? Snapshot.DropsByCause[CauseIndex] : 0);
+        }
+        for (int32 BottleneckIndex = 0; BottleneckIndex < BottleneckCount; ++BottleneckIndex)
+        {
+            Row += FString::Printf(TEXT(",%d"), Snapshot.DropsByBottleneck.IsValidIndex(BottleneckIndex) ? Snapshot.DropsByBottleneck[BottleneckIndex] : 0);
+        }
+
+        // Every stage keeps its columns so rows stay aligned; stages without samples are left empty.
+        for (int32 StageIndex = 0; StageIndex < static_cast<int32>(EOmniCaptureStage::Count); ++StageIndex)
+        {
+            if (const FOmniCaptureStageTiming* Timing = FindStageTiming(Snapshot, static_cast<EOmniCaptureStage>(StageIndex)))
+            {
+                Row += FString::Printf(TEXT(",%.3f,%.3f,%.3f"), Timing->P50Ms, Timing->P95Ms, Timing->P99Ms);
+            }
+            else
+            {
+                Row += TEXT(",,,");
+            }
+        }
+        return Row;
+    }
+
+    FString BuildJSONLine(const FOmniCaptureTelemetry& Snapshot, int32 FirstDropSequence)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("seconds"), Snapshot.CaptureSeconds);
+        Object->SetStringField(TEXT("state"), GetStateName(Snapshot.State));
+        Object->SetNumberField(TEXT("frames"), Snapshot.FramesCaptured);
+        Object->SetNumberField(TEXT("fps"), Snapshot.CaptureFPS);
+        Object->SetNumberField(TEXT("segment"), Snapshot.SegmentIndex);
+
+        TSharedRef<FJsonObject> Queues = MakeShared<FJsonObject>();
+        Queues->SetNumberField(TEXT("ringPending"), Snapshot.RingPendingFrames);
+        Queues->SetNumberField(TEXT("ringBlocked"), Snapshot.RingBlockedPushes);
+        Queues->SetNumberField(TEXT("encoderPending"), Snapshot.EncoderPendingFrames);
+        Queues->SetNumberField(TEXT("pngPending"), Snapshot.PNGPendingWrites);
+        Object->SetObjectField(TEXT("queues"), Queues);
+
+        Object->SetNumberField(TEXT("bytesWritten"), static_cast<double>(Snapshot.BytesWritten));
+        Object->SetNumberField(TEXT("metadataBytes"), static_cast<double>(Snapshot.FrameMetadataBytes));
+        Object->SetNumberField(TEXT("writeBytesPerSec"), Snapshot.WriteBytesPerSecond);
+
+        TSharedRef<FJsonObject> Drops = MakeShared<FJsonObject>();
+        Drops->SetNumberField(TEXT("total"), Snapshot.DroppedFrames);
+        Drops->SetNumberField(TEXT("ringBuffer"), Snapshot.RingBufferDrops);
+
+        TSharedRef<FJsonObject> ByCause = MakeShared<FJsonObject>();
+        for (int32 CauseIndex = 0; CauseIndex < Snapshot.DropsByCause.Num(); ++CauseIndex)
+        {
+            ByCause->SetNumberField(GetDropCauseKey(CauseIndex), Snapshot.DropsByCause[CauseIndex]);
+        }
+        Drops->SetObjectField(TEXT("byCause"), ByCause);
+
+        TSharedRef<FJsonObject> ByBottleneck = MakeShared<FJsonObject>();
+        for (int32 BottleneckIndex = 0; BottleneckIndex < Snapshot.DropsByBottleneck.Num(); ++BottleneckIndex)
+        {
+            ByBottleneck->SetNumberField(GetBottleneckKey(BottleneckIndex), Snapshot.DropsByBottleneck[BottleneckIndex]);
+        }
+        Drops->SetObjectField(TEXT("byBottleneck"), ByBottleneck);
+
+        TArray<TSharedPtr<FJsonValue>> Events;
+        for (const FOmniCaptureDropEvent& Drop : Snapshot.RecentDrops)
+        {
+            if (Drop.Sequence < FirstDropSequence)
+            {
+                continue;
+            }
+
+            TSharedRef<FJsonObject> Event = MakeShared<FJsonObject>();
+            Event->SetNumberField(TEXT("sequence"), Drop.Sequence);
+            Event->SetNumberField(TEXT("index"), Drop.FrameIndex);
+            Event->SetNumberField(TEXT("time"), Drop.CaptureSeconds);
+            Event->SetStringField(TEXT("cause"), GetDropCauseKey(static_cast<int32>(Drop.Cause)));
+            Event->SetStringField(TEXT("bottleneck"), GetBottleneckKey(static_cast<int32>(Drop.Bottleneck)));
+            Event->SetStringField(TEXT("stage"), GetStageKey(Drop.Stage));
+            Event->SetNumberField(TEXT("stageMs"), Drop.StageMs);
+            Events.Add(MakeShared<FJsonValueObject>(Event));
+        }
+        if (Events.Num() > 0)
+        {
+            Drops->SetArrayField(TEXT("events"), Events);
+        }
+        Object->SetObjectField(TEXT("drops"), Drops);
+
+        Object->SetNumberField(TEXT("encoderLatencyMs"), Snapshot.EncoderLatencyMs);
+
+        TSharedRef<FJsonObject> Audio = MakeShared<FJsonObject>();
+        Audio->SetNumberField(TEXT("driftMs"), Snapshot.AudioDriftMs);
+        Audio->SetNumberField(TEXT("maxDriftMs"), Snapshot.MaxAudioDriftMs);
+        Audio->SetNumberField(TEXT("pending"), Snapshot.AudioPendingPackets);
+        Audio->SetBoolField(TEXT("error"), Snapshot.bAudioInError);
+        Object->SetObjectField(TEXT("audio"), Audio);
+
+        TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+        for (const FOmniCaptureStageTiming& Timing : Snapshot.StageTimings)
+        {
+            TSharedRef<FJsonObject> Stage = MakeShared<FJsonObject>();
+            Stage->SetNumberField(TEXT("samples"), static_cast<double>(Timing.Samples));
+            Stage->SetNumberField(TEXT("p50"), Timing.P50Ms);
+            Stage->SetNumberField(TEXT("p95"), Timing.P95Ms);
+            Stage->SetNumberField(TEXT("p99"), Timing.P99Ms);
+            Stage->SetNumberField(TEXT("max"), Timing.MaxMs);
+            Stages->SetObjectField(GetStageKey(Timing.Stage), Stage);
+        }
+        Object->SetObjectField(TEXT("stages"), Stages);
+
+        FString OutputString;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+        FJsonSerializer::Serialize(Object, Writer);
+        return OutputString;
+    }
+}
+
+void FOmniCaptureTelemetryChannel::Publish(const FOmniCaptureTelemetry& Snapshot)
+{
+    // Only the publishing thread flips PublishedIndex, so the back buffer stays unpublished until
+    // the store below. A reader that pinned it before the previous flip is waited out here.
+    const int32 BackIndex = 1 - PublishedIndex.Load();
+    while (Readers[BackIndex].Load() != 0)
+    {
+        FPlatformProcess::YieldThread();
+    }
+
+    Buffers[BackIndex] = Snapshot;
+    PublishedIndex.Store(BackIndex);
+}
+
+FOmniCaptureTelemetry FOmniCaptureTelemetryChannel::Read() const
+{
+    for (;;)
+    {
+        const int32 Index = PublishedIndex.Load();
+        ++Readers[Index];
+        if (PublishedIndex.Load() == Index)
+        {
+            FOmniCaptureTelemetry Snapshot = Buffers[Index];
+            --Readers[Index];
+            return Snapshot;
+        }
+        --Readers[Index];
+    }
+}
+
+void FOmniCaptureTelemetryChannel::Reset()
+{
+    Publish(FOmniCaptureTelemetry());
+}
+
+FOmniCaptureTelemetryStreamer::~FOmniCaptureTelemetryStreamer()
+{
+    Close();
+}
+
+bool FOmniCaptureTelemetryStreamer::Open(const FString& InFilePath, EOmniCaptureTelemetryFormat InFormat)
+{
+    Close();
+
+    if (InFormat == EOmniCaptureTelemetryFormat::None)
+    {
+        return false;
+    }
+
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*InFilePath, FILEWRITE_AllowRead));
+    if (!Archive)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to open OmniCapture telemetry stream %s"), *InFilePath);
+        return false;
+    }
+
+    FilePath = InFilePath;
+    Format = InFormat;
+    NextDropSequence = 0;
+
+    if (Format == EOmniCaptureTelemetryFormat::CSV)
+    {
+        WriteLine(BuildCSVHeader());
+        Archive->Flush();
+    }
+    return true;
+}
+
+void FOmniCaptureTelemetryStreamer::Write(const FOmniCaptureTelemetry& Snapshot)
+{
+    if (!Archive)
+    {
+        return;
+    }
+
+    WriteLine(Format == EOmniCaptureTelemetryFormat::CSV ? BuildCSVRow(Snapshot) : BuildJSONLine(Snapshot, NextDropSequence));
+    if (Snapshot.RecentDrops.Num() > 0)
+    {
+        NextDropSequence = Snapshot.RecentDrops.Last().Sequence + 1;
+    }
+
+    // Rows are infrequent; flushing each one keeps the file usable if the run dies mid-capture.
+    Archive->Flush();
+}
+
+void FOmniCaptureTelemetryStreamer::Close()
+{
+    if (Archive)
+    {
+        Archive->Close();
+        Archive.Reset();
+    }
+    Format = EOmniCaptureTelemetryFormat::None;
+}
+
+FString FOmniCaptureTelemetryStreamer::GetFileExtension(EOmniCaptureTelemetryFormat Format)
+{
+    return Format == EOmniCaptureTelemetryFormat::CSV ? TEXT(".csv") : TEXT(".jsonl");
+}
+
+void FOmniCaptureTelemetryStreamer::WriteLine(const FString& Line)
+{
+    FTCHARToUTF8 Converted(*Line);
+    Archive->Serialize(const_cast<ANSICHAR*>(Converted.Get()), Converted.Length());
+    ANSICHAR NewLine = '\n';
+    Archive->Serialize(&NewLine, 1);
+}
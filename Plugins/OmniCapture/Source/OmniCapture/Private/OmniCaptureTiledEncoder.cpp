@@ -0,0 +1,387 @@
+#include "OmniCaptureTiledEncoder.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "ImagePixelData.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureTiledEncoder, Log, All);
+
+namespace
+{
+    // Multiple of the 4:2:0 chroma step and of the encoders' 16 pixel block size.
+    constexpr int32 TileAlignment = 16;
+
+    template <typename PixelType>
+    TUniquePtr<FImagePixelData> CropPixels(const FImagePixelData& Source, const FIntRect& Region)
+    {
+        const void* RawData = nullptr;
+        int64 RawSize = 0;
+        Source.GetRawData(RawData, RawSize);
+
+        const PixelType* SourcePixels = static_cast<const PixelType*>(RawData);
+        const int64 SourceWidth = Source.GetSize().X;
+        const int32 Width = Region.Width();
+        const int32 Height = Region.Height();
+
+        TUniquePtr<TImagePixelData<PixelType>> Cropped = MakeUnique<TImagePixelData<PixelType>>(Region.Size());
+        Cropped->Pixels.SetNumUninitialized(static_cast<int64>(Width) * Height);
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            FMemory::Memcpy(
+                Cropped->Pixels.GetData() + static_cast<int64>(Row) * Width,
+                SourcePixels + (Region.Min.Y + Row) * SourceWidth + Region.Min.X,
+                Width * sizeof(PixelType));
+        }
+        return Cropped;
+    }
+}
+
+FOmniCaptureTiledEncoder::~FOmniCaptureTiledEncoder()
+{
+    Finalize();
+}
+
+TArray<FIntRect> FOmniCaptureTiledEncoder::ComputeTiles(const FIntPoint& InFrameSize, int32 MaxTileWidth)
+{
+    TArray<FIntRect> Result;
+    if (InFrameSize.X <= 0 || InFrameSize.Y <= 0)
+    {
+        return Result;
+    }
+
+    const int32 MaxWidth = FMath::Max(TileAlignment, (MaxTileWidth / TileAlignment) * TileAlignment);
+    const int32 NumTiles = FMath::DivideAndRoundUp(InFrameSize.X, MaxWidth);
+    const int32 TileWidth = FMath::Min(MaxWidth, Align(FMath::DivideAndRoundUp(InFrameSize.X, NumTiles), TileAlignment));
+
+    for (int32 X = 0; X < InFrameSize.X; X += TileWidth)
+    {
+        Result.Add(FIntRect(X, 0, FMath::Min(InFrameSize.X, X + TileWidth), InFrameSize.Y));
+    }
+    return Result;
+}
+
+void FOmniCaptureTiledEncoder::Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory)
+{
+    ActiveSettings = Settings;
+    FrameSize = GetEquirectSize(Settings);
+    FramesSubmitted = 0;
+    Tiles.Reset();
+
+    FString Directory = OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : OutputDirectory;
+    Directory = FPaths::ConvertRelativePathToFull(Directory);
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    const FString BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    ManifestPath = Directory / (BaseFileName + TEXT("_tiles.json"));
+
+    const TArray<FIntRect> Regions = ComputeTiles(FrameSize, GetMaxEncodeWidth(Settings));
+    for (int32 TileIndex = 0; TileIndex < Regions.Num(); ++TileIndex)
+    {
+        FOmniCaptureSettings TileSettings = Settings;
+        TileSettings.OutputFileName = FString::Printf(TEXT("%s_tile%d"), *BaseFileName, TileIndex);
+
+        FTile& Tile = Tiles.AddDefaulted_GetRef();
+        Tile.Region = Regions[TileIndex];
+        Tile.Encoder = CreateBackend(Settings.OutputFormat);
+        if (!Tile.Encoder)
+        {
+            Tiles.Reset();
+            return;
+        }
+
+        Tile.Encoder->SetEncodeRegion(Tile.Region);
+        Tile.Encoder->Initialize(TileSettings, Directory);
+        if (!Tile.Encoder->IsInitialized())
+        {
+            UE_LOG(LogOmniCaptureTiledEncoder, Warning, TEXT("Tile %d encoder failed to initialize; tiled encode disabled."), TileIndex);
+            for (FTile& Existing : Tiles)
+            {
+                Existing.Encoder->Finalize();
+            }
+            Tiles.Reset();
+            return;
+        }
+    }
+
+    // Written up front so a crashed capture still says how to put its tiles back together.
+    WriteManifest(0);
+    bInitialized = Tiles.Num() > 0;
+
+    UE_LOG(LogOmniCaptureTiledEncoder, Log, TEXT("Tiled encode: %dx%d split into %d columns of up to %d pixels."), FrameSize.X, FrameSize.Y, Tiles.Num(), Tiles.Num() > 0 ? Tiles[0].Region.Width() : 0);
+}
+
+void FOmniCaptureTiledEncoder::WriteManifest(int64 FrameCount) const
+{
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetNumberField(TEXT("version"), 1);
+    Root->SetNumberField(TEXT("width"), FrameSize.X);
+    Root->SetNumberField(TEXT("height"), FrameSize.Y);
+    Root->SetNumberField(TEXT("frameRate"), ActiveSettings.TargetFrameRate);
+    Root->SetNumberField(TEXT("frameCount"), static_cast<double>(FrameCount));
+    Root->SetStringField(TEXT("codec"), ActiveSettings.Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H264"));
+    Root->SetStringField(TEXT("layout"), TEXT("hstack"));
+
+    TArray<TSharedPtr<FJsonValue>> TileValues;
+    for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+    {
+        const FTile& Tile = Tiles[TileIndex];
+        TSharedRef<FJsonObject> TileObject = MakeShared<FJsonObject>();
+        TileObject->SetNumberField(TEXT("index"), TileIndex);
+        TileObject->SetNumberField(TEXT("x"), Tile.Region.Min.X);
+        TileObject->SetNumberField(TEXT("y"), Tile.Region.Min.Y);
+        TileObject->SetNumberField(TEXT("width"), Tile.Region.Width());
+        TileObject->SetNumberField(TEXT("height"), Tile.Region.Height());
+        TileObject->SetStringField(TEXT("path"), Tile.Encoder ? Tile.Encoder->GetOutputFilePath() : FString());
+        TileValues.Add(MakeShared<FJsonValueObject>(TileObject));
+    }
+    Root->SetArrayField(TEXT("tiles"), TileValues);
+
+    FString OutputString;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+    if (FJsonSerializer::Serialize(Root, Writer))
+    {
+        FFileHelper::SaveStringToFile(OutputString, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+    }
+}
+
+bool FOmniCaptureTiledEncoder::UsesGPUFrames() const
+{
+    return Tiles.Num() > 0 && Tiles[0].Encoder->UsesGPUFrames();
+}
+
+bool FOmniCaptureTiledEncoder::CropOnCPU(const FOmniCaptureFrame& Source, const FIntRect& Region, FOmniCaptureFrame& OutFrame)
+{
+    if (!Source.PixelData.IsValid())
+    {
+        return false;
+    }
+
+    switch (Source.PixelData->GetType())
+    {
+    case EImagePixelType::Float16:
+        OutFrame.PixelData = CropPixels<FFloat16Color>(*Source.PixelData, Region);
+        return true;
+    case EImagePixelType::Color:
+        OutFrame.PixelData = CropPixels<FColor>(*Source.PixelData, Region);
+        return true;
+    default:
+        return false;
+    }
+}
+
+TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> FOmniCaptureTiledEncoder::AcquireTileSlot(FTile& Tile)
+{
+    // Backend slots keep their encoder input bound across frames, so they are preferred.
+    TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> Slot = Tile.Encoder->AcquireInputSlot();
+    if (Slot.IsValid())
+    {
+        return Slot;
+    }
+
+    for (const TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe>& Fallback : Tile.FallbackSlots)
+    {
+        if (Fallback.GetSharedReferenceCount() == 1)
+        {
+            return Fallback;
+        }
+    }
+
+    return Tile.FallbackSlots.Add_GetRef(MakeShared<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe>());
+}
+
+bool FOmniCaptureTiledEncoder::CropOnGPU(const FOmniCaptureFrame& Source, FTile& Tile, FOmniCaptureFrame& OutFrame)
+{
+    if (Source.EncoderTextures.Num() == 0 || !Source.EncoderTextures[0].IsValid())
+    {
+        return false;
+    }
+
+    // Planes may be subsampled (NV12/P010 chroma), so each region is scaled by its plane's size.
+    const FIntPoint FullSize = Source.EncoderTextures[0]->GetSizeXY();
+    TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> Slot = AcquireTileSlot(Tile);
+    Slot->Planes.SetNum(Source.EncoderTextures.Num());
+
+    TArray<FTexture2DRHIRef> SourcePlanes;
+    TArray<FTexture2DRHIRef> TilePlanes;
+    TArray<FIntRect> PlaneRegions;
+    for (int32 PlaneIndex = 0; PlaneIndex < Source.EncoderTextures.Num(); ++PlaneIndex)
+    {
+        const FTexture2DRHIRef& Plane = Source.EncoderTextures[PlaneIndex];
+        if (!Plane.IsValid())
+        {
+            return false;
+        }
+
+        const FIntPoint PlaneSize = Plane->GetSizeXY();
+        const FIntRect PlaneRegion(
+            Tile.Region.Min.X * PlaneSize.X / FullSize.X,
+            Tile.Region.Min.Y * PlaneSize.Y / FullSize.Y,
+            Tile.Region.Max.X * PlaneSize.X / FullSize.X,
+            Tile.Region.Max.Y * PlaneSize.Y / FullSize.Y);
+
+        // Slot planes persist, so textures are only created when the tile layout changes.
+        TRefCountPtr<IPooledRenderTarget>& SlotPlane = Slot->Planes[PlaneIndex];
+        FRHITexture* Existing = SlotPlane.IsValid() ? SlotPlane->GetRHI() : nullptr;
+        if (!Existing || Existing->GetSizeXY() != PlaneRegion.Size() || Existing->GetFormat() != Plane->GetFormat())
+        {
+            const FRHITextureCreateDesc Desc = FRHITextureCreateDesc::Create2D(TEXT("OmniCaptureTilePlane"), PlaneRegion.Width(), PlaneRegion.Height(), Plane->GetFormat())
+                .SetFlags(Plane->GetDesc().Flags)
+                .SetInitialState(ERHIAccess::CopyDest);
+            FTexture2DRHIRef Created = RHICreateTexture(Desc);
+            if (!Created.IsValid())
+            {
+                SlotPlane.SafeRelease();
+                return false;
+            }
+            SlotPlane = CreateRenderTarget(Created, TEXT("OmniCaptureTilePlane"));
+        }
+
+        FTexture2DRHIRef TilePlane = SlotPlane->GetRHI()->GetTexture2D();
+
+        SourcePlanes.Add(Plane);
+        TilePlanes.Add(TilePlane);
+        PlaneRegions.Add(PlaneRegion);
+    }
+
+    FGPUFenceRHIRef Fence = RHICreateGPUFence(TEXT("OmniCaptureTileFence"));
+    ENQUEUE_RENDER_COMMAND(OmniCaptureCropTile)([SourcePlanes, TilePlanes, PlaneRegions, Fence](FRHICommandListImmediate& RHICmdList)
+    {
+        for (int32 PlaneIndex = 0; PlaneIndex < SourcePlanes.Num(); ++PlaneIndex)
+        {
+            RHICmdList.Transition(FRHITransitionInfo(SourcePlanes[PlaneIndex], ERHIAccess::Unknown, ERHIAccess::CopySrc));
+            RHICmdList.Transition(FRHITransitionInfo(TilePlanes[PlaneIndex], ERHIAccess::Unknown, ERHIAccess::CopyDest));
+
+            FRHICopyTextureInfo CopyInfo;
+            CopyInfo.Size = FIntVector(PlaneRegions[PlaneIndex].Width(), PlaneRegions[PlaneIndex].Height(), 1);
+            CopyInfo.SourcePosition = FIntVector(PlaneRegions[PlaneIndex].Min.X, PlaneRegions[PlaneIndex].Min.Y, 0);
+            RHICmdList.CopyTexture(SourcePlanes[PlaneIndex], TilePlanes[PlaneIndex], CopyInfo);
+
+            RHICmdList.Transition(FRHITransitionInfo(TilePlanes[PlaneIndex], ERHIAccess::CopyDest, ERHIAccess::SRVMask));
+            RHICmdList.Transition(FRHITransitionInfo(SourcePlanes[PlaneIndex], ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+        }
+
+        if (Fence.IsValid())
+        {
+            RHICmdList.WriteGPUFence(Fence);
+        }
+    });
+
+    OutFrame.EncoderTextures = TilePlanes;
+    OutFrame.Texture = TilePlanes[0];
+    OutFrame.ReadyFence = Fence;
+    OutFrame.EncoderSlot = MoveTemp(Slot);
+    return true;
+}
+
+void FOmniCaptureTiledEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    const bool bGPU = UsesGPUFrames();
+    TArray<FOmniCaptureFrame> TileFrames;
+    TileFrames.SetNum(Tiles.Num());
+
+    // Crops are independent, so CPU tiles copy in parallel; GPU tiles only record copy commands.
+    TArray<bool> Cropped;
+    Cropped.SetNumZeroed(Tiles.Num());
+    ParallelFor(Tiles.Num(), [this, &Frame, &TileFrames, &Cropped, bGPU](int32 TileIndex)
+    {
+        FOmniCaptureFrame& TileFrame = TileFrames[TileIndex];
+        TileFrame.Metadata = Frame.Metadata;
+        TileFrame.bLinearColor = Frame.bLinearColor;
+        TileFrame.bUsedCPUFallback = Frame.bUsedCPUFallback;
+        Cropped[TileIndex] = bGPU ? true : CropOnCPU(Frame, Tiles[TileIndex].Region, TileFrame);
+    }, bGPU ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    if (bGPU)
+    {
+        for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+        {
+            Cropped[TileIndex] = !Frame.bUsedCPUFallback && CropOnGPU(Frame, Tiles[TileIndex], TileFrames[TileIndex]);
+        }
+    }
+
+    // Every tile must get every frame or the columns drift apart when stitched.
+    if (Cropped.Contains(false))
+    {
+        UE_LOG(LogOmniCaptureTiledEncoder, Warning, TEXT("Unable to split frame %d into tiles; dropping it for all tiles."), Frame.Metadata.FrameIndex);
+        return;
+    }
+
+    for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+    {
+        Tiles[TileIndex].Encoder->EnqueueFrame(TileFrames[TileIndex]);
+    }
+    ++FramesSubmitted;
+}
+
+void FOmniCaptureTiledEncoder::Finalize()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    for (FTile& Tile : Tiles)
+    {
+        Tile.Encoder->Finalize();
+    }
+
+    WriteManifest(FramesSubmitted);
+    bInitialized = false;
+}
+
+FOmniCaptureEncoderLatencyStats FOmniCaptureTiledEncoder::GetLatencyStats() const
+{
+    // A frame is only done once its slowest tile is, so latencies take the max across tiles.
+    FOmniCaptureEncoderLatencyStats Combined;
+    for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+    {
+        const FOmniCaptureEncoderLatencyStats TileStats = Tiles[TileIndex].Encoder->GetLatencyStats();
+        Combined.FramesEncoded = TileIndex == 0 ? TileStats.FramesEncoded : FMath::Min(Combined.FramesEncoded, TileStats.FramesEncoded);
+        Combined.PendingFrames = FMath::Max(Combined.PendingFrames, TileStats.PendingFrames);
+        Combined.LastLatencyMs = FMath::Max(Combined.LastLatencyMs, TileStats.LastLatencyMs);
+        Combined.AverageLatencyMs = FMath::Max(Combined.AverageLatencyMs, TileStats.AverageLatencyMs);
+        Combined.PeakLatencyMs = FMath::Max(Combined.PeakLatencyMs, TileStats.PeakLatencyMs);
+    }
+    return Combined;
+}
+
+FOmniCaptureBitstreamStats FOmniCaptureTiledEncoder::GetBitstreamStats() const
+{
+    FOmniCaptureBitstreamStats Combined;
+    for (const FTile& Tile : Tiles)
+    {
+        const FOmniCaptureBitstreamStats TileStats = Tile.Encoder->GetBitstreamStats();
+        Combined.TotalBytes += TileStats.TotalBytes;
+        Combined.TotalPackets += TileStats.TotalPackets;
+        Combined.BytesPerSecond += TileStats.BytesPerSecond;
+        Combined.PacketsPerSecond += TileStats.PacketsPerSecond;
+        Combined.PeakQueuedBytes += TileStats.PeakQueuedBytes;
+        Combined.WriterStalls += TileStats.WriterStalls;
+    }
+    return Combined;
+}
+
+bool FOmniCaptureTiledEncoder::IsStalled() const
+{
+    for (const FTile& Tile : Tiles)
+    {
+        if (Tile.Encoder->IsStalled())
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,83 @@
+#include "OmniCaptureVideoEncoder.h"
+
+#include "OmniCaptureNVENCEncoder.h"
+#include "OmniCaptureSoftwareEncoder.h"
+#include "OmniCaptureStageTimings.h"
+#include "OmniCaptureTiledEncoder.h"
+
+FIntPoint IOmniVideoEncoder::GetEquirectSize(const FOmniCaptureSettings& Settings)
+{
+    const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+    const bool bSideBySide = bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
+    return FIntPoint(
+        bSideBySide ? Settings.Resolution * 4 : Settings.Resolution * 2,
+        bStereo && !bSideBySide ? Settings.Resolution * 2 : Settings.Resolution);
+}
+
+int32 IOmniVideoEncoder::GetMaxEncodeWidth(const FOmniCaptureSettings& Settings)
+{
+    if (Settings.MaxEncodeWidth <= 0)
+    {
+        return 0;
+    }
+
+    if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    {
+        const int32 CodecLimit = Settings.Codec == EOmniCaptureCodec::H264 ? 4096 : 8192;
+        return FMath::Min(Settings.MaxEncodeWidth, CodecLimit);
+    }
+
+    return Settings.MaxEncodeWidth;
+}
+
+int32 IOmniVideoEncoder::GetLatitudeQPOffset(const FOmniCaptureSettings& Settings, int32 Row)
+{
+    const FIntPoint Size = GetEquirectSize(Settings);
+    const bool bTopBottom = Settings.Mode == EOmniCaptureMode::Stereo && Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom;
+    const int32 EyeHeight = FMath::Max(1, bTopBottom ? Size.Y / 2 : Size.Y);
+    const int32 EyeRow = FMath::Clamp(Row, 0, Size.Y - 1) % EyeHeight;
+
+    const double Latitude = (0.5 - (EyeRow + 0.5) / EyeHeight) * PI;
+    const double Stretch = 1.0 / FMath::Max(FMath::Cos(Latitude), 1.0e-3);
+    return FMath::Clamp(FMath::RoundToInt(6.0 * FMath::Log2(Stretch)), 0, Settings.Quality.MaxPolarQPOffset);
+}
+
+FIntPoint IOmniVideoEncoder::GetEncodeSize(const FOmniCaptureSettings& Settings) const
+{
+    return EncodeRegion.Area() > 0 ? EncodeRegion.Size() : GetEquirectSize(Settings);
+}
+
+TUniquePtr<IOmniVideoEncoder> IOmniVideoEncoder::Create(const FOmniCaptureSettings& Settings)
+{
+    // Wider than one encoder session accepts: split into columns encoded side by side.
+    const int32 MaxEncodeWidth = GetMaxEncodeWidth(Settings);
+    if (MaxEncodeWidth > 0 && GetEquirectSize(Settings).X > MaxEncodeWidth)
+    {
+        return MakeUnique<FOmniCaptureTiledEncoder>();
+    }
+
+    return CreateBackend(Settings.OutputFormat);
+}
+
+TUniquePtr<IOmniVideoEncoder> IOmniVideoEncoder::CreateBackend(EOmniOutputFormat Format)
+{
+    switch (Format)
+    {
+    case EOmniOutputFormat::NVENCHardware:
+        return MakeUnique<FOmniCaptureNVENCEncoder>();
+    case EOmniOutputFormat::SoftwareEncoder:
+        return MakeUnique<FOmniCaptureSoftwareEncoder>();
+    default:
+        return nullptr;
+    }
+}
+
+void IOmniVideoEncoder::RecordLatency(FOmniCaptureEncoderLatencyStats& Stats, double LatencySeconds)
+{
+    const double LatencyMs = LatencySeconds * 1000.0;
+    ++Stats.FramesEncoded;
+    Stats.LastLatencyMs = LatencyMs;
+    Stats.AverageLatencyMs += (LatencyMs - Stats.AverageLatencyMs) / static_cast<double>(Stats.FramesEncoded);
+    Stats.PeakLatencyMs = FMath::Max(Stats.PeakLatencyMs, LatencyMs);
+    FOmniCaptureStageTimings::Get().Record(EOmniCaptureStage::VideoEncode, LatencyMs);
+}
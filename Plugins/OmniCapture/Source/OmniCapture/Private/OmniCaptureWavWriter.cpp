@@ -0,0 +1,266 @@
+#include "OmniCaptureWavWriter.h"
+
+#include "OmniCaptureAudioConverter.h"
+#include "OmniCaptureAudioRing.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureWav, Log, All);
+
+namespace
+{
+    // RIFF(12) + JUNK/ds64(8 + 28) + fmt WAVE_FORMAT_EXTENSIBLE(8 + 40) + data(8)
+    constexpr int64 WavHeaderSize = 12 + 36 + 48 + 8;
+    constexpr int32 WavDrainChunkSamples = 64 * 1024;
+
+    void WriteTag(TArray<uint8>& Out, const char* Tag)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Tag), 4);
+    }
+
+    template <typename T>
+    void WriteValue(TArray<uint8>& Out, T Value)
+    {
+        for (int32 Byte = 0; Byte < static_cast<int32>(sizeof(T)); ++Byte)
+        {
+            Out.Add(static_cast<uint8>((static_cast<uint64>(Value) >> (Byte * 8)) & 0xFF));
+        }
+    }
+
+    uint32 GetChannelMask(int32 NumChannels, bool bAmbisonic)
+    {
+        // AmbiX B-format has no speaker positions; a mask would make players treat 4 channels as quad.
+        if (bAmbisonic)
+        {
+            return 0;
+        }
+
+        switch (NumChannels)
+        {
+        case 1: return 0x4;
+        case 2: return 0x3;
+        case 4: return 0x33;
+        case 6: return 0x3F;
+        case 8: return 0x63F;
+        default: return 0;
+        }
+    }
+}
+
+class FOmniCaptureWavWorker final : public FRunnable
+{
+public:
+    FOmniCaptureWavWorker(FOmniCaptureWavWriter& InOwner, FEvent* InWakeEvent, TAtomic<bool>& InRunning)
+        : Owner(InOwner)
+        , WakeEvent(InWakeEvent)
+        , bRunning(InRunning)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning.Load())
+        {
+            Owner.Drain();
+            WakeEvent->Wait(20);
+        }
+
+        Owner.Drain();
+        return 0;
+    }
+
+private:
+    FOmniCaptureWavWriter& Owner;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool>& bRunning;
+};
+
+FOmniCaptureWavWriter::FOmniCaptureWavWriter()
+{
+    bRunning = false;
+    DataBytes = 0;
+}
+
+FOmniCaptureWavWriter::~FOmniCaptureWavWriter()
+{
+    StopWorker();
+
+    if (Archive)
+    {
+        Archive->Close();
+        Archive.Reset();
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+bool FOmniCaptureWavWriter::Open(const FString& InFilePath, FOmniCaptureAudioRing& InRing, EOmniCaptureAudioFormat InFormat)
+{
+    if (Archive)
+    {
+        return false;
+    }
+
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*InFilePath, FILEWRITE_AllowRead));
+    if (!Archive)
+    {
+        UE_LOG(LogOmniCaptureWav, Warning, TEXT("Failed to open audio file %s"), *InFilePath);
+        return false;
+    }
+
+    FilePath = InFilePath;
+    Ring = &InRing;
+    Format = InFormat;
+    BytesPerSample = FOmniCaptureAudioConverter::GetBytesPerSample(InFormat);
+    DataBytes = 0;
+
+    // Placeholder header; rewritten with the real format and sizes on Close.
+    WriteHeader(48000, 2, false, false);
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    }
+
+    bRunning = true;
+    Worker = new FOmniCaptureWavWorker(*this, WakeEvent, bRunning);
+    Thread = FRunnableThread::Create(Worker, TEXT("OmniCaptureWavWriter"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        bRunning = false;
+        delete Worker;
+        Worker = nullptr;
+    }
+
+    return true;
+}
+
+void FOmniCaptureWavWriter::Wake()
+{
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FOmniCaptureWavWriter::Drain()
+{
+    FScopeLock Lock(&WriteCS);
+    if (!Archive || !Ring)
+    {
+        return;
+    }
+
+    const uint8* Data = nullptr;
+    int32 NumSamples = 0;
+    while ((NumSamples = Ring->PeekSamples(Data, WavDrainChunkSamples)) > 0)
+    {
+        const int64 NumBytes = static_cast<int64>(NumSamples) * BytesPerSample;
+        Archive->Serialize(const_cast<uint8*>(Data), NumBytes);
+        Ring->ConsumeSamples(NumSamples);
+        DataBytes.AddExchange(static_cast<uint64>(NumBytes));
+    }
+}
+
+bool FOmniCaptureWavWriter::Close(int32 SampleRate, int32 NumChannels, bool bAmbisonic)
+{
+    StopWorker();
+    Drain();
+
+    FScopeLock Lock(&WriteCS);
+    if (!Archive)
+    {
+        return false;
+    }
+
+    const uint64 DataSize = DataBytes.Load();
+    if (DataSize % 2 != 0)
+    {
+        uint8 Pad = 0;
+        Archive->Serialize(&Pad, 1);
+    }
+
+    const bool bRF64 = DataSize + WavHeaderSize > static_cast<uint64>(MAX_uint32);
+    Archive->Seek(0);
+    WriteHeader(SampleRate, NumChannels, bAmbisonic, bRF64);
+
+    const bool bSuccess = !Archive->IsError();
+    Archive->Close();
+    Archive.Reset();
+    Ring = nullptr;
+
+    if (!bSuccess)
+    {
+        UE_LOG(LogOmniCaptureWav, Warning, TEXT("Failed to finalize audio file %s"), *FilePath);
+    }
+
+    return bSuccess && DataSize > 0;
+}
+
+void FOmniCaptureWavWriter::WriteHeader(int32 SampleRate, int32 NumChannels, bool bAmbisonic, bool bRF64)
+{
+    const uint64 DataSize = DataBytes.Load();
+    const uint64 RiffSize = DataSize + (DataSize % 2) + WavHeaderSize - 8;
+    const int32 BlockAlign = NumChannels * BytesPerSample;
+    const uint64 FrameCount = BlockAlign > 0 ? DataSize / BlockAlign : 0;
+    const bool bFloat = Format == EOmniCaptureAudioFormat::Float32;
+
+    TArray<uint8> Header;
+    Header.Reserve(WavHeaderSize);
+
+    WriteTag(Header, bRF64 ? "RF64" : "RIFF");
+    WriteValue<uint32>(Header, bRF64 ? MAX_uint32 : static_cast<uint32>(RiffSize));
+    WriteTag(Header, "WAVE");
+
+    // Reserved up front so a file that outgrows 4 GB can become RF64 without moving the data.
+    WriteTag(Header, bRF64 ? "ds64" : "JUNK");
+    WriteValue<uint32>(Header, 28);
+    WriteValue<uint64>(Header, bRF64 ? RiffSize : 0);
+    WriteValue<uint64>(Header, bRF64 ? DataSize : 0);
+    WriteValue<uint64>(Header, bRF64 ? FrameCount : 0);
+    WriteValue<uint32>(Header, 0);
+
+    WriteTag(Header, "fmt ");
+    WriteValue<uint32>(Header, 40);
+    WriteValue<uint16>(Header, 0xFFFE);
+    WriteValue<uint16>(Header, static_cast<uint16>(NumChannels));
+    WriteValue<uint32>(Header, static_cast<uint32>(SampleRate));
+    WriteValue<uint32>(Header, static_cast<uint32>(SampleRate * BlockAlign));
+    WriteValue<uint16>(Header, static_cast<uint16>(BlockAlign));
+    WriteValue<uint16>(Header, static_cast<uint16>(BytesPerSample * 8));
+    WriteValue<uint16>(Header, 22);
+    WriteValue<uint16>(Header, static_cast<uint16>(BytesPerSample * 8));
+    WriteValue<uint32>(Header, GetChannelMask(NumChannels, bAmbisonic));
+    const uint8 SubFormat[16] = { static_cast<uint8>(bFloat ? 0x03 : 0x01), 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+    Header.Append(SubFormat, UE_ARRAY_COUNT(SubFormat));
+
+    WriteTag(Header, "data");
+    WriteValue<uint32>(Header, bRF64 ? MAX_uint32 : static_cast<uint32>(DataSize));
+
+    check(Header.Num() == WavHeaderSize);
+    Archive->Serialize(Header.GetData(), Header.Num());
+}
+
+void FOmniCaptureWavWriter::StopWorker()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    bRunning = false;
+    Wake();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+    delete Worker;
+    Worker = nullptr;
+}
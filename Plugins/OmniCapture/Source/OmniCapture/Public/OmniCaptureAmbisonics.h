@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class OMNICAPTURE_API FOmniCaptureAmbisonicEncoder
+{
+public:
+    // Largest block Process encodes per call; longer submix buffers are encoded in chunks.
+    static constexpr int32 MaxBlockFrames = 8192;
+
+    // Sizes every buffer and builds the matrix for the expected bed, so Process never allocates.
+    void Configure(EOmniCaptureAmbisonicOrder InOrder, int32 ExpectedChannels);
+
+    bool IsEnabled() const { return Order != EOmniCaptureAmbisonicOrder::None; }
+    int32 GetOutputChannels() const { return OutputChannels; }
+
+    // Encodes up to MaxBlockFrames interleaved speaker-bed frames to interleaved AmbiX (ACN/SN3D); the result stays
+    // valid until the next call. Returns null for beds wider than the converter accepts.
+    const float* Process(const float* InData, int32 NumFrames, int32 NumChannels);
+
+    static int32 GetChannelCount(EOmniCaptureAmbisonicOrder InOrder);
+    static int32 GetOrderIndex(EOmniCaptureAmbisonicOrder InOrder);
+
+private:
+    void BuildMatrix(int32 NumChannels);
+
+private:
+    EOmniCaptureAmbisonicOrder Order = EOmniCaptureAmbisonicOrder::None;
+    int32 OutputChannels = 0;
+    int32 MatrixChannels = 0;
+    TArray<float> Matrix;
+    TArray<float> Output;
+};
+
+struct OMNICAPTURE_API FOmniCaptureSpatialAudioMetadata
+{
+    // Adds a Spatial Audio (SA3D) box to the first sound track's sample entry. The moov box must be the last top-level box.
+    static bool InjectAmbisonicBox(const FString& FilePath, EOmniCaptureAmbisonicOrder InOrder);
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class OMNICAPTURE_API FOmniCaptureAudioConverter
+{
+public:
+    void Configure(EOmniCaptureAudioFormat InFormat, float InGain, const TArray<float>& InChannelGains, bool bInDither);
+
+    void Convert(const float* Source, int32 NumSamples, int32 NumChannels, int32 FirstChannel, uint8* Dest);
+    void ConvertScalar(const float* Source, int32 NumSamples, int32 NumChannels, int32 FirstChannel, uint8* Dest);
+
+    EOmniCaptureAudioFormat GetFormat() const { return Format; }
+    int32 GetBytesPerSample() const { return GetBytesPerSample(Format); }
+    static int32 GetBytesPerSample(EOmniCaptureAudioFormat InFormat);
+
+    // Third-order AmbiX. The gain table is allocated for this many channels up front so the audio
+    // thread never resizes it; wider blocks are written as silence.
+    static constexpr int32 MaxChannels = 16;
+
+private:
+    void PrepareGainTable(int32 NumChannels);
+    float NextDither();
+
+private:
+    EOmniCaptureAudioFormat Format = EOmniCaptureAudioFormat::PCM16;
+    float Gain = 1.0f;
+    TArray<float> ChannelGains;
+    TArray<float> GainTable;
+    int32 GainTableChannels = 0;
+    uint32 DitherState = 0x9E3779B9u;
+    bool bDither = false;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "Templates/Atomic.h"
+
+class FEvent;
+class FRunnableThread;
+class FOmniCaptureAudioRing;
+
+class OMNICAPTURE_API FOmniCaptureAudioEncoder
+{
+public:
+    FOmniCaptureAudioEncoder();
+    ~FOmniCaptureAudioEncoder();
+
+    bool Open(const FOmniCaptureSettings& Settings, const FString& InBasePath, FOmniCaptureAudioRing& InRing, EOmniCaptureAudioFormat InFormat);
+    bool Close();
+
+    void SetStreamFormat(int32 SampleRate, int32 NumChannels);
+    bool IsOpen() const { return Ring != nullptr; }
+    bool HasFailed() const { return bFailed.Load(); }
+    void Wake();
+    void Drain();
+
+    const FString& GetFilePath() const { return FilePath; }
+    uint64 GetBytesWritten() const { return Pipe.GetBytesWritten(); }
+
+    static FString GetFileExtension(EOmniCaptureAudioCodec Codec);
+
+private:
+    bool LaunchEncoder(int32 SampleRate, int32 NumChannels);
+    void StopWorker();
+
+private:
+    FOmniCaptureFFmpegPipe Pipe;
+    FOmniCaptureAudioRing* Ring = nullptr;
+    FString Binary;
+    FString BasePath;
+    FString FilePath;
+    EOmniCaptureAudioCodec Codec = EOmniCaptureAudioCodec::AAC;
+    EOmniCaptureAudioFormat Format = EOmniCaptureAudioFormat::PCM16;
+    int32 BitrateKbps = 192;
+    int32 BytesPerSample = 2;
+    bool bDiscreteChannels = false;
+
+    FCriticalSection EncodeCS;
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    class FOmniCaptureAudioEncodeWorker* Worker = nullptr;
+    TAtomic<bool> bRunning;
+    TAtomic<bool> bFailed;
+    TAtomic<int32> StreamSampleRate;
+    TAtomic<int32> StreamChannels;
+};
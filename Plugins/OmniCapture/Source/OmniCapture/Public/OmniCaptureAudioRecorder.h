@@ -2,6 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureAudioRing.h"
+#include "OmniCaptureAudioTimeline.h"
+#include "OmniCaptureAmbisonics.h"
+#include "OmniCaptureWavWriter.h"
+#include "OmniCaptureAudioEncoder.h"
 #include "Templates/Atomic.h"
 
 class UWorld;
@@ -17,19 +22,22 @@ class OMNICAPTURE_API FOmniCaptureAudioRecorder
 public:
     FOmniCaptureAudioRecorder();
 
-    bool Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings);
+    bool Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings, double InClockOrigin);
     void Start();
-    void Stop(const FString& OutputDirectory, const FString& BaseFileName);
+    void Stop();
 
-    void GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets);
+    void GatherAudio(double FrameTimestamp, TArray<FOmniAudioSpan, TInlineAllocator<8>>& OutSpans);
     FString GetDebugStatus() const;
     int32 GetPendingPacketCount() const;
 
     void SetPaused(bool bInPaused);
+    void SetLockstep(bool bInLockstep) { Timeline.SetLockstep(bInLockstep); }
+    bool IsNonRealtimeDevice() const;
     bool IsPaused() const { return bPaused.Load(); }
 
     bool IsRecording() const { return bIsRecording; }
     FString GetOutputFilePath() const { return OutputFilePath; }
+    FOmniCaptureAudioTimelineSummary GetTimelineSummary() const { return Timeline.GetSummary(); }
 
 private:
     void RegisterListener();
@@ -41,15 +49,25 @@ private:
     float Gain = 1.0f;
     FString OutputFilePath;
 
-    mutable FCriticalSection PacketCS;
-    TQueue<FOmniAudioPacket, EQueueMode::Mpsc> PendingPackets;
+    FOmniCaptureAudioRing AudioRing;
+    FOmniCaptureAudioConverter Converter;
+    FOmniCaptureWavWriter WavWriter;
+    FOmniCaptureAudioEncoder Encoder;
+    FOmniCaptureSettings EncoderSettings;
+    FString OutputBasePath;
+    bool bUseEncoder = false;
+    FOmniCaptureAudioTimeline Timeline;
+    FOmniCaptureAmbisonicEncoder AmbisonicEncoder;
     TWeakObjectPtr<USoundSubmix> TargetSubmix;
     class FOmniCaptureSubmixListener* SubmixListener = nullptr;
     class Audio::FMixerDevice* MixerDevice = nullptr;
-    double AudioClockOrigin = -1.0;
+    double ClockOrigin = 0.0;
+    double FrameDuration = 1.0 / 60.0;
+    double PauseStartTime = 0.0;
+    TAtomic<int64> PausedMicroseconds = 0;
     double AudioStartTime = 0.0;
-    int32 CachedSampleRate = 48000;
-    TAtomic<int32> PendingPacketCount = 0;
+    TAtomic<int32> CachedSampleRate = 48000;
+    TAtomic<int32> CachedNumChannels = 0;
     TAtomic<bool> bPaused = false;
 };
 
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureAudioConverter.h"
+#include "Templates/Atomic.h"
+
+class OMNICAPTURE_API FOmniCaptureAudioRing
+{
+public:
+    void Initialize(int32 InSampleCapacity, int32 InMarkerCapacity, EOmniCaptureAudioFormat InFormat);
+    void Reset();
+
+    bool Write(const float* AudioData, int32 NumSamples, double Timestamp, int32 SampleRate, int32 NumChannels, FOmniCaptureAudioConverter& Converter);
+
+    template <typename AllocatorType>
+    void Gather(double MaxTimestamp, TArray<FOmniAudioSpan, AllocatorType>& OutSpans)
+    {
+        FOmniAudioSpan Span;
+        while (PopMarker(MaxTimestamp, Span))
+        {
+            OutSpans.Add(Span);
+        }
+    }
+
+    int32 PeekSamples(const uint8*& OutData, int32 MaxSamples) const;
+    void ConsumeSamples(int32 NumSamples);
+
+    int32 GetPendingMarkerCount() const;
+    uint64 GetDroppedSampleCount() const { return DroppedSamples.Load(); }
+    uint64 GetDroppedMarkerCount() const { return DroppedMarkers.Load(); }
+    int32 GetSampleCapacity() const { return SampleCapacity; }
+
+private:
+    struct FMarker
+    {
+        double Timestamp = 0.0;
+        int32 NumSamples = 0;
+        int32 SampleRate = 0;
+        int32 NumChannels = 0;
+    };
+
+    bool PopMarker(double MaxTimestamp, FOmniAudioSpan& OutSpan);
+
+private:
+    TArray<uint8> Buffer;
+    TArray<FMarker> Markers;
+    EOmniCaptureAudioFormat Format = EOmniCaptureAudioFormat::PCM16;
+    int32 BytesPerSample = 2;
+    int32 SampleCapacity = 0;
+    uint64 SampleMask = 0;
+    uint64 MarkerMask = 0;
+
+    TAtomic<uint64> SampleHead { 0 };
+    TAtomic<uint64> SampleTail { 0 };
+    TAtomic<uint64> MarkerHead { 0 };
+    TAtomic<uint64> MarkerTail { 0 };
+    TAtomic<uint64> DroppedSamples { 0 };
+    TAtomic<uint64> DroppedMarkers { 0 };
+};
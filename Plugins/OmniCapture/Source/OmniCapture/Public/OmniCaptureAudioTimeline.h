@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+struct FOmniCaptureAudioTimelineSummary
+{
+    double StartTime = 0.0;
+    int32 SampleRate = 0;
+    int32 NumChannels = 0;
+    int64 FramesWritten = 0;
+    int64 FramesInserted = 0;
+    int64 FramesDropped = 0;
+    double MaxDriftMilliseconds = 0.0;
+
+    bool IsValid() const { return SampleRate > 0 && FramesWritten > 0; }
+};
+
+struct FOmniCaptureAudioBlock
+{
+    const float* Data = nullptr;
+    int32 NumFrames = 0;
+    double Timestamp = 0.0;
+};
+
+// Process runs on the audio render thread: it never locks or allocates. Counters are published
+// through atomics, so GetSummary can be called from any thread.
+class OMNICAPTURE_API FOmniCaptureAudioTimeline
+{
+public:
+    FOmniCaptureAudioTimeline();
+
+    void Reset();
+    void SetLockstep(bool bInLockstep) { bLockstep = bInLockstep; }
+
+    bool Process(const float* InData, int32 NumFrames, int32 InNumChannels, int32 InSampleRate, double ReferenceSeconds, FOmniCaptureAudioBlock& OutBlock);
+    // Un-counts the last block when the caller could not store it; the gap is padded with silence on a later block.
+    void DiscardBlock(const FOmniCaptureAudioBlock& Block);
+
+    double GetDriftMilliseconds() const { return DriftMicroseconds.Load() / 1000.0; }
+    FOmniCaptureAudioTimelineSummary GetSummary() const;
+
+private:
+    int32 Resample(const float* InData, int32 NumFrames, int32 InNumChannels, int32 OutFrames, float* OutData) const;
+    void PublishSummary();
+
+private:
+    // Audio-thread state.
+    TArray<float> Scratch;
+    double StartTime = -1.0;
+    double SmoothedDrift = 0.0;
+    int32 SampleRate = 0;
+    int32 NumChannels = 0;
+    int64 FramesWritten = 0;
+    int64 FramesInserted = 0;
+    int64 FramesDropped = 0;
+    double MaxDriftSeconds = 0.0;
+    bool bLockstep = false;
+
+    // Published copies. Doubles are stored as their bit patterns so they round-trip exactly.
+    TAtomic<int64> DriftMicroseconds { 0 };
+    TAtomic<int64> PublishedStartTimeBits { 0 };
+    TAtomic<int64> PublishedMaxDriftBits { 0 };
+    TAtomic<int32> PublishedSampleRate { 0 };
+    TAtomic<int32> PublishedNumChannels { 0 };
+    TAtomic<int64> PublishedFramesWritten { 0 };
+    TAtomic<int64> PublishedFramesInserted { 0 };
+    TAtomic<int64> PublishedFramesDropped { 0 };
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Atomic.h"
+
+class FEvent;
+class FRunnableThread;
+class IFileHandle;
+
+class OMNICAPTURE_API FOmniCaptureBitstreamWriter
+{
+public:
+    static constexpr int64 DefaultWriteAlignment = 1024 * 1024;
+    static constexpr int64 DefaultFlushThreshold = 8 * 1024 * 1024;
+
+    FOmniCaptureBitstreamWriter();
+    ~FOmniCaptureBitstreamWriter();
+
+    bool Open(const FString& InFilePath, int64 InFlushThreshold = DefaultFlushThreshold, int64 InWriteAlignment = DefaultWriteAlignment);
+    void Close();
+
+    bool IsOpen() const { return FileHandle.IsValid(); }
+    void AppendPacket(const uint8* Data, int64 Size);
+    void Drain();
+
+    const FString& GetFilePath() const { return FilePath; }
+    FOmniCaptureBitstreamStats GetStats() const;
+
+private:
+    void SwapBuffersLocked(bool bFinal);
+    void StopWorker();
+
+private:
+    TUniquePtr<IFileHandle> FileHandle;
+    FString FilePath;
+    int64 FlushThreshold = DefaultFlushThreshold;
+    int64 WriteAlignment = DefaultWriteAlignment;
+
+    // Producers append to FrontBuffer; the writer thread owns BackBuffer while bBackBufferBusy.
+    mutable FCriticalSection BufferCS;
+    TArray<uint8> FrontBuffer;
+    TArray<uint8> BackBuffer;
+    bool bBackBufferBusy = false;
+
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    class FOmniCaptureBitstreamWorker* Worker = nullptr;
+    TAtomic<bool> bRunning;
+
+    FOmniCaptureBitstreamStats Stats;
+    double RateWindowStart = 0.0;
+    int64 RateWindowBytes = 0;
+    int64 RateWindowPackets = 0;
+};
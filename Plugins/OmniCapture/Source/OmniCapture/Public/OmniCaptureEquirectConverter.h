@@ -4,6 +4,38 @@
 #include "OmniCaptureTypes.h"
 #include "OmniCaptureRigActor.h"
 
+class FOmniCaptureSubframeAccumulator;
+
+struct FOmniCaptureCPUFace
+{
+    int32 Resolution = 0;
+    TArray<FFloat16Color> Pixels;
+
+    bool IsValid() const
+    {
+        return Resolution > 0 && Pixels.Num() == Resolution * Resolution;
+    }
+};
+
+// Six faces in the rig's capture order, linear radiance.
+struct FOmniCaptureCPUCubemap
+{
+    FOmniCaptureCPUFace Faces[6];
+
+    bool IsValid() const
+    {
+        for (int32 Index = 0; Index < 6; ++Index)
+        {
+            if (!Faces[Index].IsValid())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
 struct FOmniCaptureEquirectResult
 {
     TUniquePtr<FImagePixelData> PixelData;
@@ -20,6 +52,11 @@ struct FOmniCaptureEquirectResult
 class OMNICAPTURE_API FOmniCaptureEquirectConverter
 {
 public:
-    static FOmniCaptureEquirectResult ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
+    // EncoderPlaneTargets, when given, holds persistent encoder planes that are reused if they still match.
+    static FOmniCaptureEquirectResult ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TArray<TRefCountPtr<IPooledRenderTarget>>* EncoderPlaneTargets = nullptr);
+    static FOmniCaptureEquirectResult ConvertAccumulated(const FOmniCaptureSettings& Settings, const FOmniCaptureSubframeAccumulator& Accumulator, TArray<TRefCountPtr<IPooledRenderTarget>>* EncoderPlaneTargets = nullptr);
+
+    // CPU projection of faces supplied by the caller; needs neither a scene capture nor an RHI.
+    static FOmniCaptureEquirectResult ConvertCPUCubemaps(const FOmniCaptureSettings& Settings, const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap);
 };
 
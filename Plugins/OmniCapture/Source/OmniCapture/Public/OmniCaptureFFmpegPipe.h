@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+class OMNICAPTURE_API FOmniCaptureFFmpegPipe
+{
+public:
+    FOmniCaptureFFmpegPipe();
+    ~FOmniCaptureFFmpegPipe();
+
+    bool Open(const FString& Binary, const FString& Arguments, const FString& WorkingDirectory);
+    bool Write(const void* Data, int64 NumBytes);
+    int32 Close(double TimeoutSeconds = 60.0);
+
+    bool IsOpen() const { return ProcHandle.IsValid(); }
+    bool IsStalled(double ThresholdSeconds) const;
+    uint64 GetBytesWritten() const { return BytesWritten.Load(); }
+
+private:
+    FProcHandle ProcHandle;
+    void* StdinRead = nullptr;
+    void* StdinWrite = nullptr;
+    TAtomic<uint64> WriteStartCycles;
+    TAtomic<uint64> BytesWritten;
+    bool bBroken = false;
+};
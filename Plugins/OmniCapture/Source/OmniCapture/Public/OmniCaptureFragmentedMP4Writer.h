@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class FOmniCaptureBitstreamWriter;
+
+struct FOmniCaptureFMP4Config
+{
+    EOmniCaptureCodec Codec = EOmniCaptureCodec::HEVC;
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 BitDepth = 8;
+    double FrameRate = 30.0;
+    EOmniCaptureMode Mode = EOmniCaptureMode::Mono;
+    EOmniCaptureStereoLayout StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+    EOmniCaptureColorSpace ColorSpace = EOmniCaptureColorSpace::BT709;
+};
+
+// Writes Annex B access units as a fragmented MP4: ftyp/moov once the first parameter sets are
+// seen, then one moof/mdat pair per GOP, so every completed fragment is playable on its own.
+class OMNICAPTURE_API FOmniCaptureFragmentedMP4Writer
+{
+public:
+    static constexpr uint32 Timescale = 90000;
+
+    FOmniCaptureFragmentedMP4Writer();
+    ~FOmniCaptureFragmentedMP4Writer();
+
+    bool Open(const FString& InFilePath, const FOmniCaptureFMP4Config& InConfig);
+    void Close();
+
+    bool IsOpen() const { return Sink.IsValid(); }
+    bool WriteSample(const uint8* AnnexBData, int64 Size, double PresentationSeconds);
+
+    int64 GetSampleCount() const { return SamplesWritten; }
+    int32 GetFragmentCount() const { return FragmentSequence; }
+    int32 GetDroppedSampleCount() const { return DroppedSamples; }
+    FOmniCaptureBitstreamStats GetStats() const;
+
+private:
+    struct FPendingSample
+    {
+        int32 Offset = 0;
+        int32 Size = 0;
+        int64 PresentationTime = 0;
+        bool bKeyFrame = false;
+    };
+
+    void WriteInitSegment();
+    void FlushFragment(int64 NextDecodeTime);
+    void BuildSampleEntry(TArray<uint8>& Out) const;
+
+private:
+    TUniquePtr<FOmniCaptureBitstreamWriter> Sink;
+    FOmniCaptureFMP4Config Config;
+    FOmniCaptureBitstreamStats LastStats;
+
+    TArray<uint8> VPS;
+    TArray<uint8> SPS;
+    TArray<uint8> PPS;
+    bool bInitWritten = false;
+
+    TArray<uint8> FragmentData;
+    TArray<FPendingSample> FragmentSamples;
+    TArray<uint8> BoxScratch;
+    int64 LastSampleDuration = 0;
+
+    int32 FragmentSequence = 0;
+    int64 SamplesWritten = 0;
+    int32 DroppedSamples = 0;
+};
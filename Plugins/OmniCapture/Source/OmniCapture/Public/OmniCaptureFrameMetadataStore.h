@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class FArchive;
+
+struct FOmniCaptureFrameTimingStats
+{
+    int32 FrameCount = 0;
+    int32 KeyFrameCount = 0;
+    int32 MissingFrames = 0;
+    double FirstTimecode = 0.0;
+    double LastTimecode = 0.0;
+    double MeanIntervalSeconds = 0.0;
+    double IntervalM2 = 0.0;
+    double MaxIntervalSeconds = 0.0;
+    double MeanKeyFrameInterval = 0.0;
+
+    double GetFrameRate() const;
+    double GetJitterMilliseconds() const;
+};
+
+// Frames are added on the ring consumer thread while the game thread closes or resets the store
+// on rotation, so every entry point below serialises on StoreCS.
+class OMNICAPTURE_API FOmniCaptureFrameMetadataStore
+{
+public:
+    FOmniCaptureFrameMetadataStore();
+    ~FOmniCaptureFrameMetadataStore();
+
+    // Does not touch the previous spill file; call DiscardSpillFile once finalization has read it.
+    void Reset(const FString& InSpillFilePath = FString(), int32 InMaxResidentChunks = 16);
+    void Add(const FOmniCaptureFrameMetadata& Metadata);
+    void ForEachFrame(TFunctionRef<void(const FOmniCaptureFrameMetadata&)> Visitor) const;
+    void DiscardSpillFile();
+
+    int32 Num() const;
+    FOmniCaptureFrameTimingStats GetStats() const;
+
+    // Lock-free; the subsystem samples this every tick for stats.
+    int64 GetResidentBytes() const { return ResidentBytes.Load(); }
+
+    static constexpr int32 ChunkCapacity = 4096;
+
+private:
+    struct FChunk
+    {
+        int32 FirstFrameIndex = 0;
+        int64 FirstTimecodeUs = 0;
+        TArray<uint16> FrameIndexDeltas;
+        TArray<uint32> TimecodeDeltasUs;
+        TArray<uint8> KeyFrameBits;
+    };
+
+    void StartChunk(int32 FrameIndex, int64 TimecodeUs);
+    void SpillOldestChunk();
+    void CloseSpillFile();
+    void UpdateResidentBytes();
+    static void SerializeChunk(FArchive& Ar, FChunk& Chunk);
+    static void VisitChunk(const FChunk& Chunk, TFunctionRef<void(const FOmniCaptureFrameMetadata&)> Visitor);
+
+private:
+    mutable FCriticalSection StoreCS;
+    TArray<FChunk> ResidentChunks;
+    FOmniCaptureFrameTimingStats Stats;
+    int32 FirstKeyFrameIndex = INDEX_NONE;
+    TAtomic<int64> ResidentBytes { 0 };
+
+    FString SpillFilePath;
+    TUniquePtr<FArchive> SpillWriter;
+    int32 SpilledChunkCount = 0;
+    int32 MaxResidentChunks = 16;
+
+    int32 LastFrameIndex = INDEX_NONE;
+    int64 LastTimecodeUs = 0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureFFmpegPipe.h"
+
+class OMNICAPTURE_API FOmniCaptureLiveMuxer
+{
+public:
+    bool Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
+    bool PushFrame(const FOmniCaptureFrame& Frame);
+    bool Finalize();
+
+    bool IsStalled() const;
+    bool HasFailed() const { return bFailed.Load(); }
+    const FString& GetOutputFilePath() const { return OutputFilePath; }
+    int32 GetFramesWritten() const { return FramesWritten; }
+
+private:
+    bool OpenPipe(const FIntPoint& Size, bool bLinear);
+
+private:
+    FOmniCaptureSettings ActiveSettings;
+    FString OutputDirectory;
+    FString OutputFilePath;
+    FString Binary;
+    FOmniCaptureFFmpegPipe Pipe;
+    TArray<uint16> ConversionBuffer;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+    double StallThresholdSeconds = 0.1;
+    int32 FramesWritten = 0;
+    bool bLinearInput = false;
+    // Set on the ring consumer thread, read by the game thread.
+    TAtomic<bool> bFailed { false };
+};
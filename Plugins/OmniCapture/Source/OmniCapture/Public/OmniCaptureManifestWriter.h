@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureFrameMetadataStore.h"
+#include "OmniCaptureAudioTimeline.h"
+
+class FArchive;
+class FJsonObject;
+
+struct FOmniCaptureManifestSummary
+{
+    FString ManifestPath;
+    FOmniCaptureFrameTimingStats Timing;
+    int64 AudioOffsetSamples = 0;
+    int32 AudioSampleRate = 0;
+};
+
+class OMNICAPTURE_API FOmniCaptureManifestWriter
+{
+public:
+    ~FOmniCaptureManifestWriter();
+
+    bool Open(const FString& InManifestPath, const TSharedRef<FJsonObject>& Header);
+    void AppendFrame(const FOmniCaptureFrameMetadata& Metadata);
+    void AppendDrop(const FOmniCaptureDropEvent& Drop);
+    bool Close(const TSharedRef<FJsonObject>& Footer);
+
+    bool IsOpen() const { return Archive.IsValid(); }
+    const FString& GetManifestPath() const { return ManifestPath; }
+
+private:
+    void WriteLine(const FString& Line);
+    void WriteObjectLine(const TSharedRef<FJsonObject>& Object);
+
+private:
+    TUniquePtr<FArchive> Archive;
+    FString ManifestPath;
+    mutable FCriticalSection WriterCS;
+    int32 LinesSinceFlush = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "HAL/PlatformProcess.h"
+
+class FRunnableThread;
+class FOmniCaptureMuxScheduler;
+
+struct FOmniCaptureMuxJobDesc
+{
+    FString Binary;
+    FString Arguments;
+    FString WorkingDirectory;
+    FString OutputFile;
+    int32 SegmentIndex = 0;
+    int32 TotalFrames = 0;
+    double DurationSeconds = 0.0;
+    bool bOpenOnComplete = false;
+
+    bool IsValid() const { return !Binary.IsEmpty() && !OutputFile.IsEmpty(); }
+};
+
+class OMNICAPTURE_API FOmniCaptureMuxJobQueue
+{
+public:
+    typedef TFunction<void(const FOmniCaptureMuxJobStatus&)> FOnJobComplete;
+
+    FOmniCaptureMuxJobQueue();
+    ~FOmniCaptureMuxJobQueue();
+
+    void Initialize(int32 InCoreBudget, int32 InThreadsPerJob);
+    int32 Submit(FOmniCaptureMuxJobDesc&& Job, FOnJobComplete&& OnComplete);
+    void Cancel(int32 JobId);
+    void CancelAll();
+
+    bool HasPendingJobs() const;
+    TArray<FOmniCaptureMuxJobStatus> GetJobStatuses() const;
+    int32 GetMaxConcurrentJobs() const { return MaxConcurrentJobs; }
+    int32 GetThreadsPerJob() const { return ThreadsPerJob; }
+
+    static int32 ResolveCoreBudget(int32 RequestedBudget);
+
+private:
+    friend class FOmniCaptureMuxScheduler;
+
+    struct FJob
+    {
+        FOmniCaptureMuxJobDesc Desc;
+        FOmniCaptureMuxJobStatus Status;
+        FOnJobComplete OnComplete;
+        FProcHandle ProcHandle;
+        void* ReadPipe = nullptr;
+        void* WritePipe = nullptr;
+        FString PendingOutput;
+        double StartTime = 0.0;
+        bool bCancelRequested = false;
+    };
+
+    void StartWorker();
+    void StopWorker();
+    void Pump();
+    bool LaunchJob(FJob& Job);
+    void ReadJobOutput(FJob& Job);
+    void ParseProgressLine(FJob& Job, const FString& Line);
+    void ReleaseJobProcess(FJob& Job);
+    void PruneFinishedJobs();
+
+    TArray<TUniquePtr<FJob>> Jobs;
+    mutable FCriticalSection JobsCS;
+
+    TUniquePtr<FRunnableThread> WorkerThread;
+    FOmniCaptureMuxScheduler* Scheduler = nullptr;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool> bRunning;
+    int32 NextJobId = 1;
+    int32 MaxConcurrentJobs = 1;
+    int32 ThreadsPerJob = 4;
+};
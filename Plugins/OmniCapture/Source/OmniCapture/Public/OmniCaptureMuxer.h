@@ -2,30 +2,38 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureMuxJobQueue.h"
+#include "OmniCaptureManifestWriter.h"
 
 class OMNICAPTURE_API FOmniCaptureMuxer
 {
 public:
     void Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
-    bool FinalizeCapture(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath);
+    bool OpenManifest(const FOmniCaptureSettings& Settings);
+    FOmniCaptureManifestSummary CloseManifest(const FOmniCaptureSettings& Settings, const FString& AudioPath, const FOmniCaptureAudioTimelineSummary& AudioTimeline, const FString& VideoPath);
+    bool FinalizeCapture(const FOmniCaptureSettings& Settings, const FOmniCaptureManifestSummary& Summary, const FString& AudioPath, const FString& VideoPath, FOmniCaptureMuxJobDesc& OutJob);
     void BeginRealtimeSession(const FOmniCaptureSettings& Settings);
     void EndRealtimeSession();
     void PushFrame(const FOmniCaptureFrame& Frame);
+    void RecordDrop(const FOmniCaptureDropEvent& Drop);
     FOmniAudioSyncStats GetAudioStats() const { return AudioStats; }
+    int64 GetFrameMetadataBytes() const { return FrameStore.GetResidentBytes(); }
     static FString ResolveFFmpegBinary(const FOmniCaptureSettings& Settings);
     static bool IsFFmpegAvailable(const FOmniCaptureSettings& Settings, FString* OutResolvedPath = nullptr);
 
 private:
-    bool WriteManifest(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, FString& OutManifestPath) const;
-    bool TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath) const;
+    bool BuildFFmpegJob(const FOmniCaptureSettings& Settings, const FOmniCaptureManifestSummary& Summary, const FString& AudioPath, const FString& VideoPath, FOmniCaptureMuxJobDesc& OutJob) const;
     FString BuildFFmpegBinaryPath() const;
-    double CalculateFrameRate(const TArray<FOmniCaptureFrameMetadata>& Frames) const;
 
 private:
     FString OutputDirectory;
     FString BaseFileName;
     mutable FString CachedFFmpegPath;
     FOmniAudioSyncStats AudioStats;
+    FOmniCaptureManifestWriter ManifestWriter;
+    FOmniCaptureFrameMetadataStore FrameStore;
+    int32 DropsByCause[static_cast<int32>(EOmniCaptureDropCause::Count)] = {};
+    int32 DropsByBottleneck[3] = {};
     double LastVideoTimestamp = 0.0;
     double LastAudioTimestamp = 0.0;
     double DriftWarningThresholdMs = 25.0;
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureVideoEncoder.h"
+#include "Templates/Atomic.h"
 
 #if WITH_OMNI_NVENC
 #include "AVEncoder.h"
@@ -14,6 +16,20 @@ namespace AVEncoder
 }
 #endif
 
+class FRunnableThread;
+class FOmniCaptureBitstreamWriter;
+class FOmniCaptureFragmentedMP4Writer;
+
+// One reusable encoder input. The pool keeps a reference, so a slot is free again once no
+// frame or in-flight encode holds it.
+struct FOmniNVENCInputSlot : public FOmniCaptureEncoderSlot
+{
+#if WITH_OMNI_NVENC
+    TSharedPtr<AVEncoder::FVideoEncoderInputFrame> InputFrame;
+    FTexture2DRHIRef BoundTexture;
+#endif
+};
+
 struct FOmniNVENCCapabilities
 {
     bool bHardwareAvailable = false;
@@ -25,21 +41,39 @@ struct FOmniNVENCCapabilities
     FString DriverVersion;
 };
 
-class OMNICAPTURE_API FOmniCaptureNVENCEncoder
+class OMNICAPTURE_API FOmniCaptureNVENCEncoder final : public IOmniVideoEncoder
 {
 public:
     FOmniCaptureNVENCEncoder();
-    ~FOmniCaptureNVENCEncoder();
+    virtual ~FOmniCaptureNVENCEncoder() override;
 
-    void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory);
-    void EnqueueFrame(const FOmniCaptureFrame& Frame);
-    void Finalize();
+    virtual void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory) override;
+    virtual void EnqueueFrame(const FOmniCaptureFrame& Frame) override;
+    virtual void Finalize() override;
+    virtual TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> AcquireInputSlot() override;
+    void SubmitReadyFrames();
     static bool IsNVENCAvailable();
     static FOmniNVENCCapabilities QueryCapabilities();
     static bool SupportsColorFormat(EOmniCaptureColorFormat Format);
 
-    bool IsInitialized() const { return bInitialized; }
-    FString GetOutputFilePath() const { return OutputFilePath; }
+    virtual bool IsInitialized() const override { return bInitialized; }
+    virtual FString GetOutputFilePath() const override { return OutputFilePath; }
+    virtual FOmniCaptureBitstreamStats GetBitstreamStats() const override;
+    virtual FOmniCaptureEncoderLatencyStats GetLatencyStats() const override;
+    virtual bool UsesGPUFrames() const override { return true; }
+
+private:
+    struct FPendingFrame
+    {
+        FOmniCaptureFrameMetadata Metadata;
+        FGPUFenceRHIRef ReadyFence;
+        FTexture2DRHIRef Texture;
+        TArray<FTexture2DRHIRef> EncoderTextures;
+        TSharedPtr<FOmniNVENCInputSlot, ESPMode::ThreadSafe> Slot;
+    };
+
+    void SubmitFrame(FPendingFrame& Pending);
+    void StopSubmitWorker();
 
 private:
     FString OutputFilePath;
@@ -47,15 +81,31 @@ private:
     EOmniCaptureColorFormat ColorFormat = EOmniCaptureColorFormat::NV12;
     bool bZeroCopyRequested = true;
     EOmniCaptureCodec RequestedCodec = EOmniCaptureCodec::HEVC;
+    FOmniCaptureBitstreamStats LastBitstreamStats;
+    FOmniCaptureEncoderLatencyStats LatencyStats;
 
 #if WITH_OMNI_NVENC
     TSharedPtr<AVEncoder::FVideoEncoder> VideoEncoder;
     TSharedPtr<AVEncoder::FVideoEncoderInput> EncoderInput;
     AVEncoder::FVideoEncoder::FLayerConfig LayerConfig;
     AVEncoder::FVideoEncoder::FCodecConfig CodecConfig;
-    FCriticalSection EncoderCS;
+    mutable FCriticalSection EncoderCS;
     TArray<uint8> AnnexBBuffer;
-    TUniquePtr<IFileHandle> BitstreamFile;
+    TArray<uint8> FramePackingSEI;
+    TUniquePtr<FOmniCaptureBitstreamWriter> BitstreamWriter;
+    TUniquePtr<FOmniCaptureFragmentedMP4Writer> FragmentedWriter;
+
+    TArray<TSharedPtr<FOmniNVENCInputSlot, ESPMode::ThreadSafe>> InputSlots;
+    TArray<TSharedPtr<FOmniNVENCInputSlot, ESPMode::ThreadSafe>> InFlightSlots;
+    TMap<int64, double> SubmitTimes;
+    int32 ReorderDepth = 0;
+
+    FCriticalSection PendingCS;
+    TArray<FPendingFrame> PendingFrames;
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* SubmitThread = nullptr;
+    class FOmniNVENCSubmitWorker* SubmitWorker = nullptr;
+    TAtomic<bool> bSubmitRunning { false };
 #endif
 };
 
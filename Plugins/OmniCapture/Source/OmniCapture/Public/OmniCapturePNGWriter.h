@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "Templates/Atomic.h"
 
 class IImageWriteQueue;
 class FImageWriteTask;
@@ -15,15 +16,18 @@ public:
     void Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
     void EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame, const FString& FrameFileName);
     void Flush();
-    const TArray<FOmniCaptureFrameMetadata>& GetCapturedFrames() const { return CapturedMetadata; }
-    TArray<FOmniCaptureFrameMetadata> ConsumeCapturedFrames();
+
+    int32 GetPendingWrites() const { return PendingWrites.Load(); }
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
+    int32 GetFramesWritten() const { return FramesWritten.Load(); }
 
 private:
     IImageWriteQueue* ImageWriteQueue = nullptr;
     FString OutputDirectory;
     FString SequenceBaseName;
 
-    TArray<FOmniCaptureFrameMetadata> CapturedMetadata;
-    FCriticalSection MetadataCS;
+    TAtomic<int32> PendingWrites { 0 };
+    TAtomic<int64> BytesWritten { 0 };
+    TAtomic<int32> FramesWritten { 0 };
 };
 
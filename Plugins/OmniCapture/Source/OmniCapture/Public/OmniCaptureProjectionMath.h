@@ -0,0 +1,152 @@
+#pragma once
+
+// Equirect <-> cubemap projection math shared by the CPU converter. Deliberately free of engine
+// types and headers so it can be compiled, fuzzed and benchmarked outside Unreal; the converter
+// adapts FVector/FVector2D at the call sites. In-engine coverage is the OmniCapture.Projection.Core
+// automation test.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace OmniCaptureProjection
+{
+    constexpr double Pi = 3.14159265358979323846;
+
+    struct FDirection
+    {
+        double X = 0.0;
+        double Y = 0.0;
+        double Z = 0.0;
+    };
+
+    // Face order matches the rig: +X, -X, +Y, -Y, +Z, -Z. UV is in [0, 1] across the face.
+    struct FFaceUV
+    {
+        uint32_t Face = 0;
+        double U = 0.0;
+        double V = 0.0;
+    };
+
+    inline bool Normalize(FDirection& Direction)
+    {
+        const double LengthSquared = Direction.X * Direction.X + Direction.Y * Direction.Y + Direction.Z * Direction.Z;
+        if (LengthSquared <= 1e-16)
+        {
+            return false;
+        }
+
+        const double InvLength = 1.0 / std::sqrt(LengthSquared);
+        Direction.X *= InvLength;
+        Direction.Y *= InvLength;
+        Direction.Z *= InvLength;
+        return true;
+    }
+
+    // Direction through the centre of an equirect pixel. Y is up; longitude 0 looks down +X.
+    inline FDirection DirectionFromEquirectPixel(int32_t PixelX, int32_t PixelY, int32_t Width, int32_t Height, double& OutLatitude)
+    {
+        const double U = (static_cast<double>(PixelX) + 0.5) / Width;
+        const double V = (static_cast<double>(PixelY) + 0.5) / Height;
+        const double Longitude = (U * 2.0 - 1.0) * Pi;
+        OutLatitude = (0.5 - V) * Pi;
+
+        const double CosLat = std::cos(OutLatitude);
+        FDirection Direction;
+        Direction.X = CosLat * std::cos(Longitude);
+        Direction.Y = std::sin(OutLatitude);
+        Direction.Z = CosLat * std::sin(Longitude);
+        Normalize(Direction);
+        return Direction;
+    }
+
+    // Bends directions near the poles toward the pole itself, hiding the pinch where a whole
+    // equirect row samples a handful of cubemap texels.
+    inline void ApplyPolarMitigation(double Strength, double Latitude, FDirection& Direction)
+    {
+        if (Strength <= 0.0)
+        {
+            return;
+        }
+
+        double PoleFactor = std::clamp(std::abs(Latitude) / (Pi * 0.5), 0.0, 1.0);
+        PoleFactor = PoleFactor * PoleFactor * PoleFactor * PoleFactor;
+        const double Blend = PoleFactor * Strength;
+        if (Blend <= 0.0)
+        {
+            return;
+        }
+
+        const double PoleY = Latitude >= 0.0 ? 1.0 : -1.0;
+        Direction.X = Direction.X * (1.0 - Blend);
+        Direction.Y = Direction.Y + (PoleY - Direction.Y) * Blend;
+        Direction.Z = Direction.Z * (1.0 - Blend);
+        Normalize(Direction);
+    }
+
+    // SeamStrength pulls UVs half a texel inward so nearest sampling never straddles a face edge.
+    inline FFaceUV DirectionToFaceUV(const FDirection& Direction, int32_t FaceResolution, double SeamStrength)
+    {
+        const double AbsX = std::abs(Direction.X);
+        const double AbsY = std::abs(Direction.Y);
+        const double AbsZ = std::abs(Direction.Z);
+
+        FFaceUV Result;
+        double U = 0.0;
+        double V = 0.0;
+        if (AbsX >= AbsY && AbsX >= AbsZ)
+        {
+            Result.Face = Direction.X > 0.0 ? 0 : 1;
+            U = (Direction.X > 0.0 ? -Direction.Z : Direction.Z) / AbsX;
+            V = Direction.Y / AbsX;
+        }
+        else if (AbsY >= AbsX && AbsY >= AbsZ)
+        {
+            Result.Face = Direction.Y > 0.0 ? 2 : 3;
+            U = Direction.X / AbsY;
+            V = (Direction.Y > 0.0 ? -Direction.Z : Direction.Z) / AbsY;
+        }
+        else
+        {
+            Result.Face = Direction.Z > 0.0 ? 4 : 5;
+            U = (Direction.Z > 0.0 ? Direction.X : -Direction.X) / AbsZ;
+            V = Direction.Y / AbsZ;
+        }
+
+        const double Resolution = static_cast<double>(std::max(1, FaceResolution));
+        const double Scale = 1.0 + (((Resolution - 1.0) / Resolution) - 1.0) * SeamStrength;
+        const double Bias = (0.5 / Resolution) * SeamStrength;
+        Result.U = std::clamp(((U + 1.0) * 0.5) * Scale + Bias, 0.0, 1.0);
+        Result.V = std::clamp(((V + 1.0) * 0.5) * Scale + Bias, 0.0, 1.0);
+        return Result;
+    }
+
+    // Inverse of DirectionToFaceUV with no seam bias.
+    inline FDirection FaceUVToDirection(const FFaceUV& FaceUV)
+    {
+        const double U = FaceUV.U * 2.0 - 1.0;
+        const double V = FaceUV.V * 2.0 - 1.0;
+
+        FDirection Direction;
+        switch (FaceUV.Face)
+        {
+        case 0: Direction = { 1.0, V, -U }; break;
+        case 1: Direction = { -1.0, V, U }; break;
+        case 2: Direction = { U, 1.0, -V }; break;
+        case 3: Direction = { U, -1.0, V }; break;
+        case 4: Direction = { U, V, 1.0 }; break;
+        default: Direction = { -U, V, -1.0 }; break;
+        }
+        Normalize(Direction);
+        return Direction;
+    }
+
+    // Nearest texel for a face UV, matching the converter's truncating lookup.
+    inline int32_t FaceTexelIndex(const FFaceUV& FaceUV, int32_t FaceResolution)
+    {
+        const int32_t MaxCoord = std::max(0, FaceResolution - 1);
+        const int32_t TexelX = std::clamp(static_cast<int32_t>(FaceUV.U * MaxCoord), 0, MaxCoord);
+        const int32_t TexelY = std::clamp(static_cast<int32_t>(FaceUV.V * MaxCoord), 0, MaxCoord);
+        return TexelY * FaceResolution + TexelX;
+    }
+}
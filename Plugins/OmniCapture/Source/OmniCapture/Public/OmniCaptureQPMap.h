@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+// Per-block QP deltas for one encoded picture, row-major. Positive values spend fewer bits.
+struct OMNICAPTURE_API FOmniCaptureQPMap
+{
+    int32 BlockSize = 16;
+    int32 BlocksX = 0;
+    int32 BlocksY = 0;
+    TArray<int8> Deltas;
+
+    int8 Get(int32 BlockX, int32 BlockY) const { return Deltas[BlockY * BlocksX + BlockX]; }
+};
+
+// Builds the QP delta map for an equirect (or a column of one) from the projection's
+// solid-angle weight.
+class OMNICAPTURE_API FOmniCaptureQPMapGenerator
+{
+public:
+    void Configure(const FOmniCaptureSettings& Settings, const FIntRect& InRegion, int32 InBlockSize = 16);
+
+    const FOmniCaptureQPMap& GetLatitudeMap() const { return LatitudeMap; }
+
+    // addroi chain carrying the latitude map's row profile, relative to frame height.
+    FString BuildROIFilter() const;
+
+private:
+    FIntRect Region;
+    int32 BitDepth = 8;
+
+    FOmniCaptureQPMap LatitudeMap;
+};
@@ -36,6 +36,7 @@ public:
 
     void Configure(const FOmniCaptureSettings& InSettings);
     void Capture(FOmniEyeCapture& OutLeftEye, FOmniEyeCapture& OutRightEye) const;
+    void SetSubpixelJitter(const FVector2D& JitterPixels);
 
     FORCEINLINE const FTransform& GetRigTransform() const { return RigRoot->GetComponentTransform(); }
 
@@ -13,7 +13,10 @@ public:
     ~FOmniCaptureRingBuffer();
 
     void Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer);
-    void Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame);
+    void SetBackpressureProbe(TFunction<bool()>&& InProbe);
+    // Returns the index of the frame evicted to make room, or INDEX_NONE when nothing was dropped.
+    int32 Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame);
+    // Drains the queue on the caller thread and returns once the worker is idle.
     void Flush();
     FOmniCaptureRingBufferStats GetStats() const;
 
@@ -23,6 +26,7 @@ private:
 
     TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc> Queue;
     TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)> Consumer;
+    TFunction<bool()> BackpressureProbe;
 
     TUniquePtr<FRunnableThread> WorkerThread;
     FOmniCaptureRingBufferWorker* Worker = nullptr;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureVideoEncoder.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "Templates/Atomic.h"
+
+class FEvent;
+class FRunnableThread;
+
+// CPU x264/x265 backend. Readback frames are packed in parallel on the task graph, then a
+// writer thread streams them into an FFmpeg process producing an elementary stream.
+class OMNICAPTURE_API FOmniCaptureSoftwareEncoder final : public IOmniVideoEncoder
+{
+public:
+    FOmniCaptureSoftwareEncoder();
+    virtual ~FOmniCaptureSoftwareEncoder() override;
+
+    virtual void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory) override;
+    virtual void EnqueueFrame(const FOmniCaptureFrame& Frame) override;
+    virtual void Finalize() override;
+
+    virtual bool IsInitialized() const override { return bInitialized; }
+    virtual FString GetOutputFilePath() const override { return OutputFilePath; }
+    virtual FOmniCaptureEncoderLatencyStats GetLatencyStats() const override;
+    virtual bool IsStalled() const override;
+
+    static bool IsAvailable(const FOmniCaptureSettings& Settings);
+
+    // FFmpeg x264/x265 arguments for the configured rate-control mode and lookahead.
+    static FString BuildRateControlArguments(const FOmniCaptureSettings& Settings);
+
+    // Chain of addroi filters raising QP toward the poles, or empty when latitude AQ is off or
+    // the mode is constant-QP (x264/x265 skip AQ there). Offsets are relative to frame height.
+    static FString BuildLatitudeROIFilter(const FOmniCaptureSettings& Settings);
+
+    void DrainQueue();
+
+private:
+    struct FQueuedFrame
+    {
+        TArray<uint8> Data;
+        double EnqueueTime = 0.0;
+    };
+
+    bool OpenPipe(const FIntPoint& Size, bool bLinear);
+    void StopWorker();
+
+private:
+    FOmniCaptureSettings ActiveSettings;
+    FString OutputDirectory;
+    FString OutputFilePath;
+    FString Binary;
+    bool bInitialized = false;
+    bool bFailed = false;
+
+    FOmniCaptureFFmpegPipe Pipe;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+    bool bLinearInput = false;
+    int32 QueueDepth = 3;
+    double StallThresholdSeconds = 0.1;
+
+    mutable FCriticalSection QueueCS;
+    TArray<FQueuedFrame> PendingFrames;
+    TArray<TArray<uint8>> FreeBuffers;
+    FOmniCaptureEncoderLatencyStats LatencyStats;
+
+    FEvent* WakeEvent = nullptr;
+    FEvent* SpaceEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    class FOmniSoftwareEncoderWorker* Worker = nullptr;
+    TAtomic<bool> bRunning;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// Rolling per-stage timings for the capture pipeline. Stages record from whichever thread runs
+// them (game, render, ring consumer, encoder callbacks); percentiles cover the last WindowSize
+// samples of each stage.
+class OMNICAPTURE_API FOmniCaptureStageTimings
+{
+public:
+    static constexpr int32 WindowSize = 512;
+
+    static FOmniCaptureStageTimings& Get();
+    static const TCHAR* GetStageName(EOmniCaptureStage Stage);
+
+    void Record(EOmniCaptureStage Stage, double Milliseconds);
+    double GetLastMs(EOmniCaptureStage Stage) const;
+    void Reset();
+
+    // Only stages that have recorded at least one sample.
+    TArray<FOmniCaptureStageTiming> GetSnapshot() const;
+
+private:
+    struct FStageWindow
+    {
+        double Samples[WindowSize];
+        int32 Count = 0;
+        int32 Next = 0;
+        int64 Total = 0;
+        double LastMs = 0.0;
+        double MaxMs = 0.0;
+    };
+
+    mutable FCriticalSection CS;
+    FStageWindow Windows[static_cast<int32>(EOmniCaptureStage::Count)];
+};
+
+class FOmniCaptureStageScope
+{
+public:
+    explicit FOmniCaptureStageScope(EOmniCaptureStage InStage)
+        : Stage(InStage)
+        , StartCycles(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FOmniCaptureStageScope()
+    {
+        FOmniCaptureStageTimings::Get().Record(Stage, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    }
+
+private:
+    EOmniCaptureStage Stage;
+    uint64 StartCycles;
+};
+
+// Times the enclosing scope into the stage histogram and names it for Unreal Insights.
+#define OMNICAPTURE_STAGE_SCOPE(StageName) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(OmniCapture_##StageName); \
+    FOmniCaptureStageScope PREPROCESSOR_JOIN(OmniCaptureStageScope_, __LINE__)(EOmniCaptureStage::StageName)
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureRigActor.h"
+#include "RendererInterface.h"
+
+class OMNICAPTURE_API FOmniCaptureSubframeAccumulator
+{
+public:
+    ~FOmniCaptureSubframeAccumulator();
+
+    void Begin(const FOmniCaptureSettings& Settings);
+    bool Accumulate(const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
+    void Release();
+
+    bool IsComplete() const { return NumSamples > 0 && SamplesAccumulated >= NumSamples; }
+    int32 GetSampleIndex() const { return SamplesAccumulated; }
+    int32 GetNumSamples() const { return NumSamples; }
+    int32 GetFaceResolution() const { return FaceResolution; }
+    bool IsStereo() const { return bStereo; }
+    bool UsesGPU() const { return bUseGPU; }
+
+    // Render thread only once Accumulate has been enqueued. Without compute support the faces
+    // are summed by raster passes and read back into the CPU faces on the last sample.
+    const TRefCountPtr<IPooledRenderTarget>& GetFaceArray(EOmniCaptureEye Eye) const { return GPUFaceArrays[Eye == EOmniCaptureEye::Right ? 1 : 0]; }
+    const TArray<FLinearColor>& GetCPUFace(EOmniCaptureEye Eye, int32 FaceIndex) const { return CPUFaces[Eye == EOmniCaptureEye::Right ? 1 : 0][FaceIndex]; }
+
+    static FVector2D GetJitterOffset(int32 SampleIndex);
+    static double GetDeltaAfterSample(const FOmniCaptureSettings& Settings, int32 SampleIndex);
+
+private:
+    int32 NumSamples = 0;
+    int32 SamplesAccumulated = 0;
+    int32 FaceResolution = 0;
+    bool bStereo = false;
+    bool bUseGPU = false;
+
+    TRefCountPtr<IPooledRenderTarget> GPUFaceArrays[2];
+    TArray<FLinearColor> CPUFaces[2][6];
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureManifestWriter.h"
+#include "OmniCaptureTelemetry.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "OmniCaptureSubsystem.generated.h"
 
@@ -9,8 +11,11 @@ class AOmniCaptureDirectorActor;
 class FOmniCaptureRingBuffer;
 class FOmniCapturePNGWriter;
 class FOmniCaptureAudioRecorder;
-class FOmniCaptureNVENCEncoder;
+class IOmniVideoEncoder;
 class FOmniCaptureMuxer;
+class FOmniCaptureMuxJobQueue;
+class FOmniCaptureLiveMuxer;
+class FOmniCaptureSubframeAccumulator;
 class AOmniCapturePreviewActor;
 
 struct FOmniCaptureSegmentRecord
@@ -20,7 +25,7 @@ struct FOmniCaptureSegmentRecord
     FString BaseFileName;
     FString AudioPath;
     FString VideoPath;
-    TArray<FOmniCaptureFrameMetadata> Frames;
+    FOmniCaptureManifestSummary Manifest;
 };
 
 UCLASS()
@@ -71,6 +76,19 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FOmniAudioSyncStats GetAudioSyncStats() const;
 
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureBitstreamStats GetBitstreamStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureEncoderLatencyStats GetEncoderLatencyStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    TArray<FOmniCaptureStageTiming> GetStageTimings() const;
+
+    // Latest published snapshot; safe to call from any thread.
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureTelemetry GetTelemetry() const { return Telemetry.Read(); }
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     const FOmniCaptureSettings& GetActiveSettings() const { return ActiveSettings; }
 
@@ -86,6 +104,15 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FString GetLastStillImagePath() const { return LastStillImagePath; }
 
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    TArray<FOmniCaptureMuxJobStatus> GetMuxJobStatuses() const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    bool HasPendingMuxJobs() const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    void CancelMuxJobs();
+
 private:
     void CreateRig();
     void DestroyRig();
@@ -98,6 +125,7 @@ private:
     void InitializeOutputWriters();
     void ShutdownOutputWriters(bool bFinalizeOutputs);
     void FinalizeOutputs(bool bFinalizeOutputs);
+    void HandleMuxJobComplete(const FOmniCaptureMuxJobStatus& JobStatus, bool bOpenOnComplete);
 
     bool ValidateEnvironment();
     bool ApplyFallbacks();
@@ -105,11 +133,19 @@ private:
     void InitializeAudioRecording();
     void ShutdownAudioRecording();
 
+    void BeginFixedTimestep();
+    void EndFixedTimestep();
+
     void TickCapture(float DeltaTime);
     void CaptureFrame();
     void FlushRingBuffer();
 
-    void HandleDroppedFrame();
+    // FrameIndex defaults to the frame being captured; ring evictions pass the evicted frame.
+    void HandleDroppedFrame(EOmniCaptureDropCause Cause, int32 FrameIndex = INDEX_NONE, bool bWriterStalled = false);
+
+    void PublishTelemetry(bool bForceStream);
+    void OpenTelemetryStream();
+    int64 GetActiveOutputBytes() const;
 
     void ConfigureActiveSegment();
     void RotateSegmentIfNeeded();
@@ -134,9 +170,16 @@ private:
     bool bDroppedFrames = false;
 
     int32 DroppedFrameCount = 0;
+    int32 DropsByCause[static_cast<int32>(EOmniCaptureDropCause::Count)] = {};
+    int32 DropsByBottleneck[3] = {};
+    TArray<FOmniCaptureDropEvent> RecentDrops;
+    int32 LastWriterStalls = 0;
 
     int32 FrameCounter = 0;
     double CaptureStartTime = 0.0;
+    // Wall-clock time spent paused; excluded from both the video timecodes and the audio clock.
+    double TotalPausedSeconds = 0.0;
+    double PauseStartTime = 0.0;
     double LastPreviewUpdateTime = 0.0;
     double PreviewFrameInterval = 0.0;
     double CurrentCaptureFPS = 0.0;
@@ -147,6 +190,10 @@ private:
     double CurrentSegmentStartTime = 0.0;
     int32 CurrentSegmentIndex = 0;
 
+    bool bFixedTimestepActive = false;
+    bool bSavedUseFixedTimeStep = false;
+    double SavedFixedDeltaTime = 0.0;
+
     TWeakObjectPtr<AOmniCaptureRigActor> RigActor;
     TWeakObjectPtr<AOmniCaptureDirectorActor> TickActor;
     TWeakObjectPtr<AOmniCapturePreviewActor> PreviewActor;
@@ -154,12 +201,16 @@ private:
     TUniquePtr<FOmniCaptureRingBuffer> RingBuffer;
     TUniquePtr<FOmniCapturePNGWriter> PNGWriter;
     TUniquePtr<FOmniCaptureAudioRecorder> AudioRecorder;
-    TUniquePtr<FOmniCaptureNVENCEncoder> NVENCEncoder;
+    TUniquePtr<IOmniVideoEncoder> VideoEncoder;
+    TUniquePtr<FOmniCaptureLiveMuxer> LiveMuxer;
     TUniquePtr<FOmniCaptureMuxer> OutputMuxer;
+    TUniquePtr<FOmniCaptureMuxJobQueue> MuxJobQueue;
+    TUniquePtr<FOmniCaptureSubframeAccumulator> SubframeAccumulator;
 
-    TArray<FOmniCaptureFrameMetadata> CapturedFrameMetadata;
+    int32 ActiveSegmentFrameCount = 0;
     TArray<FOmniCaptureSegmentRecord> CompletedSegments;
     FString RecordedAudioPath;
+    FOmniCaptureAudioTimelineSummary RecordedAudioTimeline;
     FString RecordedVideoPath;
     FString LastFinalizedOutput;
     FString LastStillImagePath;
@@ -170,6 +221,12 @@ private:
     FOmniCaptureRingBufferStats LatestRingBufferStats;
     FOmniAudioSyncStats AudioStats;
 
+    FOmniCaptureTelemetryChannel Telemetry;
+    TUniquePtr<FOmniCaptureTelemetryStreamer> TelemetryStreamer;
+    double LastTelemetryPublishTime = 0.0;
+    double LastTelemetryStreamTime = 0.0;
+    int64 CompletedOutputBytes = 0;
+
     EOmniCaptureState State = EOmniCaptureState::Idle;
 };
 
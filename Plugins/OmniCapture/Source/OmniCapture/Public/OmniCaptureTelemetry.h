@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Atomic.h"
+
+class FArchive;
+
+// Single-writer snapshot of the capture's structured stats. The game thread publishes into the
+// buffer nobody is reading and flips the published index; readers on any thread never take a
+// lock and retry only if a publish lands while they are pinning a buffer.
+class OMNICAPTURE_API FOmniCaptureTelemetryChannel
+{
+public:
+    void Publish(const FOmniCaptureTelemetry& Snapshot);
+    FOmniCaptureTelemetry Read() const;
+    void Reset();
+
+private:
+    FOmniCaptureTelemetry Buffers[2];
+    TAtomic<int32> PublishedIndex { 0 };
+    mutable TAtomic<int32> Readers[2] = { 0, 0 };
+};
+
+// Appends telemetry snapshots to a CSV or JSON-lines file for offline analysis of long runs.
+class OMNICAPTURE_API FOmniCaptureTelemetryStreamer
+{
+public:
+    ~FOmniCaptureTelemetryStreamer();
+
+    bool Open(const FString& InFilePath, EOmniCaptureTelemetryFormat InFormat);
+    void Write(const FOmniCaptureTelemetry& Snapshot);
+    void Close();
+
+    bool IsOpen() const { return Archive.IsValid(); }
+    const FString& GetFilePath() const { return FilePath; }
+
+    static FString GetFileExtension(EOmniCaptureTelemetryFormat Format);
+
+private:
+    void WriteLine(const FString& Line);
+
+private:
+    TUniquePtr<FArchive> Archive;
+    FString FilePath;
+    EOmniCaptureTelemetryFormat Format = EOmniCaptureTelemetryFormat::None;
+    // First drop sequence not yet written, so each JSON line carries only new drop events.
+    int32 NextDropSequence = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureVideoEncoder.h"
+
+// Splits an equirect wider than MaxEncodeWidth into vertical columns, each encoded by its own
+// backend session in parallel. GetOutputFilePath returns a JSON tile manifest that the muxer
+// stitches back into a single video.
+class OMNICAPTURE_API FOmniCaptureTiledEncoder final : public IOmniVideoEncoder
+{
+public:
+    virtual ~FOmniCaptureTiledEncoder() override;
+
+    virtual void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory) override;
+    virtual void EnqueueFrame(const FOmniCaptureFrame& Frame) override;
+    virtual void Finalize() override;
+
+    virtual bool IsInitialized() const override { return bInitialized; }
+    virtual FString GetOutputFilePath() const override { return ManifestPath; }
+    virtual FOmniCaptureEncoderLatencyStats GetLatencyStats() const override;
+    virtual FOmniCaptureBitstreamStats GetBitstreamStats() const override;
+    virtual bool IsStalled() const override;
+    virtual bool UsesGPUFrames() const override;
+
+    static TArray<FIntRect> ComputeTiles(const FIntPoint& FrameSize, int32 MaxTileWidth);
+
+private:
+    struct FTile
+    {
+        FIntRect Region;
+        TUniquePtr<IOmniVideoEncoder> Encoder;
+
+        // Used when the tile backend has no input slot free; a slot is reusable once only the
+        // pool references it.
+        TArray<TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe>> FallbackSlots;
+    };
+
+    void WriteManifest(int64 FrameCount) const;
+    static TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> AcquireTileSlot(FTile& Tile);
+    static bool CropOnGPU(const FOmniCaptureFrame& Source, FTile& Tile, FOmniCaptureFrame& OutFrame);
+    static bool CropOnCPU(const FOmniCaptureFrame& Source, const FIntRect& Region, FOmniCaptureFrame& OutFrame);
+
+private:
+    FOmniCaptureSettings ActiveSettings;
+    FString ManifestPath;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+    TArray<FTile> Tiles;
+    int64 FramesSubmitted = 0;
+    bool bInitialized = false;
+};
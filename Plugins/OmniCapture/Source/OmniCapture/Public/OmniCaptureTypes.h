@@ -23,7 +23,8 @@ UENUM(BlueprintType)
 enum class EOmniOutputFormat : uint8
 {
     PNGSequence,
-    NVENCHardware
+    NVENCHardware,
+    SoftwareEncoder
 };
 
 UENUM(BlueprintType)
@@ -61,7 +62,32 @@ enum class EOmniCaptureRateControlMode : uint8
 {
     ConstantBitrate,
     VariableBitrate,
-    Lossless
+    Lossless,
+    ConstantQP
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureAudioFormat : uint8
+{
+    PCM16,
+    PCM24,
+    Float32
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureAmbisonicOrder : uint8
+{
+    None,
+    FirstOrder,
+    ThirdOrder
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureAudioCodec : uint8
+{
+    WAV,
+    AAC,
+    Opus
 };
 
 UENUM(BlueprintType)
@@ -81,6 +107,60 @@ enum class EOmniCaptureRingBufferPolicy : uint8
     BlockProducer
 };
 
+UENUM(BlueprintType)
+enum class EOmniCaptureStage : uint8
+{
+    Capture,
+    Convert,
+    GPUEquirect,
+    GPUYUV,
+    GPUBGRA,
+    Readback,
+    RingConsumer,
+    PNGWrite,
+    VideoEncode,
+    Count UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureDropCause : uint8
+{
+    MissingRig,
+    AccumulationFailed,
+    ConversionFailed,
+    GPUTextureMissing,
+    RingBufferEviction,
+    Count UMETA(Hidden)
+};
+
+// Which part of the pipeline a drop points at: scene capture and conversion, the video encoder,
+// or storage (PNG writes and bitstream writer stalls).
+UENUM(BlueprintType)
+enum class EOmniCaptureBottleneck : uint8
+{
+    Render,
+    Encoder,
+    Disk
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureTelemetryFormat : uint8
+{
+    None,
+    CSV,
+    JSONLines
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureMuxJobState : uint8
+{
+    Queued,
+    Running,
+    Succeeded,
+    Failed,
+    Cancelled
+};
+
 USTRUCT(BlueprintType)
 struct FOmniCaptureQuality
 {
@@ -103,6 +183,18 @@ struct FOmniCaptureQuality
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
     EOmniCaptureRateControlMode RateControlMode = EOmniCaptureRateControlMode::ConstantBitrate;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video", meta = (ClampMin = 0, UIMin = 0, ClampMax = 51, UIMax = 51))
+    int32 ConstantQP = 23;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video", meta = (ClampMin = 0, UIMin = 0, ClampMax = 250, UIMax = 60))
+    int32 LookaheadFrames = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+    bool bLatitudeAdaptiveQuantization = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video", meta = (ClampMin = 0, UIMin = 0, ClampMax = 24, UIMax = 12))
+    int32 MaxPolarQPOffset = 8;
 };
 
 USTRUCT(BlueprintType)
@@ -116,6 +208,9 @@ struct FOmniCaptureSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     EOmniCaptureStereoLayout StereoLayout = EOmniCaptureStereoLayout::TopBottom;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    bool bSignalStereoFramePacking = true;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 1024, UIMin = 1024))
     int32 Resolution = 4096;
 
@@ -134,12 +229,39 @@ struct FOmniCaptureSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 1.0, UIMin = 5.0, ClampMax = 240.0))
     float PreviewFrameRate = 30.0f;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    bool bDeterministicCapture = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 1, UIMin = 1, ClampMax = 64, UIMax = 16))
+    int32 SubframeSamples = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.01, UIMin = 0.01, ClampMax = 1.0, UIMax = 1.0))
+    float SubframeShutter = 0.5f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     bool bRecordAudio = true;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     float AudioGain = 1.0f;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    TArray<float> AudioChannelGains;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    EOmniCaptureAudioFormat AudioSampleFormat = EOmniCaptureAudioFormat::PCM16;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    bool bAudioDither = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    EOmniCaptureAmbisonicOrder AmbisonicOrder = EOmniCaptureAmbisonicOrder::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    EOmniCaptureAudioCodec AudioCodec = EOmniCaptureAudioCodec::WAV;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 32, UIMin = 64))
+    int32 AudioBitrateKbps = 192;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     TSoftObjectPtr<class USoundSubmix> SubmixToRecord;
 
@@ -182,9 +304,24 @@ struct FOmniCaptureSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0.1, ClampMax = 1.0))
     float LowFrameRateWarningRatio = 0.85f;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics")
+    EOmniCaptureTelemetryFormat TelemetryStreamFormat = EOmniCaptureTelemetryFormat::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0.1, UIMin = 0.1))
+    float TelemetryIntervalSeconds = 1.0f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
     FString PreferredFFmpegPath;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
+    bool bLiveFFmpegMux = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 0, UIMin = 0))
+    int32 MuxCoreBudget = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 1, UIMin = 1))
+    int32 MuxThreadsPerJob = 4;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, ClampMax = 1.0))
     float SeamBlend = 0.25f;
 
@@ -209,6 +346,21 @@ struct FOmniCaptureSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC")
     EOmniCaptureRingBufferPolicy RingBufferPolicy = EOmniCaptureRingBufferPolicy::DropOldest;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC")
+    bool bFragmentedMP4 = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ClampMin = 0, UIMin = 0))
+    int32 MaxEncodeWidth = 8192;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Software Encoder")
+    FString SoftwareEncoderPreset = TEXT("superfast");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Software Encoder", meta = (ClampMin = 0, UIMin = 0))
+    int32 SoftwareEncoderThreads = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Software Encoder", meta = (ClampMin = 1, UIMin = 1, ClampMax = 16, UIMax = 16))
+    int32 SoftwareEncoderQueueDepth = 3;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
     bool bOpenPreviewOnFinalize = false;
 };
@@ -228,6 +380,29 @@ struct FOmniCaptureFrameMetadata
     bool bKeyFrame = false;
 };
 
+// Timing of one audio block for A/V sync bookkeeping. The samples themselves stay in the audio
+// ring and are drained by the file writer, so spans deliberately carry no pointers into it.
+struct FOmniAudioSpan
+{
+    double Timestamp = 0.0;
+    int32 SampleRate = 48000;
+    int32 NumChannels = 2;
+    EOmniCaptureAudioFormat Format = EOmniCaptureAudioFormat::PCM16;
+    int32 BytesPerSample = 2;
+    int32 NumSamples = 0;
+
+    int32 Num() const { return NumSamples; }
+};
+
+// Reusable encoder input handed out by GPU backends. The converter renders straight into the
+// planes; backends derive from it to keep their own per-slot state.
+struct FOmniCaptureEncoderSlot
+{
+    virtual ~FOmniCaptureEncoderSlot() = default;
+
+    TArray<TRefCountPtr<IPooledRenderTarget>> Planes;
+};
+
 struct FOmniCaptureFrame
 {
     FOmniCaptureFrameMetadata Metadata;
@@ -237,41 +412,235 @@ struct FOmniCaptureFrame
     FGPUFenceRHIRef ReadyFence;
     bool bLinearColor = false;
     bool bUsedCPUFallback = false;
-    TArray<struct FOmniAudioPacket> AudioPackets;
+    TArray<FOmniAudioSpan, TInlineAllocator<8>> AudioSpans;
     TArray<FTexture2DRHIRef> EncoderTextures;
+    TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> EncoderSlot;
 };
 
-USTRUCT()
-struct FOmniAudioPacket
+USTRUCT(BlueprintType)
+struct FOmniCaptureRingBufferStats
 {
     GENERATED_BODY()
 
-    UPROPERTY()
-    double Timestamp = 0.0;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 PendingFrames = 0;
 
-    UPROPERTY()
-    int32 SampleRate = 48000;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 DroppedFrames = 0;
 
-    UPROPERTY()
-    int32 NumChannels = 2;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 BlockedPushes = 0;
+};
 
-    UPROPERTY()
-    TArray<int16> PCM16;
+USTRUCT(BlueprintType)
+struct FOmniCaptureBitstreamStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 TotalBytes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 TotalPackets = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double BytesPerSecond = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double PacketsPerSecond = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 PeakQueuedBytes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 WriterStalls = 0;
 };
 
 USTRUCT(BlueprintType)
-struct FOmniCaptureRingBufferStats
+struct FOmniCaptureEncoderLatencyStats
 {
     GENERATED_BODY()
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 FramesEncoded = 0;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
     int32 PendingFrames = 0;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double LastLatencyMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double AverageLatencyMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double PeakLatencyMs = 0.0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureStageTiming
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    EOmniCaptureStage Stage = EOmniCaptureStage::Capture;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 Samples = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double LastMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double P50Ms = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double P95Ms = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double P99Ms = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double MaxMs = 0.0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureDropEvent
+{
+    GENERATED_BODY()
+
+    // Position in the capture's drop timeline, starting at zero.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 Sequence = 0;
+
+    // Frame counter when the drop was detected; ring evictions report the evicted frame.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 FrameIndex = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double CaptureSeconds = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    EOmniCaptureDropCause Cause = EOmniCaptureDropCause::MissingRig;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    EOmniCaptureBottleneck Bottleneck = EOmniCaptureBottleneck::Render;
+
+    // Stage blamed for the drop and its most recent latency when the drop was detected.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    EOmniCaptureStage Stage = EOmniCaptureStage::Capture;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double StageMs = 0.0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureTelemetry
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double CaptureSeconds = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    EOmniCaptureState State = EOmniCaptureState::Idle;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 FramesCaptured = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double CaptureFPS = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 SegmentIndex = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 RingPendingFrames = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 RingBlockedPushes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 EncoderPendingFrames = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 PNGPendingWrites = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 BytesWritten = 0;
+
+    // Frame metadata held in memory for the manifest's seek index.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int64 FrameMetadataBytes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double WriteBytesPerSecond = 0.0;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
     int32 DroppedFrames = 0;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
-    int32 BlockedPushes = 0;
+    int32 RingBufferDrops = 0;
+
+    // Indexed by EOmniCaptureDropCause.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    TArray<int32> DropsByCause;
+
+    // Indexed by EOmniCaptureBottleneck.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    TArray<int32> DropsByBottleneck;
+
+    // The latest drops, oldest first.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    TArray<FOmniCaptureDropEvent> RecentDrops;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double EncoderLatencyMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double AudioDriftMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    double MaxAudioDriftMs = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    int32 AudioPendingPackets = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    bool bAudioInError = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
+    TArray<FOmniCaptureStageTiming> StageTimings;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureMuxJobStatus
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    int32 JobId = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    int32 SegmentIndex = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    EOmniCaptureMuxJobState State = EOmniCaptureMuxJobState::Queued;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    float Progress = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    double ElapsedSeconds = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    double EstimatedSecondsRemaining = -1.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    int32 ExitCode = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mux")
+    FString OutputFile;
 };
 
 USTRUCT(BlueprintType)
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+// Common surface for the video backends the subsystem can drive. Frames arrive on the ring
+// buffer consumer thread in capture order.
+class OMNICAPTURE_API IOmniVideoEncoder
+{
+public:
+    virtual ~IOmniVideoEncoder() = default;
+
+    virtual void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory) = 0;
+    virtual void EnqueueFrame(const FOmniCaptureFrame& Frame) = 0;
+    virtual void Finalize() = 0;
+
+    virtual bool IsInitialized() const = 0;
+    virtual FString GetOutputFilePath() const = 0;
+    virtual FOmniCaptureEncoderLatencyStats GetLatencyStats() const = 0;
+    virtual FOmniCaptureBitstreamStats GetBitstreamStats() const { return FOmniCaptureBitstreamStats(); }
+
+    // True while the backend cannot keep up; the ring buffer treats this as backpressure.
+    virtual bool IsStalled() const { return false; }
+
+    // Only GPU backends hand out persistent conversion targets.
+    virtual TSharedPtr<FOmniCaptureEncoderSlot, ESPMode::ThreadSafe> AcquireInputSlot() { return nullptr; }
+
+    // GPU backends read Frame.EncoderTextures; CPU backends read Frame.PixelData.
+    virtual bool UsesGPUFrames() const { return false; }
+
+    // Restricts the encoder to a column of the equirect. Set before Initialize; frames passed
+    // in are already cropped to it.
+    void SetEncodeRegion(const FIntRect& InRegion) { EncodeRegion = InRegion; }
+
+    static FIntPoint GetEquirectSize(const FOmniCaptureSettings& Settings);
+
+    // MaxEncodeWidth clamped to what the backend accepts (NVENC H.264 stops at 4096); zero
+    // disables tiling.
+    static int32 GetMaxEncodeWidth(const FOmniCaptureSettings& Settings);
+
+    // Extra QP for an equirect row, growing with the 1/cos(latitude) horizontal oversampling so
+    // every doubling of samples per solid angle costs ~6 QP. Zero across the horizon band.
+    static int32 GetLatitudeQPOffset(const FOmniCaptureSettings& Settings, int32 Row);
+    static TUniquePtr<IOmniVideoEncoder> Create(const FOmniCaptureSettings& Settings);
+    static TUniquePtr<IOmniVideoEncoder> CreateBackend(EOmniOutputFormat Format);
+
+protected:
+    FIntPoint GetEncodeSize(const FOmniCaptureSettings& Settings) const;
+    static void RecordLatency(FOmniCaptureEncoderLatencyStats& Stats, double LatencySeconds);
+
+    FIntRect EncodeRegion;
+};
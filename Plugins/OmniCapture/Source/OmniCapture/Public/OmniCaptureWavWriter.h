@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Atomic.h"
+
+class FArchive;
+class FEvent;
+class FRunnableThread;
+class FOmniCaptureAudioRing;
+
+class OMNICAPTURE_API FOmniCaptureWavWriter
+{
+public:
+    FOmniCaptureWavWriter();
+    ~FOmniCaptureWavWriter();
+
+    bool Open(const FString& InFilePath, FOmniCaptureAudioRing& InRing, EOmniCaptureAudioFormat InFormat);
+    // Ambisonic channels are not speakers, so they are written without a speaker mask.
+    bool Close(int32 SampleRate, int32 NumChannels, bool bAmbisonic);
+
+    bool IsOpen() const { return Archive.IsValid(); }
+    void Wake();
+    void Drain();
+
+    const FString& GetFilePath() const { return FilePath; }
+    uint64 GetBytesWritten() const { return DataBytes.Load(); }
+
+private:
+    void WriteHeader(int32 SampleRate, int32 NumChannels, bool bAmbisonic, bool bRF64);
+    void StopWorker();
+
+private:
+    TUniquePtr<FArchive> Archive;
+    FOmniCaptureAudioRing* Ring = nullptr;
+    FString FilePath;
+    EOmniCaptureAudioFormat Format = EOmniCaptureAudioFormat::PCM16;
+    int32 BytesPerSample = 2;
+
+    FCriticalSection WriteCS;
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    class FOmniCaptureWavWorker* Worker = nullptr;
+    TAtomic<bool> bRunning;
+    TAtomic<uint64> DataBytes;
+};
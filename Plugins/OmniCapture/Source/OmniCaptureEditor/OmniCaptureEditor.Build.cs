@@ -21,6 +21,7 @@ public class OmniCaptureEditor : ModuleRules
         {
             "InputCore",
             "EditorStyle",
+            "Json",
             "LevelEditor",
             "Projects",
             "PropertyEditor",
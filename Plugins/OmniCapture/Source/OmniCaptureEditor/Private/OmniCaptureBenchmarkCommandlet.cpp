@@ -0,0 +1,504 @@
+#include "OmniCaptureBenchmarkCommandlet.h"
+
+#include "OmniCaptureEquirectConverter.h"
+#include "OmniCapturePNGWriter.h"
+#include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureStageTimings.h"
+#include "OmniCaptureVideoEncoder.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProperties.h"
+#include "Math/RandomStream.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureBenchmark, Log, All);
+
+namespace
+{
+    struct FBenchmarkSweep
+    {
+        TArray<EOmniCaptureMode> Modes;
+        TArray<EOmniCaptureStereoLayout> Layouts;
+        TArray<EOmniCaptureGamma> Gammas;
+        TArray<EOmniOutputFormat> Formats;
+        TArray<int32> RingCapacities;
+        TArray<EOmniCaptureRingBufferPolicy> RingPolicies;
+    };
+
+    struct FBenchmarkRun
+    {
+        FString Name;
+        FOmniCaptureSettings Settings;
+        bool bSkipped = false;
+        FString SkipReason;
+        int32 FramesSubmitted = 0;
+        int32 FramesConverted = 0;
+        int32 FramesWritten = 0;
+        double WallSeconds = 0.0;
+        int64 BytesWritten = 0;
+        uint64 MemoryHighWaterBytes = 0;
+        FOmniCaptureRingBufferStats RingStats;
+        TArray<FOmniCaptureStageTiming> StageTimings;
+    };
+
+    template <typename EnumType>
+    FString GetEnumName(EnumType Value)
+    {
+        return StaticEnum<EnumType>()->GetNameStringByValue(static_cast<int64>(Value));
+    }
+
+    TArray<FString> ParseList(const FString& Params, const TCHAR* Key)
+    {
+        TArray<FString> Tokens;
+        FString Value;
+        if (FParse::Value(*Params, Key, Value, false))
+        {
+            Value.ParseIntoArray(Tokens, TEXT(","), true);
+            for (FString& Token : Tokens)
+            {
+                Token.TrimStartAndEndInline();
+            }
+        }
+        return Tokens;
+    }
+
+    template <typename EnumType>
+    TArray<EnumType> ParseEnumList(const FString& Params, const TCHAR* Key, const TArray<EnumType>& Defaults)
+    {
+        TArray<EnumType> Result;
+        for (const FString& Token : ParseList(Params, Key))
+        {
+            const int64 Value = StaticEnum<EnumType>()->GetValueByNameString(Token);
+            if (Value == INDEX_NONE)
+            {
+                UE_LOG(LogOmniCaptureBenchmark, Warning, TEXT("Ignoring unknown value '%s' for %s"), *Token, Key);
+                continue;
+            }
+            Result.AddUnique(static_cast<EnumType>(Value));
+        }
+        return Result.Num() > 0 ? Result : Defaults;
+    }
+
+    TArray<int32> ParseIntList(const FString& Params, const TCHAR* Key, const TArray<int32>& Defaults)
+    {
+        TArray<int32> Result;
+        for (const FString& Token : ParseList(Params, Key))
+        {
+            if (Token.IsNumeric())
+            {
+                Result.AddUnique(FCString::Atoi(*Token));
+            }
+        }
+        return Result.Num() > 0 ? Result : Defaults;
+    }
+
+    // Per-face gradient plus fine noise, so the projection and the encoders see texture rather
+    // than flat colour. Seeded, so every run of the suite converts the same pixels.
+    void BuildSyntheticCubemap(int32 Resolution, int32 EyeIndex, FOmniCaptureCPUCubemap& OutCubemap)
+    {
+        FRandomStream Random(1337 + EyeIndex);
+        for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+        {
+            FOmniCaptureCPUFace& Face = OutCubemap.Faces[FaceIndex];
+            Face.Resolution = Resolution;
+            Face.Pixels.SetNumUninitialized(Resolution * Resolution);
+
+            const FLinearColor Tint = FLinearColor::MakeFromHSV8(static_cast<uint8>(FaceIndex * 42 + EyeIndex * 12), 160, 255);
+            for (int32 Y = 0; Y < Resolution; ++Y)
+            {
+                const float V = (Y + 0.5f) / Resolution;
+                for (int32 X = 0; X < Resolution; ++X)
+                {
+                    const float U = (X + 0.5f) / Resolution;
+                    const float Noise = Random.FRand() * 0.08f;
+                    Face.Pixels[Y * Resolution + X] = FFloat16Color(FLinearColor(Tint.R * U + Noise, Tint.G * V + Noise, Tint.B * (1.0f - U * V) + Noise, 1.0f));
+                }
+            }
+        }
+    }
+
+    // A bar sweeping across the first face gives the encoders real motion on every frame. The
+    // previous frame's bar is restored from the base first, so each frame shows exactly one.
+    void AnimateCubemap(FOmniCaptureCPUCubemap& Cubemap, const FOmniCaptureCPUCubemap& Base, int32 FrameIndex)
+    {
+        FOmniCaptureCPUFace& Face = Cubemap.Faces[0];
+        const FOmniCaptureCPUFace& BaseFace = Base.Faces[0];
+        const int32 BarWidth = FMath::Max(4, Face.Resolution / 32);
+        auto GetBarStart = [&Face, BarWidth](int32 Index)
+        {
+            return (Index * BarWidth / 2) % Face.Resolution;
+        };
+
+        if (FrameIndex > 0 && BaseFace.Pixels.Num() == Face.Pixels.Num())
+        {
+            const int32 PreviousStart = GetBarStart(FrameIndex - 1);
+            const int32 PreviousWidth = FMath::Min(PreviousStart + BarWidth, Face.Resolution) - PreviousStart;
+            for (int32 Y = 0; Y < Face.Resolution; ++Y)
+            {
+                const int32 RowStart = Y * Face.Resolution + PreviousStart;
+                FMemory::Memcpy(&Face.Pixels[RowStart], &BaseFace.Pixels[RowStart], PreviousWidth * sizeof(FFloat16Color));
+            }
+        }
+
+        const int32 BarStart = GetBarStart(FrameIndex);
+        const FFloat16Color BarColor(FLinearColor(1.0f, 1.0f, 1.0f, 1.0f) * (0.25f + 0.75f * (FrameIndex % 8) / 7.0f));
+        for (int32 Y = 0; Y < Face.Resolution; ++Y)
+        {
+            for (int32 X = BarStart; X < FMath::Min(BarStart + BarWidth, Face.Resolution); ++X)
+            {
+                Face.Pixels[Y * Face.Resolution + X] = BarColor;
+            }
+        }
+    }
+
+    // Every combination of the sweep at one resolution; mono runs ignore the stereo layout axis.
+    TArray<FOmniCaptureSettings> BuildConfigurations(const FBenchmarkSweep& Sweep, int32 Resolution)
+    {
+        TArray<FOmniCaptureSettings> Configurations;
+        for (const EOmniCaptureMode Mode : Sweep.Modes)
+        {
+            const TArray<EOmniCaptureStereoLayout> Layouts = Mode == EOmniCaptureMode::Stereo ? Sweep.Layouts : TArray<EOmniCaptureStereoLayout>({ EOmniCaptureStereoLayout::TopBottom });
+            for (const EOmniCaptureStereoLayout Layout : Layouts)
+            {
+                for (const EOmniCaptureGamma Gamma : Sweep.Gammas)
+                {
+                    for (const EOmniOutputFormat Format : Sweep.Formats)
+                    {
+                        for (const int32 RingCapacity : Sweep.RingCapacities)
+                        {
+                            for (const EOmniCaptureRingBufferPolicy RingPolicy : Sweep.RingPolicies)
+                            {
+                                FOmniCaptureSettings& Settings = Configurations.AddDefaulted_GetRef();
+                                Settings.Resolution = Resolution;
+                                Settings.Mode = Mode;
+                                Settings.StereoLayout = Layout;
+                                Settings.Gamma = Gamma;
+                                Settings.OutputFormat = Format;
+                                Settings.RingBufferCapacity = RingCapacity;
+                                Settings.RingBufferPolicy = RingPolicy;
+                                Settings.bLiveFFmpegMux = false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return Configurations;
+    }
+
+    FString BuildRunName(const FOmniCaptureSettings& Settings)
+    {
+        FString Name = FString::Printf(TEXT("%d_%s"), Settings.Resolution, *GetEnumName(Settings.Mode));
+        if (Settings.Mode == EOmniCaptureMode::Stereo)
+        {
+            Name += TEXT("_") + GetEnumName(Settings.StereoLayout);
+        }
+        Name += FString::Printf(TEXT("_%s_%s_Ring%d%s"),
+            *GetEnumName(Settings.Gamma),
+            *GetEnumName(Settings.OutputFormat),
+            Settings.RingBufferCapacity,
+            *GetEnumName(Settings.RingBufferPolicy));
+        return Name;
+    }
+
+    void ExecuteRun(FBenchmarkRun& Run, int32 NumFrames, const FOmniCaptureCPUCubemap& LeftBase, const FOmniCaptureCPUCubemap& RightBase)
+    {
+        const FOmniCaptureSettings& Settings = Run.Settings;
+        const bool bPNG = Settings.OutputFormat == EOmniOutputFormat::PNGSequence;
+
+        TUniquePtr<FOmniCapturePNGWriter> PNGWriter;
+        TUniquePtr<IOmniVideoEncoder> Encoder;
+        if (bPNG)
+        {
+            PNGWriter = MakeUnique<FOmniCapturePNGWriter>();
+            PNGWriter->Initialize(Settings, Settings.OutputDirectory);
+        }
+        else
+        {
+            Encoder = IOmniVideoEncoder::Create(Settings);
+            if (!Encoder)
+            {
+                Run.bSkipped = true;
+                Run.SkipReason = FString::Printf(TEXT("No %s backend on this platform"), *GetEnumName(Settings.OutputFormat));
+                return;
+            }
+
+            Encoder->Initialize(Settings, Settings.OutputDirectory);
+            if (!Encoder->IsInitialized())
+            {
+                Run.bSkipped = true;
+                Run.SkipReason = TEXT("Encoder failed to initialize (is FFmpeg available?)");
+                return;
+            }
+        }
+
+        // Fresh copies per run, so every configuration starts from the same faces.
+        FOmniCaptureCPUCubemap LeftCubemap = LeftBase;
+        FOmniCaptureCPUCubemap RightCubemap = RightBase;
+
+        FOmniCaptureStageTimings::Get().Reset();
+
+        TUniquePtr<FOmniCaptureRingBuffer> RingBuffer = MakeUnique<FOmniCaptureRingBuffer>();
+        RingBuffer->Initialize(Settings, [&PNGWriter, &Encoder, &Settings](TUniquePtr<FOmniCaptureFrame>&& Frame)
+        {
+            OMNICAPTURE_STAGE_SCOPE(RingConsumer);
+            if (PNGWriter)
+            {
+                const FString FrameFileName = FString::Printf(TEXT("%s_%06d.png"), *Settings.OutputFileName, Frame->Metadata.FrameIndex);
+                PNGWriter->EnqueueFrame(MoveTemp(Frame), FrameFileName);
+            }
+            else if (Encoder)
+            {
+                Encoder->EnqueueFrame(*Frame);
+            }
+        });
+        if (Encoder)
+        {
+            RingBuffer->SetBackpressureProbe([&Encoder]()
+            {
+                return Encoder->IsStalled();
+            });
+        }
+
+        uint64 MemoryHighWater = FPlatformMemory::GetStats().UsedPhysical;
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+        {
+            AnimateCubemap(LeftCubemap, LeftBase, FrameIndex);
+            if (Settings.Mode == EOmniCaptureMode::Stereo)
+            {
+                AnimateCubemap(RightCubemap, RightBase, FrameIndex);
+            }
+
+            FOmniCaptureEquirectResult Result;
+            {
+                OMNICAPTURE_STAGE_SCOPE(Convert);
+                Result = FOmniCaptureEquirectConverter::ConvertCPUCubemaps(Settings, LeftCubemap, RightCubemap);
+            }
+            ++Run.FramesSubmitted;
+            if (!Result.PixelData.IsValid())
+            {
+                continue;
+            }
+            ++Run.FramesConverted;
+
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = FrameIndex;
+            Frame->Metadata.Timecode = static_cast<double>(FrameIndex) / FMath::Max(1.0f, Settings.TargetFrameRate);
+            Frame->Metadata.bKeyFrame = (FrameIndex % FMath::Max(1, Settings.Quality.GOPLength)) == 0;
+            Frame->PixelData = MoveTemp(Result.PixelData);
+            Frame->bLinearColor = Result.bIsLinear;
+            Frame->bUsedCPUFallback = true;
+            RingBuffer->Enqueue(MoveTemp(Frame));
+
+            MemoryHighWater = FMath::Max(MemoryHighWater, FPlatformMemory::GetStats().UsedPhysical);
+        }
+
+        // Timing covers the full drain: the ring, then the write queue or the encoder's tail.
+        RingBuffer->Flush();
+        Run.RingStats = RingBuffer->GetStats();
+        RingBuffer.Reset();
+        if (PNGWriter)
+        {
+            PNGWriter->Flush();
+            Run.BytesWritten = PNGWriter->GetBytesWritten();
+            Run.FramesWritten = PNGWriter->GetFramesWritten();
+        }
+        if (Encoder)
+        {
+            Encoder->Finalize();
+            Run.BytesWritten = Encoder->GetBitstreamStats().TotalBytes;
+            Run.FramesWritten = static_cast<int32>(Encoder->GetLatencyStats().FramesEncoded);
+            if (Run.BytesWritten == 0)
+            {
+                Run.BytesWritten = FMath::Max<int64>(IFileManager::Get().FileSize(*Encoder->GetOutputFilePath()), 0);
+            }
+        }
+        Run.WallSeconds = FPlatformTime::Seconds() - StartTime;
+        Run.MemoryHighWaterBytes = FMath::Max(MemoryHighWater, FPlatformMemory::GetStats().UsedPhysical);
+        Run.StageTimings = FOmniCaptureStageTimings::Get().GetSnapshot();
+    }
+
+    TSharedRef<FJsonObject> BuildRunObject(const FBenchmarkRun& Run)
+    {
+        const FOmniCaptureSettings& Settings = Run.Settings;
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetStringField(TEXT("name"), Run.Name);
+        Object->SetNumberField(TEXT("resolution"), Settings.Resolution);
+        Object->SetStringField(TEXT("mode"), GetEnumName(Settings.Mode));
+        Object->SetStringField(TEXT("layout"), Settings.Mode == EOmniCaptureMode::Stereo ? GetEnumName(Settings.StereoLayout) : FString());
+        Object->SetStringField(TEXT("gamma"), GetEnumName(Settings.Gamma));
+        Object->SetStringField(TEXT("outputFormat"), GetEnumName(Settings.OutputFormat));
+        Object->SetNumberField(TEXT("ringCapacity"), Settings.RingBufferCapacity);
+        Object->SetStringField(TEXT("ringPolicy"), GetEnumName(Settings.RingBufferPolicy));
+
+        if (Run.bSkipped)
+        {
+            Object->SetBoolField(TEXT("skipped"), true);
+            Object->SetStringField(TEXT("reason"), Run.SkipReason);
+            return Object;
+        }
+
+        const FIntPoint OutputSize = IOmniVideoEncoder::GetEquirectSize(Settings);
+        Object->SetNumberField(TEXT("outputWidth"), OutputSize.X);
+        Object->SetNumberField(TEXT("outputHeight"), OutputSize.Y);
+        Object->SetNumberField(TEXT("framesSubmitted"), Run.FramesSubmitted);
+        Object->SetNumberField(TEXT("framesConverted"), Run.FramesConverted);
+        Object->SetNumberField(TEXT("framesWritten"), Run.FramesWritten);
+        Object->SetNumberField(TEXT("wallSeconds"), Run.WallSeconds);
+        Object->SetNumberField(TEXT("fps"), Run.WallSeconds > 0.0 ? Run.FramesWritten / Run.WallSeconds : 0.0);
+        Object->SetNumberField(TEXT("bytesWritten"), static_cast<double>(Run.BytesWritten));
+        Object->SetNumberField(TEXT("bytesPerFrame"), Run.FramesWritten > 0 ? static_cast<double>(Run.BytesWritten) / Run.FramesWritten : 0.0);
+        Object->SetNumberField(TEXT("memoryHighWaterMB"), Run.MemoryHighWaterBytes / (1024.0 * 1024.0));
+        Object->SetNumberField(TEXT("ringDropped"), Run.RingStats.DroppedFrames);
+        Object->SetNumberField(TEXT("ringBlocked"), Run.RingStats.BlockedPushes);
+
+        TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+        for (const FOmniCaptureStageTiming& Timing : Run.StageTimings)
+        {
+            TSharedRef<FJsonObject> Stage = MakeShared<FJsonObject>();
+            Stage->SetNumberField(TEXT("samples"), static_cast<double>(Timing.Samples));
+            Stage->SetNumberField(TEXT("p50"), Timing.P50Ms);
+            Stage->SetNumberField(TEXT("p95"), Timing.P95Ms);
+            Stage->SetNumberField(TEXT("p99"), Timing.P99Ms);
+            Stage->SetNumberField(TEXT("max"), Timing.MaxMs);
+            Stages->SetObjectField(GetEnumName(Timing.Stage), Stage);
+        }
+        Object->SetObjectField(TEXT("stages"), Stages);
+        return Object;
+    }
+}
+
+UOmniCaptureBenchmarkCommandlet::UOmniCaptureBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UOmniCaptureBenchmarkCommandlet::Main(const FString& Params)
+{
+    int32 NumFrames = 120;
+    FParse::Value(*Params, TEXT("Frames="), NumFrames);
+    NumFrames = FMath::Max(1, NumFrames);
+
+    const TArray<int32> Resolutions = ParseIntList(Params, TEXT("Resolutions="), { 512, 1024 });
+    FBenchmarkSweep Sweep;
+    Sweep.Modes = ParseEnumList<EOmniCaptureMode>(Params, TEXT("Modes="), { EOmniCaptureMode::Mono, EOmniCaptureMode::Stereo });
+    Sweep.Layouts = ParseEnumList<EOmniCaptureStereoLayout>(Params, TEXT("Layouts="), { EOmniCaptureStereoLayout::TopBottom, EOmniCaptureStereoLayout::SideBySide });
+    Sweep.Gammas = ParseEnumList<EOmniCaptureGamma>(Params, TEXT("Gammas="), { EOmniCaptureGamma::SRGB, EOmniCaptureGamma::Linear });
+    Sweep.Formats = ParseEnumList<EOmniOutputFormat>(Params, TEXT("Formats="), { EOmniOutputFormat::PNGSequence, EOmniOutputFormat::SoftwareEncoder });
+    Sweep.RingCapacities = ParseIntList(Params, TEXT("RingCapacities="), { 6 });
+    Sweep.RingPolicies = ParseEnumList<EOmniCaptureRingBufferPolicy>(Params, TEXT("RingPolicies="), { EOmniCaptureRingBufferPolicy::DropOldest });
+    const bool bKeepOutput = FParse::Param(*Params, TEXT("KeepOutput"));
+
+    const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+    const FString WorkDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("OmniCaptures") / TEXT("Benchmark") / Timestamp);
+    FString ReportPath;
+    if (!FParse::Value(*Params, TEXT("Report="), ReportPath))
+    {
+        ReportPath = WorkDirectory + TEXT(".json");
+    }
+
+    TArray<FBenchmarkRun> Runs;
+    for (const int32 Resolution : Resolutions)
+    {
+        if (Resolution <= 0)
+        {
+            continue;
+        }
+
+        // Synthetic faces are shared by every configuration at this resolution.
+        FOmniCaptureCPUCubemap LeftCubemap;
+        FOmniCaptureCPUCubemap RightCubemap;
+        BuildSyntheticCubemap(Resolution, 0, LeftCubemap);
+        if (Sweep.Modes.Contains(EOmniCaptureMode::Stereo))
+        {
+            BuildSyntheticCubemap(Resolution, 1, RightCubemap);
+        }
+
+        for (const FOmniCaptureSettings& Settings : BuildConfigurations(Sweep, Resolution))
+        {
+            FBenchmarkRun& Run = Runs.AddDefaulted_GetRef();
+            Run.Settings = Settings;
+            Run.Name = BuildRunName(Settings);
+            Run.Settings.OutputDirectory = WorkDirectory / Run.Name;
+            Run.Settings.OutputFileName = Run.Name;
+            IFileManager::Get().MakeDirectory(*Run.Settings.OutputDirectory, true);
+
+            if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+            {
+                // NVENC consumes GPU planes, which the headless CPU path never produces.
+                Run.bSkipped = true;
+                Run.SkipReason = TEXT("NVENC needs GPU conversion and is not covered by the headless suite");
+            }
+            else
+            {
+                UE_LOG(LogOmniCaptureBenchmark, Display, TEXT("Running %s (%d frames)"), *Run.Name, NumFrames);
+                ExecuteRun(Run, NumFrames, LeftCubemap, RightCubemap);
+            }
+
+            if (Run.bSkipped)
+            {
+                UE_LOG(LogOmniCaptureBenchmark, Warning, TEXT("Skipped %s: %s"), *Run.Name, *Run.SkipReason);
+            }
+            else
+            {
+                UE_LOG(LogOmniCaptureBenchmark, Display, TEXT("%s: %.2f fps, %.0f bytes/frame, dropped %d"),
+                    *Run.Name,
+                    Run.WallSeconds > 0.0 ? Run.FramesWritten / Run.WallSeconds : 0.0,
+                    Run.FramesWritten > 0 ? static_cast<double>(Run.BytesWritten) / Run.FramesWritten : 0.0,
+                    Run.RingStats.DroppedFrames);
+            }
+
+            if (!bKeepOutput)
+            {
+                IFileManager::Get().DeleteDirectory(*Run.Settings.OutputDirectory, false, true);
+            }
+        }
+    }
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("timestamp"), Timestamp);
+    Report->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Report->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+    Report->SetNumberField(TEXT("logicalCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    Report->SetBoolField(TEXT("nullRHI"), FParse::Param(FCommandLine::Get(), TEXT("nullrhi")));
+    Report->SetNumberField(TEXT("frames"), NumFrames);
+    Report->SetNumberField(TEXT("processPeakMB"), FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0));
+
+    TArray<TSharedPtr<FJsonValue>> RunValues;
+    for (const FBenchmarkRun& Run : Runs)
+    {
+        RunValues.Add(MakeShared<FJsonValueObject>(BuildRunObject(Run)));
+    }
+    Report->SetArrayField(TEXT("runs"), RunValues);
+
+    FString OutputString;
+    TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+    FJsonSerializer::Serialize(Report, Writer);
+    if (!FFileHelper::SaveStringToFile(OutputString, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        UE_LOG(LogOmniCaptureBenchmark, Error, TEXT("Failed to write benchmark report %s"), *ReportPath);
+        return 1;
+    }
+
+    if (!bKeepOutput)
+    {
+        IFileManager::Get().DeleteDirectory(*WorkDirectory, false, true);
+    }
+
+    UE_LOG(LogOmniCaptureBenchmark, Display, TEXT("Benchmark report written to %s (%d runs)"), *ReportPath, Runs.Num());
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
 #include "OmniCaptureEditorSettings.h"
+#include "OmniCaptureStageTimings.h"
 #include "OmniCaptureSubsystem.h"
 #include "PropertyEditorModule.h"
 #include "Styling/CoreStyle.h"
@@ -120,6 +121,15 @@ void SOmniCaptureControlPanel::Construct(const FArguments& InArgs)
                     .OnClicked(this, &SOmniCaptureControlPanel::OnOpenLastOutput)
                     .IsEnabled(this, &SOmniCaptureControlPanel::CanOpenLastOutput)
                 ]
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(8.f, 0.f, 0.f, 0.f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("CancelMuxing", "Cancel Muxing"))
+                    .OnClicked(this, &SOmniCaptureControlPanel::OnCancelMuxing)
+                    .IsEnabled(this, &SOmniCaptureControlPanel::CanCancelMuxing)
+                ]
             ]
             + SVerticalBox::Slot()
             .AutoHeight()
@@ -180,6 +190,13 @@ void SOmniCaptureControlPanel::Construct(const FArguments& InArgs)
             ]
             + SVerticalBox::Slot()
             .AutoHeight()
+            [
+                SAssignNew(StageTimingTextBlock, STextBlock)
+                .Text(LOCTEXT("StageTimings", "Stages p50/p95/p99 ms: -"))
+                .AutoWrapText(true)
+            ]
+            + SVerticalBox::Slot()
+            .AutoHeight()
             .Padding(0.f, 8.f)
             [
                 SNew(SSeparator)
@@ -296,6 +313,16 @@ FReply SOmniCaptureControlPanel::OnOpenLastOutput()
     return FReply::Handled();
 }
 
+FReply SOmniCaptureControlPanel::OnCancelMuxing()
+{
+    if (UOmniCaptureSubsystem* Subsystem = GetSubsystem())
+    {
+        Subsystem->CancelMuxJobs();
+    }
+
+    return FReply::Handled();
+}
+
 FReply SOmniCaptureControlPanel::OnBrowseOutputDirectory()
 {
     if (!SettingsObject.IsValid())
@@ -403,6 +430,15 @@ bool SOmniCaptureControlPanel::CanOpenLastOutput() const
     return false;
 }
 
+bool SOmniCaptureControlPanel::CanCancelMuxing() const
+{
+    if (const UOmniCaptureSubsystem* Subsystem = GetSubsystem())
+    {
+        return Subsystem->HasPendingMuxJobs();
+    }
+    return false;
+}
+
 FText SOmniCaptureControlPanel::GetPauseButtonText() const
 {
     if (const UOmniCaptureSubsystem* Subsystem = GetSubsystem())
@@ -457,14 +493,39 @@ void SOmniCaptureControlPanel::RefreshStatus()
         }
         RingBufferTextBlock->SetText(FText::GetEmpty());
         AudioTextBlock->SetText(FText::GetEmpty());
+        StageTimingTextBlock->SetText(FText::GetEmpty());
         UpdateOutputDirectoryDisplay();
         RebuildWarningList(TArray<FString>());
         return;
     }
 
-    StatusTextBlock->SetText(FText::FromString(Subsystem->GetStatusString()));
-
     const bool bCapturing = Subsystem->IsCapturing();
+    const FOmniCaptureTelemetry Telemetry = Subsystem->GetTelemetry();
+
+    if (bCapturing && Telemetry.RecentDrops.Num() > 0)
+    {
+        const FOmniCaptureDropEvent& LastDrop = Telemetry.RecentDrops.Last();
+        StatusTextBlock->SetText(FText::Format(LOCTEXT("StatusDropFormat", "Status: {0} | Frames {1} | Dropped {2} (last: {3}, {4} bound) | Written {5}"),
+            UEnum::GetDisplayValueAsText(Telemetry.State),
+            FText::AsNumber(Telemetry.FramesCaptured),
+            FText::AsNumber(Telemetry.DroppedFrames),
+            UEnum::GetDisplayValueAsText(LastDrop.Cause),
+            UEnum::GetDisplayValueAsText(LastDrop.Bottleneck),
+            FText::AsMemory(static_cast<uint64>(Telemetry.BytesWritten))));
+    }
+    else if (bCapturing)
+    {
+        StatusTextBlock->SetText(FText::Format(LOCTEXT("StatusFormat", "Status: {0} | Frames {1} | Dropped {2} | Written {3}"),
+            UEnum::GetDisplayValueAsText(Telemetry.State),
+            FText::AsNumber(Telemetry.FramesCaptured),
+            FText::AsNumber(Telemetry.DroppedFrames),
+            FText::AsMemory(static_cast<uint64>(Telemetry.BytesWritten))));
+    }
+    else
+    {
+        // Idle status still carries mux job progress and the last still path.
+        StatusTextBlock->SetText(FText::FromString(Subsystem->GetStatusString()));
+    }
     const FOmniCaptureSettings& Settings = bCapturing ? Subsystem->GetActiveSettings() : (SettingsObject.IsValid() ? SettingsObject->CaptureSettings : FOmniCaptureSettings());
 
     const FText ConfigText = FText::Format(LOCTEXT("ConfigFormat", "Codec: {0} | Format: {1} | Zero Copy: {2}"),
@@ -483,7 +544,7 @@ void SOmniCaptureControlPanel::RefreshStatus()
 
     if (FrameRateTextBlock.IsValid())
     {
-        const double CurrentFps = Subsystem->GetCurrentFrameRate();
+        const double CurrentFps = Telemetry.CaptureFPS;
         FNumberFormattingOptions FpsFormat;
         FpsFormat.SetMinimumFractionalDigits(2);
         FpsFormat.SetMaximumFractionalDigits(2);
@@ -492,22 +553,29 @@ void SOmniCaptureControlPanel::RefreshStatus()
         FrameRateTextBlock->SetColorAndOpacity(Subsystem->IsPaused() ? FSlateColor(FLinearColor::Gray) : FSlateColor::UseForeground());
     }
 
-    const FOmniCaptureRingBufferStats RingStats = Subsystem->GetRingBufferStats();
     const FText RingText = FText::Format(LOCTEXT("RingStatsFormat", "Ring Buffer: Pending {0} | Dropped {1} | Blocked {2}"),
-        FText::AsNumber(RingStats.PendingFrames),
-        FText::AsNumber(RingStats.DroppedFrames),
-        FText::AsNumber(RingStats.BlockedPushes));
+        FText::AsNumber(Telemetry.RingPendingFrames),
+        FText::AsNumber(Telemetry.RingBufferDrops),
+        FText::AsNumber(Telemetry.RingBlockedPushes));
     RingBufferTextBlock->SetText(RingText);
 
-    const FOmniAudioSyncStats AudioStats = Subsystem->GetAudioSyncStats();
-    const FString DriftString = FString::Printf(TEXT("%.2f"), AudioStats.DriftMilliseconds);
-    const FString MaxString = FString::Printf(TEXT("%.2f"), AudioStats.MaxObservedDriftMilliseconds);
+    const FString DriftString = FString::Printf(TEXT("%.2f"), Telemetry.AudioDriftMs);
+    const FString MaxString = FString::Printf(TEXT("%.2f"), Telemetry.MaxAudioDriftMs);
     const FText AudioText = FText::Format(LOCTEXT("AudioStatsFormat", "Audio Drift: {0} ms (Max {1} ms) Pending {2}"),
         FText::FromString(DriftString),
         FText::FromString(MaxString),
-        FText::AsNumber(AudioStats.PendingPackets));
+        FText::AsNumber(Telemetry.AudioPendingPackets));
     AudioTextBlock->SetText(AudioText);
-    AudioTextBlock->SetColorAndOpacity(AudioStats.bInError ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground());
+    AudioTextBlock->SetColorAndOpacity(Telemetry.bAudioInError ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground());
+
+    TArray<FString> StageEntries;
+    for (const FOmniCaptureStageTiming& Timing : Telemetry.StageTimings)
+    {
+        StageEntries.Add(FString::Printf(TEXT("%s %.2f/%.2f/%.2f"), FOmniCaptureStageTimings::GetStageName(Timing.Stage), Timing.P50Ms, Timing.P95Ms, Timing.P99Ms));
+    }
+    StageTimingTextBlock->SetText(StageEntries.Num() > 0
+        ? FText::Format(LOCTEXT("StageTimingsFormat", "Stages p50/p95/p99 ms: {0}"), FText::FromString(FString::Join(StageEntries, TEXT(" | "))))
+        : LOCTEXT("StageTimings", "Stages p50/p95/p99 ms: -"));
 
     UpdateOutputDirectoryDisplay();
     RebuildWarningList(Subsystem->GetActiveWarnings());
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "OmniCaptureBenchmarkCommandlet.generated.h"
+
+// Headless throughput benchmark over synthetic cubemaps. Every combination in the sweep runs the
+// CPU projection, the ring buffer and the PNG or software encoder output for a fixed number of
+// frames, and the results land in a JSON report. Needs no scene or GPU, so it runs under -nullrhi:
+//
+//   UnrealEditor-Cmd <Project> -run=OmniCaptureBenchmark -nullrhi -unattended
+//       [-Frames=120] [-Resolutions=512,1024] [-Modes=Mono,Stereo] [-Layouts=TopBottom,SideBySide]
+//       [-Gammas=SRGB,Linear] [-Formats=PNGSequence,SoftwareEncoder] [-RingCapacities=6]
+//       [-RingPolicies=DropOldest,BlockProducer] [-Report=<path.json>] [-KeepOutput]
+UCLASS()
+class OMNICAPTUREEDITOR_API UOmniCaptureBenchmarkCommandlet final : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UOmniCaptureBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
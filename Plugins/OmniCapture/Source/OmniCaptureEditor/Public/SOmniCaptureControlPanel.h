@@ -23,6 +23,7 @@ private:
     FReply OnCaptureStill();
     FReply OnTogglePause();
     FReply OnOpenLastOutput();
+    FReply OnCancelMuxing();
     FReply OnBrowseOutputDirectory();
     bool CanStartCapture() const;
     bool CanStopCapture() const;
@@ -30,6 +31,7 @@ private:
     bool CanPauseCapture() const;
     bool CanResumeCapture() const;
     bool CanOpenLastOutput() const;
+    bool CanCancelMuxing() const;
     FText GetPauseButtonText() const;
     bool IsPauseButtonEnabled() const;
 
@@ -48,6 +50,7 @@ private:
     TSharedPtr<STextBlock> ActiveConfigTextBlock;
     TSharedPtr<STextBlock> RingBufferTextBlock;
     TSharedPtr<STextBlock> AudioTextBlock;
+    TSharedPtr<STextBlock> StageTimingTextBlock;
     TSharedPtr<STextBlock> FrameRateTextBlock;
     TSharedPtr<STextBlock> LastStillTextBlock;
     TSharedPtr<STextBlock> OutputDirectoryTextBlock;